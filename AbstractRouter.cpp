@@ -0,0 +1,425 @@
+/*! \file AbstractRouter.cpp
+ *  \brief     Implementation of AbstractRouter.
+ *  \details
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 17:22:05 2026
+ */
+
+
+#include "AbstractRouter.hpp"
+
+
+deque<AbstractRouter::PendingPacket> AbstractRouter::s_Pending;
+
+bool AbstractRouter::s_Handling = false;
+
+
+AbstractInterface::AbstractInterface(AbstractRouter* p_Router, int p_Interface):m_Router(p_Router), m_Interface(p_Interface)
+{
+}
+
+bool AbstractInterface::forward(Packet p_Packet)
+{
+    return m_Router->receive(m_Interface, p_Packet);
+}
+
+void AbstractInterface::interfaceDown(void)
+{
+    m_Router->interfaceDown(m_Interface);
+}
+
+void AbstractInterface::interfaceUp(void)
+{
+    m_Router->interfaceUp(m_Interface);
+}
+
+
+AbstractRouter::AbstractRouter(sc_module_name p_ModuleName, int p_InterfaceCount, uint32_t p_BGPIdentifier):sc_module(p_ModuleName), m_InterfaceCount(p_InterfaceCount), m_BGPIdentifier(p_BGPIdentifier), m_InterfaceUp(p_InterfaceCount, false), m_LinkUp(p_InterfaceCount, false), m_Dampening(p_InterfaceCount), m_Established(p_InterfaceCount, false), m_PeerIdentifier(p_InterfaceCount, 0), m_AdjRibIn(p_InterfaceCount), m_UpdatesReceived(0), m_UpdatesSent(0), m_PacketsDropped(0), m_TreatAsWithdraws(p_InterfaceCount, 0), m_AttributeDiscards(p_InterfaceCount, 0), m_MemoryRouter(MemoryAccounting::getRouter())
+{
+    //allocate the same hierarchial ports and exports as the Router has
+    export_ReceivingInterface = new sc_export<Interface_If>*[m_InterfaceCount];
+    port_ForwardingInterface = new sc_port<Interface_If, 1, SC_ZERO_OR_MORE_BOUND>*[m_InterfaceCount];
+    m_Interfaces = new AbstractInterface*[m_InterfaceCount];
+
+    for (int i = 0; i < m_InterfaceCount; ++i)
+        {
+            m_Interfaces[i] = new AbstractInterface(this, i);
+            export_ReceivingInterface[i] = new sc_export<Interface_If>;
+            export_ReceivingInterface[i]->bind(*m_Interfaces[i]);
+            port_ForwardingInterface[i] = new sc_port<Interface_If, 1, SC_ZERO_OR_MORE_BOUND>;
+        }
+
+    SC_THREAD(openSessions);
+
+    SC_METHOD(reuseInterfaces);
+    sensitive << m_ReuseEvent;
+    dont_initialize();
+}
+
+AbstractRouter::~AbstractRouter()
+{
+    for (int i = 0; i < m_InterfaceCount; ++i)
+        {
+            delete export_ReceivingInterface[i];
+            delete port_ForwardingInterface[i];
+            delete m_Interfaces[i];
+        }
+
+    delete[] export_ReceivingInterface;
+    delete[] port_ForwardingInterface;
+    delete[] m_Interfaces;
+}
+
+
+void AbstractRouter::interfaceUp(int p_InterfaceId)
+{
+    double l_Now = sc_time_stamp().to_seconds();
+
+    if (m_LinkUp[p_InterfaceId])
+        return;
+    m_LinkUp[p_InterfaceId] = true;
+    if (m_Dampening[p_InterfaceId].isSuppressed(l_Now))
+        {
+            m_Dampening[p_InterfaceId].countSuppressed();
+            m_ReuseEvent.notify(sc_time(m_Dampening[p_InterfaceId].getTimeToReuse(l_Now), SC_SEC));
+            return;
+        }
+
+    m_InterfaceUp[p_InterfaceId] = true;
+    cout << name() << " interface " << p_InterfaceId << " set up." << endl;
+
+    //during the elaboration the ports are not usable yet
+    if (sc_is_running())
+        openSession(p_InterfaceId);
+}
+
+void AbstractRouter::interfaceDown(int p_InterfaceId)
+{
+    if (!m_LinkUp[p_InterfaceId])
+        return;
+    m_LinkUp[p_InterfaceId] = false;
+    m_Dampening[p_InterfaceId].flap(sc_time_stamp().to_seconds());
+
+    //a suppressed interface is already held down
+    if (!m_InterfaceUp[p_InterfaceId])
+        {
+            m_Dampening[p_InterfaceId].countSuppressed();
+            return;
+        }
+    m_InterfaceUp[p_InterfaceId] = false;
+    closeSession(p_InterfaceId);
+}
+
+void AbstractRouter::reuseInterfaces(void)
+{
+    double l_Now = sc_time_stamp().to_seconds();
+
+    for (int i = 0; i < m_InterfaceCount; ++i)
+        {
+            if (!m_LinkUp[i] || m_InterfaceUp[i])
+                continue;
+
+            //the event is notified again for the interfaces whose
+            //suppression a flap has extended
+            if (m_Dampening[i].isSuppressed(l_Now))
+                m_ReuseEvent.notify(sc_time(m_Dampening[i].getTimeToReuse(l_Now), SC_SEC));
+            else
+                {
+                    m_LinkUp[i] = false;
+                    interfaceUp(i);
+                }
+        }
+}
+
+void AbstractRouter::originate(uint32_t p_Prefix, int p_Length)
+{
+    MemoryScope l_Scope(m_MemoryRouter, MEMORY_RIB);
+    uint64_t l_Key = packPrefix(p_Prefix, p_Length);
+    AbstractRoute& l_Route = m_LocalRoutes[l_Key];
+
+    l_Route.m_Prefix = p_Prefix;
+    l_Route.m_Length = p_Length;
+    l_Route.m_Interface = LOCAL_ROUTE;
+    l_Route.m_PathLength = 0;
+    l_Route.m_PeerIdentifier = m_BGPIdentifier;
+    decide(l_Key, p_Prefix, p_Length);
+}
+
+bool AbstractRouter::withdraw(uint32_t p_Prefix, int p_Length)
+{
+    MemoryScope l_Scope(m_MemoryRouter, MEMORY_RIB);
+    uint64_t l_Key = packPrefix(p_Prefix, p_Length);
+
+    if (m_LocalRoutes.erase(l_Key) == 0)
+        return false;
+    decide(l_Key, p_Prefix, p_Length);
+    return true;
+}
+
+
+bool AbstractRouter::receive(int p_InterfaceId, const Packet& p_Packet)
+{
+    if (!m_InterfaceUp[p_InterfaceId])
+        return false;
+
+    PendingPacket l_Pending = {this, p_InterfaceId, p_Packet};
+    s_Pending.push_back(l_Pending);
+
+    //an outer call handles the packet
+    if (s_Handling)
+        return true;
+
+    s_Handling = true;
+    while (!s_Pending.empty())
+        {
+            l_Pending = s_Pending.front();
+            s_Pending.pop_front();
+
+            if (l_Pending.m_Packet.getProtocolType() == BGP_PROTOCOL)
+                {
+                    BGPMessage l_BGPMsg = l_Pending.m_Packet.getBGPPayload();
+
+                    //as the data plane does, mark the receiving interface
+                    l_BGPMsg.m_OutboundInterface = l_Pending.m_Interface;
+                    l_Pending.m_Router->handle(l_Pending.m_Interface, l_BGPMsg);
+                }
+            else
+                //no data plane
+                l_Pending.m_Router->m_PacketsDropped++;
+        }
+    s_Handling = false;
+    return true;
+}
+
+const AbstractRoute* AbstractRouter::getRoute(uint32_t p_Prefix, int p_Length) const
+{
+    unordered_map<uint64_t, AbstractRoute>::const_iterator l_Route = m_LocRib.find(packPrefix(p_Prefix, p_Length));
+
+    return l_Route == m_LocRib.end() ? NULL : &l_Route->second;
+}
+
+size_t AbstractRouter::getRouteCount(void) const
+{
+    return m_LocRib.size();
+}
+
+void AbstractRouter::printStatistics(void)
+{
+    uint64_t l_Flaps = 0;
+    uint64_t l_Suppressed = 0;
+    uint64_t l_TreatAsWithdraws = 0;
+    uint64_t l_AttributeDiscards = 0;
+
+    for (int i = 0; i < m_InterfaceCount; ++i)
+        {
+            l_Flaps += m_Dampening[i].getFlaps();
+            l_Suppressed += m_Dampening[i].getSuppressedTransitions();
+            l_TreatAsWithdraws += m_TreatAsWithdraws[i];
+            l_AttributeDiscards += m_AttributeDiscards[i];
+        }
+    cout << name() << " routes: " << m_LocRib.size() << ", updates received " << m_UpdatesReceived << ", updates sent " << m_UpdatesSent << ", packets dropped " << m_PacketsDropped << ", interface flaps " << l_Flaps << ", suppressed transitions " << l_Suppressed << ", treated as withdraw " << l_TreatAsWithdraws << ", attributes discarded " << l_AttributeDiscards << endl;
+}
+
+void AbstractRouter::openSessions(void)
+{
+    for (int i = 0; i < m_InterfaceCount; ++i)
+        openSession(i);
+}
+
+void AbstractRouter::end_of_simulation()
+{
+    printStatistics();
+}
+
+
+void AbstractRouter::handle(int p_InterfaceId, BGPMessage& p_BGPMsg)
+{
+    MemoryScope l_Scope(m_MemoryRouter, MEMORY_RIB);
+    //a peer echoing this router's own messages
+    if (p_BGPMsg.m_BGPIdentifier == m_BGPIdentifier)
+        return;
+
+    if (p_BGPMsg.m_Type == BGPMessageType::Open)
+        {
+            if (m_Established[p_InterfaceId] && m_PeerIdentifier[p_InterfaceId] != 0)
+                return;
+            m_PeerIdentifier[p_InterfaceId] = p_BGPMsg.m_BGPIdentifier;
+            openSession(p_InterfaceId);
+            return;
+        }
+
+    //only the messages of the session's peer are accepted
+    if (!m_Established[p_InterfaceId] || (m_PeerIdentifier[p_InterfaceId] != 0 && m_PeerIdentifier[p_InterfaceId] != p_BGPMsg.m_BGPIdentifier))
+        {
+            m_PacketsDropped++;
+            return;
+        }
+    m_PeerIdentifier[p_InterfaceId] = p_BGPMsg.m_BGPIdentifier;
+
+    if (p_BGPMsg.m_Type == BGPMessageType::Notification)
+        {
+            closeSession(p_InterfaceId);
+            return;
+        }
+    if (p_BGPMsg.m_Type != BGPMessageType::Update)
+        return;
+
+    m_UpdatesReceived++;
+    if (p_BGPMsg.m_PrefixLength < 0 || p_BGPMsg.m_PrefixLength > 32)
+        return;
+
+    //a malformed UPDATE costs its prefix, not the session
+    UpdateError l_Error = p_BGPMsg.checkAttributes();
+
+    if (l_Error == UPDATE_TREAT_AS_WITHDRAW)
+        {
+            p_BGPMsg.m_Withdraw = true;
+            m_TreatAsWithdraws[p_InterfaceId]++;
+        }
+    else if (l_Error == UPDATE_ATTRIBUTE_DISCARD)
+        m_AttributeDiscards[p_InterfaceId]++;
+
+    uint64_t l_Key = packPrefix(p_BGPMsg.m_Prefix, p_BGPMsg.m_PrefixLength);
+
+    if (p_BGPMsg.m_Withdraw)
+        {
+            if (m_AdjRibIn[p_InterfaceId].erase(l_Key) == 0)
+                return;
+        }
+    else
+        {
+            AbstractRoute& l_Route = m_AdjRibIn[p_InterfaceId][l_Key];
+
+            l_Route.m_Prefix = p_BGPMsg.m_Prefix;
+            l_Route.m_Length = p_BGPMsg.m_PrefixLength;
+            l_Route.m_Interface = p_InterfaceId;
+            l_Route.m_PathLength = p_BGPMsg.m_PathLength;
+            l_Route.m_PeerIdentifier = p_BGPMsg.m_BGPIdentifier;
+        }
+    decide(l_Key, p_BGPMsg.m_Prefix, p_BGPMsg.m_PrefixLength);
+}
+
+void AbstractRouter::decide(uint64_t p_Key, uint32_t p_Prefix, int p_Length)
+{
+    const AbstractRoute* l_Best = NULL;
+    unordered_map<uint64_t, AbstractRoute>::iterator l_Found = m_LocalRoutes.find(p_Key);
+
+    if (l_Found != m_LocalRoutes.end())
+        l_Best = &l_Found->second;
+
+    //a route originated here is preferred to the learned ones
+    for (int i = 0; i < m_InterfaceCount && (l_Best == NULL || l_Best->m_Interface != LOCAL_ROUTE); ++i)
+        {
+            if (!m_Established[i])
+                continue;
+            l_Found = m_AdjRibIn[i].find(p_Key);
+            if (l_Found == m_AdjRibIn[i].end() || l_Found->second.m_PathLength >= ABSTRACT_MAX_PATH_LENGTH)
+                continue;
+            if (l_Best == NULL || l_Found->second.m_PathLength < l_Best->m_PathLength || (l_Found->second.m_PathLength == l_Best->m_PathLength && l_Found->second.m_PeerIdentifier < l_Best->m_PeerIdentifier))
+                l_Best = &l_Found->second;
+        }
+
+    unordered_map<uint64_t, AbstractRoute>::iterator l_Current = m_LocRib.find(p_Key);
+    int l_OldInterface = l_Current == m_LocRib.end() ? NO_ROUTE : l_Current->second.m_Interface;
+
+    if (l_Best == NULL)
+        {
+            if (l_Current == m_LocRib.end())
+                return;
+            m_LocRib.erase(l_Current);
+            for (int i = 0; i < m_InterfaceCount; ++i)
+                if (m_Established[i] && i != l_OldInterface)
+                    sendWithdraw(i, p_Prefix, p_Length);
+            return;
+        }
+
+    if (l_Current != m_LocRib.end() && l_Current->second.m_Interface == l_Best->m_Interface && l_Current->second.m_PathLength == l_Best->m_PathLength && l_Current->second.m_PeerIdentifier == l_Best->m_PeerIdentifier)
+        return;
+
+    AbstractRoute& l_Route = m_LocRib[p_Key];
+
+    l_Route = *l_Best;
+    for (int i = 0; i < m_InterfaceCount; ++i)
+        {
+            if (!m_Established[i])
+                continue;
+            if (i != l_Route.m_Interface)
+                advertise(i, l_Route);
+            //the peer the route is now learned from had the old route
+            else if (l_OldInterface != NO_ROUTE && l_OldInterface != i)
+                sendWithdraw(i, p_Prefix, p_Length);
+        }
+}
+
+void AbstractRouter::openSession(int p_InterfaceId)
+{
+    BGPMessage l_Open;
+
+    if (!m_InterfaceUp[p_InterfaceId] || m_Established[p_InterfaceId])
+        return;
+
+    m_Established[p_InterfaceId] = true;
+    l_Open.setType(BGPMessageType::Open);
+    l_Open.m_BGPIdentifier = m_BGPIdentifier;
+    l_Open.m_OutboundInterface = p_InterfaceId;
+    send(p_InterfaceId, l_Open);
+
+    //give the new peer the current routes
+    for (unordered_map<uint64_t, AbstractRoute>::iterator l_Route = m_LocRib.begin(); l_Route != m_LocRib.end(); ++l_Route)
+        if (l_Route->second.m_Interface != p_InterfaceId)
+            advertise(p_InterfaceId, l_Route->second);
+}
+
+void AbstractRouter::closeSession(int p_InterfaceId)
+{
+    unordered_map<uint64_t, AbstractRoute> l_Routes;
+
+    if (!m_Established[p_InterfaceId])
+        return;
+
+    m_Established[p_InterfaceId] = false;
+    m_PeerIdentifier[p_InterfaceId] = 0;
+    l_Routes.swap(m_AdjRibIn[p_InterfaceId]);
+
+    for (unordered_map<uint64_t, AbstractRoute>::iterator l_Route = l_Routes.begin(); l_Route != l_Routes.end(); ++l_Route)
+        decide(l_Route->first, l_Route->second.m_Prefix, l_Route->second.m_Length);
+}
+
+void AbstractRouter::advertise(int p_InterfaceId, const AbstractRoute& p_Route)
+{
+    BGPMessage l_Update;
+
+    l_Update.setType(BGPMessageType::Update);
+    l_Update.m_BGPIdentifier = m_BGPIdentifier;
+    l_Update.m_OutboundInterface = p_InterfaceId;
+    l_Update.m_Prefix = p_Route.m_Prefix;
+    l_Update.m_PrefixLength = p_Route.m_Length;
+    l_Update.m_PathLength = p_Route.m_PathLength + 1;
+    send(p_InterfaceId, l_Update);
+}
+
+void AbstractRouter::sendWithdraw(int p_InterfaceId, uint32_t p_Prefix, int p_Length)
+{
+    BGPMessage l_Update;
+
+    l_Update.setType(BGPMessageType::Update);
+    l_Update.m_BGPIdentifier = m_BGPIdentifier;
+    l_Update.m_OutboundInterface = p_InterfaceId;
+    l_Update.m_Prefix = p_Prefix;
+    l_Update.m_PrefixLength = p_Length;
+    l_Update.m_Withdraw = true;
+    send(p_InterfaceId, l_Update);
+}
+
+bool AbstractRouter::send(int p_InterfaceId, BGPMessage& p_BGPMsg)
+{
+    if (!m_InterfaceUp[p_InterfaceId] || port_ForwardingInterface[p_InterfaceId]->size() == 0)
+        return false;
+
+    if (p_BGPMsg.m_Type == BGPMessageType::Update)
+        m_UpdatesSent++;
+
+    Packet l_Packet(p_BGPMsg, BGP_PROTOCOL);
+    return (*port_ForwardingInterface[p_InterfaceId])->forward(l_Packet);
+}
@@ -0,0 +1,307 @@
+/*! \file  AbstractRouter.hpp
+ *  \brief     Header file of AbstractRouter module
+ *  \details
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 17:22:05 2026
+ */
+
+/*!
+ * \class AbstractRouter
+ * \brief Control plane only model of a router
+ *  \details Has the same receiving exports and forwarding ports as
+ * Router, so the two can be connected to each other in any mix, but
+ * has no data plane, interface FIFOs or clocks. A packet forwarded to
+ * the router is handled at once in the caller's process:
+ * a BGP message runs the best-path selection and the changes are
+ * forwarded to the peers in the same delta cycle. IP packets are
+ * dropped. Meant for the large part of a topology whose forwarding is
+ * not of interest, so that only the routers of interest need to be
+ * full Router modules.
+ *
+ * When the simulation starts the router sends its OPEN on every
+ * interface set up and takes the session as established. The peer's
+ * OPEN gives the peer identifier of the session, and a router that
+ * receives an OPEN on an interface without a session opens one and
+ * answers with its own OPEN. The best route of
+ * a prefix has the shortest AS path, then the lowest peer identifier.
+ * A route is not advertised back to the interface it was learned
+ * from, and routes longer than ABSTRACT_MAX_PATH_LENGTH are treated
+ * as unreachable, which ends the counting up of withdrawn routes in
+ * the loops of the topology.
+ */
+
+
+#include "systemc"
+#include <deque>
+#include <vector>
+#include <unordered_map>
+#include <stdint.h>
+#include "Packet.hpp"
+#include "Interface_If.hpp"
+#include "RoutingTable_Manage_If.hpp"
+#include "MemoryAccounting.hpp"
+#include "FlapDampening.hpp"
+
+
+using namespace std;
+using namespace sc_core;
+using namespace sc_dt;
+
+#ifndef _ABSTRACTROUTER_H_
+#define _ABSTRACTROUTER_H_
+
+
+/*! \def ABSTRACT_MAX_PATH_LENGTH
+ *  \brief Defines the longest AS path accepted by an AbstractRouter
+ */
+#define ABSTRACT_MAX_PATH_LENGTH 32
+
+/*! \def LOCAL_ROUTE
+ *  \brief Defines the interface of a route originated by the router
+ */
+#define LOCAL_ROUTE -2
+
+
+class AbstractRouter;
+
+
+/*!
+ * \class AbstractInterface
+ * \brief Receives the packets of one interface of an AbstractRouter
+ */
+class AbstractInterface: public Interface_If
+{
+
+public:
+
+    AbstractInterface(AbstractRouter* p_Router, int p_Interface);
+
+    virtual bool forward(Packet p_Packet);
+
+    virtual void interfaceDown(void);
+
+    virtual void interfaceUp(void);
+
+private:
+
+    AbstractRouter* m_Router;
+
+    int m_Interface;
+};
+
+
+/*!
+ * \class AbstractRoute
+ * \brief A route of the Adj-RIB-In or the Loc-RIB of an AbstractRouter
+ */
+struct AbstractRoute
+{
+    uint32_t m_Prefix;
+
+    int m_Length;
+
+    /*! \brief The interface the route was learned from
+     * \details LOCAL_ROUTE: originated by the router
+     */
+    int m_Interface;
+
+    int m_PathLength;
+
+    uint32_t m_PeerIdentifier;
+};
+
+
+
+class AbstractRouter: public sc_module
+{
+
+public:
+
+    sc_export<Interface_If> **export_ReceivingInterface;
+
+    sc_port<Interface_If, 1, SC_ZERO_OR_MORE_BOUND> **port_ForwardingInterface;
+
+
+    /*!
+     * \brief Constructor
+     * \details Builds the router
+     * @param[in] p_Name The name of the module
+     * @param[in] int p_InterfaceCount The number of interfaces
+     * @param[in] uint32_t p_BGPIdentifier The BGP identifier of the router
+     * \public
+     */
+    AbstractRouter(sc_module_name p_ModuleName, int p_InterfaceCount, uint32_t p_BGPIdentifier);
+
+    ~AbstractRouter();
+
+    /*! \brief Sets the interface up
+     * \details The router opens a session on the interface when the
+     * simulation starts. An interface suppressed by its FlapDampening
+     * comes up when the penalty has decayed.
+     * \public
+     */
+    void interfaceUp(int p_InterfaceId);
+
+    /*! \brief Sets the interface down and closes its session
+     * \details The routes learned from the interface are withdrawn
+     * \public
+     */
+    void interfaceDown(int p_InterfaceId);
+
+    /*! \brief Brings up the suppressed interfaces whose link is up and
+     * whose penalty has decayed
+     * \public
+     */
+    void reuseInterfaces(void);
+
+    /*! \brief Originates a prefix from this router
+     * \public
+     */
+    void originate(uint32_t p_Prefix, int p_Length);
+
+    /*! \brief Withdraws a prefix originated by this router
+     * \return <bool> False: if the prefix was not originated here
+     * \public
+     */
+    bool withdraw(uint32_t p_Prefix, int p_Length);
+
+    /*! \brief Handles a packet received from an interface
+     * \details Called by the receiving exports. The packets forwarded
+     * while an other packet is handled are queued, so the handling
+     * does not recurse through the routers of the topology.
+     * \public
+     */
+    bool receive(int p_InterfaceId, const Packet& p_Packet);
+
+    /*! \brief The best route of the prefix
+     * \return <const AbstractRoute*> NULL: if there is no route
+     * \public
+     */
+    const AbstractRoute* getRoute(uint32_t p_Prefix, int p_Length) const;
+
+    size_t getRouteCount(void) const;
+
+    /*! \brief Prints the totals of the router
+     * \public
+     */
+    void printStatistics(void);
+
+    /*! \brief Opens the sessions of the interfaces set up
+     * \details Runs once when the simulation starts
+     * \public
+     */
+    void openSessions(void);
+
+    void end_of_simulation();
+
+    SC_HAS_PROCESS(AbstractRouter);
+
+private:
+
+    /*! \brief A packet waiting to be handled
+     * \private
+     */
+    struct PendingPacket
+    {
+        AbstractRouter* m_Router;
+
+        int m_Interface;
+
+        Packet m_Packet;
+    };
+
+    /*! \brief The packets forwarded to any AbstractRouter while one is
+     * handled
+     * \private
+     */
+    static deque<PendingPacket> s_Pending;
+
+    static bool s_Handling;
+
+    void handle(int p_InterfaceId, BGPMessage& p_BGPMsg);
+
+    /*! \brief Selects the best route of the prefix again
+     * \details Updates the Loc-RIB and advertises a changed best route
+     * \private
+     */
+    void decide(uint64_t p_Key, uint32_t p_Prefix, int p_Length);
+
+    /*! \brief Marks the session of the interface established
+     * \details Sends the OPEN and the Loc-RIB to the peer
+     * \private
+     */
+    void openSession(int p_InterfaceId);
+
+    /*! \brief Closes the session and withdraws its routes
+     * \private
+     */
+    void closeSession(int p_InterfaceId);
+
+    void advertise(int p_InterfaceId, const AbstractRoute& p_Route);
+
+    void sendWithdraw(int p_InterfaceId, uint32_t p_Prefix, int p_Length);
+
+    bool send(int p_InterfaceId, BGPMessage& p_BGPMsg);
+
+    int m_InterfaceCount;
+
+    uint32_t m_BGPIdentifier;
+
+    AbstractInterface **m_Interfaces;
+
+    vector<bool> m_InterfaceUp;
+
+    /*! \brief The link state of each interface, m_InterfaceUp is held
+     * down while the interface is suppressed
+     * \private
+     */
+    vector<bool> m_LinkUp;
+
+    vector<FlapDampening> m_Dampening;
+
+    sc_event m_ReuseEvent;
+
+    /*! \brief The session state of each interface
+     * \private
+     */
+    vector<bool> m_Established;
+
+    vector<uint32_t> m_PeerIdentifier;
+
+    /*! \brief The routes learned from each interface keyed by the
+     * packed prefix and length
+     * \private
+     */
+    vector<unordered_map<uint64_t, AbstractRoute> > m_AdjRibIn;
+
+    unordered_map<uint64_t, AbstractRoute> m_LocalRoutes;
+
+    unordered_map<uint64_t, AbstractRoute> m_LocRib;
+
+    uint64_t m_UpdatesReceived;
+
+    uint64_t m_UpdatesSent;
+
+    uint64_t m_PacketsDropped;
+
+    /*! \brief The UPDATEs of each peer treated as withdraws
+     * \private
+     */
+    vector<uint64_t> m_TreatAsWithdraws;
+
+    /*! \brief The UPDATEs of each peer whose malformed attributes were
+     * discarded
+     * \private
+     */
+    vector<uint64_t> m_AttributeDiscards;
+
+    /*! \brief The router the RIB memory is charged to
+     * \private
+     */
+    int m_MemoryRouter;
+
+};
+
+
+#endif /* _ABSTRACTROUTER_H_ */
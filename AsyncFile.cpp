@@ -0,0 +1,303 @@
+/*! \file AsyncFile.cpp
+ *  \brief     Implementation of the asynchronous file reader and writer.
+ *  \details
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 15:02:26 2026
+ */
+
+
+#include "AsyncFile.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+
+/*! \brief Waits until the backend has released the request
+ * \details Only used when closing, after the simulation has ended
+ */
+static void waitIdle(const AsyncIO_Request& p_Request)
+{
+    while (!p_Request.isIdle())
+        std::this_thread::yield();
+}
+
+/*! \brief Submits the request or fails it if the backend has stopped
+ */
+static void submitRequest(AsyncIO_Request& p_Request)
+{
+    if (!AsyncIO_Backend::instance().submit(&p_Request))
+        p_Request.complete(-ESHUTDOWN);
+}
+
+
+
+AsyncFileReader::AsyncFileReader(const char* p_Name, size_t p_BlockSize, int p_Readahead):sc_prim_channel(p_Name), m_Fd(-1), m_BlockSize(p_BlockSize), m_BlockCount(max(p_Readahead, 1)), m_Current(0), m_NextOffset(0), m_EndOfFile(true), m_Error(0)
+{
+    m_Blocks = new Block[m_BlockCount];
+    for (int i = 0; i < m_BlockCount; i++)
+        {
+            m_Blocks[i].m_Data = new unsigned char[m_BlockSize];
+            m_Blocks[i].m_Consumed = 0;
+        }
+}
+
+AsyncFileReader::~AsyncFileReader()
+{
+    close();
+    for (int i = 0; i < m_BlockCount; i++)
+        delete[] m_Blocks[i].m_Data;
+    delete[] m_Blocks;
+}
+
+
+bool AsyncFileReader::open(const string& p_Path)
+{
+    close();
+
+    m_Fd = ::open(p_Path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (m_Fd < 0)
+        {
+            m_Error = errno;
+            return false;
+        }
+    posix_fadvise(m_Fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    m_Current = 0;
+    m_NextOffset = 0;
+    m_EndOfFile = false;
+    m_Error = 0;
+    for (int i = 0; i < m_BlockCount; i++)
+        submit(m_Blocks[i]);
+    return true;
+}
+
+void AsyncFileReader::close(void)
+{
+    if (m_Fd < 0)
+        return;
+    for (int i = 0; i < m_BlockCount; i++)
+        waitIdle(m_Blocks[i].m_Request);
+    ::close(m_Fd);
+    m_Fd = -1;
+    m_EndOfFile = true;
+}
+
+size_t AsyncFileReader::nb_read(void* p_Buffer, size_t p_Length)
+{
+    unsigned char* l_Buffer = (unsigned char*)p_Buffer;
+    size_t l_Copied = 0;
+
+    while (l_Copied < p_Length && !m_EndOfFile)
+        {
+            Block& l_Block = m_Blocks[m_Current];
+
+            if (!l_Block.m_Request.isDone())
+                break;
+            if (l_Block.m_Request.m_Result < 0)
+                {
+                    m_Error = -l_Block.m_Request.m_Result;
+                    m_EndOfFile = true;
+                    break;
+                }
+
+            size_t l_Available = l_Block.m_Request.m_Result - l_Block.m_Consumed;
+            size_t l_Count = min(l_Available, p_Length - l_Copied);
+
+            memcpy(l_Buffer + l_Copied, l_Block.m_Data + l_Block.m_Consumed, l_Count);
+            l_Block.m_Consumed += l_Count;
+            l_Copied += l_Count;
+
+            if (l_Block.m_Consumed == (size_t)l_Block.m_Request.m_Result)
+                {
+                    //a short block is the last one of the file
+                    if ((size_t)l_Block.m_Request.m_Result < m_BlockSize)
+                        {
+                            m_EndOfFile = true;
+                            break;
+                        }
+                    submit(l_Block);
+                    m_Current = (m_Current + 1) % m_BlockCount;
+                }
+        }
+    return l_Copied;
+}
+
+size_t AsyncFileReader::read(void* p_Buffer, size_t p_Length)
+{
+    size_t l_Copied;
+
+    while ((l_Copied = nb_read(p_Buffer, p_Length)) == 0 && !m_EndOfFile && p_Length > 0)
+        wait(m_DataReadyEvent);
+    return l_Copied;
+}
+
+bool AsyncFileReader::eof(void) const
+{
+    return m_EndOfFile;
+}
+
+int AsyncFileReader::error(void) const
+{
+    return m_Error;
+}
+
+const sc_event& AsyncFileReader::data_ready_event(void) const
+{
+    return m_DataReadyEvent;
+}
+
+void AsyncFileReader::ioCompleted(AsyncIO_Request* p_Request)
+{
+    async_request_update();
+}
+
+void AsyncFileReader::update(void)
+{
+    m_DataReadyEvent.notify(SC_ZERO_TIME);
+}
+
+void AsyncFileReader::submit(Block& p_Block)
+{
+    p_Block.m_Consumed = 0;
+    p_Block.m_Request.prepare(m_Fd, false, p_Block.m_Data, m_BlockSize, m_NextOffset, this);
+    m_NextOffset += m_BlockSize;
+    submitRequest(p_Block.m_Request);
+}
+
+
+
+AsyncFileWriter::AsyncFileWriter(const char* p_Name, size_t p_BufferSize):sc_prim_channel(p_Name), m_Fd(-1), m_BufferSize(max(p_BufferSize, (size_t)1)), m_Fill(0), m_FillLength(0), m_Offset(0), m_Error(0)
+{
+    m_Buffers[0] = new unsigned char[m_BufferSize];
+    m_Buffers[1] = new unsigned char[m_BufferSize];
+}
+
+AsyncFileWriter::~AsyncFileWriter()
+{
+    close();
+    delete[] m_Buffers[0];
+    delete[] m_Buffers[1];
+}
+
+
+bool AsyncFileWriter::open(const string& p_Path)
+{
+    close();
+
+    m_Fd = ::open(p_Path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (m_Fd < 0)
+        {
+            m_Error = errno;
+            return false;
+        }
+    m_Fill = 0;
+    m_FillLength = 0;
+    m_Offset = 0;
+    m_Error = 0;
+    return true;
+}
+
+void AsyncFileWriter::close(void)
+{
+    if (m_Fd < 0)
+        return;
+    waitIdle(m_Requests[1 - m_Fill]);
+    flush();
+    for (int i = 0; i < 2; i++)
+        {
+            waitIdle(m_Requests[i]);
+            collect(i);
+        }
+    ::close(m_Fd);
+    m_Fd = -1;
+}
+
+size_t AsyncFileWriter::nb_write(const void* p_Buffer, size_t p_Length)
+{
+    const unsigned char* l_Buffer = (const unsigned char*)p_Buffer;
+    size_t l_Accepted = 0;
+
+    if (m_Fd < 0)
+        return 0;
+    while (l_Accepted < p_Length)
+        {
+            if (m_FillLength == m_BufferSize && !flush())
+                break;
+
+            size_t l_Count = min(m_BufferSize - m_FillLength, p_Length - l_Accepted);
+
+            memcpy(m_Buffers[m_Fill] + m_FillLength, l_Buffer + l_Accepted, l_Count);
+            m_FillLength += l_Count;
+            l_Accepted += l_Count;
+        }
+    return l_Accepted;
+}
+
+void AsyncFileWriter::write(const void* p_Buffer, size_t p_Length)
+{
+    size_t l_Accepted = 0;
+
+    while (m_Fd >= 0)
+        {
+            l_Accepted += nb_write((const unsigned char*)p_Buffer + l_Accepted, p_Length - l_Accepted);
+            if (l_Accepted == p_Length)
+                return;
+            wait(m_BufferFreeEvent);
+        }
+}
+
+bool AsyncFileWriter::flush(void)
+{
+    int l_Other = 1 - m_Fill;
+
+    if (m_FillLength == 0)
+        return true;
+    if (!m_Requests[l_Other].isDone())
+        return false;
+    collect(l_Other);
+
+    m_Requests[m_Fill].prepare(m_Fd, true, m_Buffers[m_Fill], m_FillLength, m_Offset, this);
+    m_Offset += m_FillLength;
+    submitRequest(m_Requests[m_Fill]);
+
+    m_Fill = l_Other;
+    m_FillLength = 0;
+    return true;
+}
+
+int AsyncFileWriter::error(void) const
+{
+    return m_Error;
+}
+
+const sc_event& AsyncFileWriter::buffer_free_event(void) const
+{
+    return m_BufferFreeEvent;
+}
+
+void AsyncFileWriter::ioCompleted(AsyncIO_Request* p_Request)
+{
+    async_request_update();
+}
+
+void AsyncFileWriter::update(void)
+{
+    m_BufferFreeEvent.notify(SC_ZERO_TIME);
+}
+
+void AsyncFileWriter::collect(int p_Buffer)
+{
+    AsyncIO_Request& l_Request = m_Requests[p_Buffer];
+
+    if (m_Error != 0 || l_Request.m_Length == 0)
+        return;
+    if (l_Request.m_Result < 0)
+        m_Error = -l_Request.m_Result;
+    else if ((size_t)l_Request.m_Result != l_Request.m_Length)
+        m_Error = EIO;
+}
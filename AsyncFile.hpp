@@ -0,0 +1,272 @@
+/*! \file  AsyncFile.hpp
+ *  \brief     Asynchronous file reader and writer channels
+ *  \details   Defines the AsyncFileReader and AsyncFileWriter primitive
+ *  channels used to stream MRT dumps, packet captures, traces and
+ *  snapshots without blocking the SystemC kernel thread.
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 15:02:26 2026
+ */
+
+/*!
+ * \class AsyncFileReader
+ * \brief Reads a file sequentially with readahead
+ *  \details The reader keeps a fixed number of blocks of the file in
+ * flight on the AsyncIO backend. nb_read() copies from the completed
+ * blocks in file order and resubmits each consumed block for the next
+ * unread part of the file, so the file is read ahead while the
+ * simulation runs. nb_read() never blocks; read() waits for
+ * data_ready_event() and may only be called from an SC_THREAD.
+ *
+ * \class AsyncFileWriter
+ * \brief Writes a file sequentially through two buffers
+ *  \details nb_write() fills one buffer while the other one is being
+ * written by the AsyncIO backend. A full buffer is swapped with the
+ * other one once that has been written. nb_write() never blocks and
+ * returns the number of bytes it accepted; write() waits for
+ * buffer_free_event() and may only be called from an SC_THREAD.
+ *
+ * The completions arrive on the backend threads and are passed to the
+ * kernel with async_request_update, which notifies the events in the
+ * next update phase. close() waits for the requests in flight and is
+ * meant for the end of the simulation.
+ */
+
+
+#include "systemc"
+#include "AsyncIO.hpp"
+#include <string>
+
+
+using namespace std;
+using namespace sc_core;
+using namespace sc_dt;
+
+#ifndef _ASYNCFILE_H_
+#define _ASYNCFILE_H_
+
+
+/*! \def ASYNCIO_BLOCK_SIZE
+ *  \brief Defines the size of the read blocks and write buffers
+ */
+#define ASYNCIO_BLOCK_SIZE (1 << 20)
+
+/*! \def ASYNCIO_READAHEAD
+ *  \brief Defines the number of blocks a reader keeps in flight
+ */
+#define ASYNCIO_READAHEAD 4
+
+
+
+class AsyncFileReader: public sc_prim_channel, public AsyncIO_Completion_If
+{
+
+public:
+
+    /*!
+     * \brief Constructor
+     * @param[in] const char* p_Name The name of the channel
+     * @param[in] size_t p_BlockSize The size of one read request
+     * @param[in] int p_Readahead The number of blocks kept in flight
+     * \public
+     */
+    AsyncFileReader(const char* p_Name, size_t p_BlockSize = ASYNCIO_BLOCK_SIZE, int p_Readahead = ASYNCIO_READAHEAD);
+
+    ~AsyncFileReader();
+
+    /*! \brief Opens the file and starts reading it ahead
+     * \return <bool> False: if the file cannot be opened
+     * \public
+     */
+    bool open(const string& p_Path);
+
+    /*! \brief Waits for the blocks in flight and closes the file
+     * \public
+     */
+    void close(void);
+
+    /*! \brief Copies up to p_Length bytes of the completed blocks
+     * \return <size_t> The number of bytes copied, zero if no data is
+     * ready or the file has been read
+     * \public
+     */
+    size_t nb_read(void* p_Buffer, size_t p_Length);
+
+    /*! \brief Reads at least one byte unless the file has been read
+     * \details Waits for data_ready_event()
+     * \return <size_t> The number of bytes copied, zero at the end of
+     * the file or on an error
+     * \public
+     */
+    size_t read(void* p_Buffer, size_t p_Length);
+
+    /*! \brief True when every byte of the file has been read
+     * \public
+     */
+    bool eof(void) const;
+
+    /*! \brief The errno value of the first failed read, zero if none
+     * \public
+     */
+    int error(void) const;
+
+    /*! \brief Notified when a block completes
+     * \public
+     */
+    const sc_event& data_ready_event(void) const;
+
+    virtual void ioCompleted(AsyncIO_Request* p_Request);
+
+    virtual const char* kind(void) const
+    {
+        return "AsyncFileReader";
+    }
+
+protected:
+
+    virtual void update(void);
+
+private:
+
+    struct Block
+    {
+        AsyncIO_Request m_Request;
+        unsigned char* m_Data;
+        size_t m_Consumed;
+    };
+
+    AsyncFileReader(const AsyncFileReader&);
+    AsyncFileReader& operator = (const AsyncFileReader&);
+
+    void submit(Block& p_Block);
+
+    int m_Fd;
+
+    size_t m_BlockSize;
+
+    int m_BlockCount;
+
+    /*! \brief The blocks in file order starting from m_Current
+     * \private
+     */
+    Block* m_Blocks;
+
+    int m_Current;
+
+    /*! \brief The file offset of the next block to be submitted
+     * \private
+     */
+    uint64_t m_NextOffset;
+
+    bool m_EndOfFile;
+
+    int m_Error;
+
+    sc_event m_DataReadyEvent;
+};
+
+
+
+class AsyncFileWriter: public sc_prim_channel, public AsyncIO_Completion_If
+{
+
+public:
+
+    /*!
+     * \brief Constructor
+     * @param[in] const char* p_Name The name of the channel
+     * @param[in] size_t p_BufferSize The size of each of the two buffers
+     * \public
+     */
+    AsyncFileWriter(const char* p_Name, size_t p_BufferSize = ASYNCIO_BLOCK_SIZE);
+
+    ~AsyncFileWriter();
+
+    /*! \brief Creates or truncates the file
+     * \return <bool> False: if the file cannot be opened
+     * \public
+     */
+    bool open(const string& p_Path);
+
+    /*! \brief Writes the buffered data, waits for it and closes the file
+     * \public
+     */
+    void close(void);
+
+    /*! \brief Buffers up to p_Length bytes
+     * \return <size_t> The number of bytes accepted. Less than
+     * p_Length when both buffers are busy
+     * \public
+     */
+    size_t nb_write(const void* p_Buffer, size_t p_Length);
+
+    /*! \brief Buffers all p_Length bytes
+     * \details Waits for buffer_free_event() when both buffers are busy
+     * \public
+     */
+    void write(const void* p_Buffer, size_t p_Length);
+
+    /*! \brief Submits the partially filled buffer
+     * \return <bool> False: if the other buffer is still being written
+     * \public
+     */
+    bool flush(void);
+
+    /*! \brief The errno value of the first failed write, zero if none
+     * \public
+     */
+    int error(void) const;
+
+    /*! \brief Notified when a buffer has been written
+     * \public
+     */
+    const sc_event& buffer_free_event(void) const;
+
+    virtual void ioCompleted(AsyncIO_Request* p_Request);
+
+    virtual const char* kind(void) const
+    {
+        return "AsyncFileWriter";
+    }
+
+protected:
+
+    virtual void update(void);
+
+private:
+
+    AsyncFileWriter(const AsyncFileWriter&);
+    AsyncFileWriter& operator = (const AsyncFileWriter&);
+
+    /*! \brief Checks the result of a finished buffer
+     * \private
+     */
+    void collect(int p_Buffer);
+
+    int m_Fd;
+
+    size_t m_BufferSize;
+
+    unsigned char* m_Buffers[2];
+
+    AsyncIO_Request m_Requests[2];
+
+    /*! \brief The buffer being filled
+     * \private
+     */
+    int m_Fill;
+
+    size_t m_FillLength;
+
+    /*! \brief The file offset of the first byte of the fill buffer
+     * \private
+     */
+    uint64_t m_Offset;
+
+    int m_Error;
+
+    sc_event m_BufferFreeEvent;
+};
+
+
+#endif /* _ASYNCFILE_H_ */
@@ -0,0 +1,419 @@
+/*! \file AsyncIO.cpp
+ *  \brief     Implementation of the asynchronous file I/O backends.
+ *  \details   The io_uring backend uses the raw system calls and the
+ *  ring layout of <linux/io_uring.h>. The thread pool backend uses
+ *  pread and pwrite.
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 15:02:26 2026
+ */
+
+
+#include "AsyncIO.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#if defined(__linux__) && defined(__NR_io_uring_setup) && !defined(ASYNCIO_NO_URING)
+#include <linux/io_uring.h>
+#define ASYNCIO_HAVE_URING
+#endif
+
+
+
+/*!
+ * \class ThreadPoolBackend
+ * \brief Runs the requests with pread and pwrite on worker threads
+ */
+class ThreadPoolBackend: public AsyncIO_Backend
+{
+
+public:
+
+    explicit ThreadPoolBackend(int p_ThreadCount):m_Stop(false)
+    {
+        for (int i = 0; i < p_ThreadCount; i++)
+            m_Workers.push_back(std::thread(&ThreadPoolBackend::worker, this));
+    }
+
+    ~ThreadPoolBackend()
+    {
+        {
+            std::lock_guard<std::mutex> l_Lock(m_Mutex);
+            m_Stop = true;
+        }
+        m_Wakeup.notify_all();
+        for (size_t i = 0; i < m_Workers.size(); i++)
+            m_Workers[i].join();
+    }
+
+    virtual bool submit(AsyncIO_Request* p_Request)
+    {
+        {
+            std::lock_guard<std::mutex> l_Lock(m_Mutex);
+            if (m_Stop)
+                return false;
+            m_Queue.push_back(p_Request);
+        }
+        m_Wakeup.notify_one();
+        return true;
+    }
+
+    virtual const char* kind(void) const
+    {
+        return "thread_pool";
+    }
+
+private:
+
+    void worker(void)
+    {
+        while (true)
+            {
+                AsyncIO_Request* l_Request;
+                {
+                    std::unique_lock<std::mutex> l_Lock(m_Mutex);
+                    while (!m_Stop && m_Queue.empty())
+                        m_Wakeup.wait(l_Lock);
+                    //the queued requests are finished before stopping
+                    if (m_Queue.empty())
+                        return;
+                    l_Request = m_Queue.front();
+                    m_Queue.pop_front();
+                }
+                l_Request->complete(execute(l_Request));
+            }
+    }
+
+    /*! \brief Transfers the whole request or up to the end of the file
+     * \private
+     */
+    static ssize_t execute(AsyncIO_Request* p_Request)
+    {
+        char* l_Buffer = (char*)p_Request->m_Buffer;
+        size_t l_Done = 0;
+
+        while (l_Done < p_Request->m_Length)
+            {
+                ssize_t l_Result;
+                if (p_Request->m_Write)
+                    l_Result = pwrite(p_Request->m_Fd, l_Buffer + l_Done, p_Request->m_Length - l_Done, p_Request->m_Offset + l_Done);
+                else
+                    l_Result = pread(p_Request->m_Fd, l_Buffer + l_Done, p_Request->m_Length - l_Done, p_Request->m_Offset + l_Done);
+                if (l_Result < 0)
+                    {
+                        if (errno == EINTR)
+                            continue;
+                        return -errno;
+                    }
+                if (l_Result == 0)
+                    break;
+                l_Done += l_Result;
+            }
+        return l_Done;
+    }
+
+    std::mutex m_Mutex;
+
+    std::condition_variable m_Wakeup;
+
+    std::deque<AsyncIO_Request*> m_Queue;
+
+    std::vector<std::thread> m_Workers;
+
+    bool m_Stop;
+};
+
+
+
+#ifdef ASYNCIO_HAVE_URING
+
+/*!
+ * \class UringBackend
+ * \brief Runs the requests on an io_uring instance
+ * \details The submission queue is filled under a mutex by the
+ * submitting processes and by the reaper, which resubmits the
+ * remainder of partial transfers and the held back requests. The
+ * reaper thread waits for the completions in io_uring_enter, so the
+ * submitting side only enters the kernel to submit.
+ */
+class UringBackend: public AsyncIO_Backend
+{
+
+public:
+
+    UringBackend():m_RingFd(-1), m_SqRing(MAP_FAILED), m_CqRing(MAP_FAILED), m_Sqes(MAP_FAILED), m_SqRingSize(0), m_CqRingSize(0), m_Entries(0), m_InFlight(0), m_Stop(false)
+    {
+    }
+
+    ~UringBackend()
+    {
+        if (m_Reaper.joinable())
+            {
+                //a no-op without a request wakes the reaper up to stop
+                {
+                    std::lock_guard<std::mutex> l_Lock(m_Mutex);
+                    m_Stop = true;
+                    pushEntry(IORING_OP_NOP, NULL);
+                }
+                enter(1, 0, 0);
+                m_Reaper.join();
+            }
+        if (m_Sqes != MAP_FAILED)
+            munmap(m_Sqes, m_Entries * sizeof(struct io_uring_sqe));
+        if (m_CqRing != MAP_FAILED && m_CqRing != m_SqRing)
+            munmap(m_CqRing, m_CqRingSize);
+        if (m_SqRing != MAP_FAILED)
+            munmap(m_SqRing, m_SqRingSize);
+        if (m_RingFd >= 0)
+            close(m_RingFd);
+    }
+
+    /*! \brief Sets up the ring and starts the reaper
+     * \return <bool> False: if io_uring is not available
+     * \public
+     */
+    bool init(unsigned p_Entries)
+    {
+        struct io_uring_params l_Params;
+        memset(&l_Params, 0, sizeof(l_Params));
+
+        m_RingFd = syscall(__NR_io_uring_setup, p_Entries, &l_Params);
+        if (m_RingFd < 0)
+            return false;
+
+        m_Entries = l_Params.sq_entries;
+        m_SqRingSize = l_Params.sq_off.array + l_Params.sq_entries * sizeof(unsigned);
+        m_CqRingSize = l_Params.cq_off.cqes + l_Params.cq_entries * sizeof(struct io_uring_cqe);
+        if (l_Params.features & IORING_FEAT_SINGLE_MMAP)
+            m_SqRingSize = m_CqRingSize = max(m_SqRingSize, m_CqRingSize);
+
+        m_SqRing = mmap(NULL, m_SqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_RingFd, IORING_OFF_SQ_RING);
+        if (m_SqRing == MAP_FAILED)
+            return false;
+        if (l_Params.features & IORING_FEAT_SINGLE_MMAP)
+            m_CqRing = m_SqRing;
+        else
+            {
+                m_CqRing = mmap(NULL, m_CqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_RingFd, IORING_OFF_CQ_RING);
+                if (m_CqRing == MAP_FAILED)
+                    return false;
+            }
+        m_Sqes = mmap(NULL, m_Entries * sizeof(struct io_uring_sqe), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_RingFd, IORING_OFF_SQES);
+        if (m_Sqes == MAP_FAILED)
+            return false;
+
+        char* l_Sq = (char*)m_SqRing;
+        char* l_Cq = (char*)m_CqRing;
+        m_SqTail = (unsigned*)(l_Sq + l_Params.sq_off.tail);
+        m_SqMask = *(unsigned*)(l_Sq + l_Params.sq_off.ring_mask);
+        m_SqArray = (unsigned*)(l_Sq + l_Params.sq_off.array);
+        m_CqHead = (unsigned*)(l_Cq + l_Params.cq_off.head);
+        m_CqTail = (unsigned*)(l_Cq + l_Params.cq_off.tail);
+        m_CqMask = *(unsigned*)(l_Cq + l_Params.cq_off.ring_mask);
+        m_Cqes = (struct io_uring_cqe*)(l_Cq + l_Params.cq_off.cqes);
+
+        m_Reaper = std::thread(&UringBackend::reaper, this);
+        return true;
+    }
+
+    virtual bool submit(AsyncIO_Request* p_Request)
+    {
+        {
+            std::lock_guard<std::mutex> l_Lock(m_Mutex);
+            if (m_Stop)
+                return false;
+            //one entry stays free for the no-op that stops the reaper
+            if (m_InFlight + 1 >= m_Entries)
+                {
+                    m_Pending.push_back(p_Request);
+                    return true;
+                }
+            queue(p_Request);
+        }
+        enter(1, 0, 0);
+        return true;
+    }
+
+    virtual const char* kind(void) const
+    {
+        return "io_uring";
+    }
+
+private:
+
+    int enter(unsigned p_ToSubmit, unsigned p_MinComplete, unsigned p_Flags)
+    {
+        int l_Result;
+        do
+            l_Result = syscall(__NR_io_uring_enter, m_RingFd, p_ToSubmit, p_MinComplete, p_Flags, NULL, 0);
+        while (l_Result < 0 && errno == EINTR);
+        return l_Result;
+    }
+
+    /*! \brief Writes the remainder of the request to the submission queue
+     * \details Called with m_Mutex held
+     * \private
+     */
+    void queue(AsyncIO_Request* p_Request)
+    {
+        p_Request->m_Vector.iov_base = (char*)p_Request->m_Buffer + p_Request->m_Transferred;
+        p_Request->m_Vector.iov_len = p_Request->m_Length - p_Request->m_Transferred;
+        pushEntry(p_Request->m_Write ? IORING_OP_WRITEV : IORING_OP_READV, p_Request);
+        m_InFlight++;
+    }
+
+    void pushEntry(int p_Opcode, AsyncIO_Request* p_Request)
+    {
+        unsigned l_Tail = *m_SqTail;
+        unsigned l_Index = l_Tail & m_SqMask;
+        struct io_uring_sqe* l_Entry = (struct io_uring_sqe*)m_Sqes + l_Index;
+
+        memset(l_Entry, 0, sizeof(*l_Entry));
+        l_Entry->opcode = p_Opcode;
+        l_Entry->user_data = (uint64_t)(uintptr_t)p_Request;
+        if (p_Request != NULL)
+            {
+                l_Entry->fd = p_Request->m_Fd;
+                l_Entry->addr = (uint64_t)(uintptr_t)&p_Request->m_Vector;
+                l_Entry->len = 1;
+                l_Entry->off = p_Request->m_Offset + p_Request->m_Transferred;
+            }
+        m_SqArray[l_Index] = l_Index;
+        __atomic_store_n(m_SqTail, l_Tail + 1, __ATOMIC_RELEASE);
+    }
+
+    void reaper(void)
+    {
+        while (true)
+            {
+                enter(0, 1, IORING_ENTER_GETEVENTS);
+
+                unsigned l_Head = *m_CqHead;
+                unsigned l_Tail = __atomic_load_n(m_CqTail, __ATOMIC_ACQUIRE);
+                unsigned l_Resubmitted = 0;
+                vector<pair<AsyncIO_Request*, ssize_t> > l_Completed;
+
+                if (l_Head == l_Tail)
+                    continue;
+                {
+                    std::lock_guard<std::mutex> l_Lock(m_Mutex);
+                    for (; l_Head != l_Tail; l_Head++)
+                        {
+                            struct io_uring_cqe* l_Entry = &m_Cqes[l_Head & m_CqMask];
+                            AsyncIO_Request* l_Request = (AsyncIO_Request*)(uintptr_t)l_Entry->user_data;
+                            int l_Result = l_Entry->res;
+
+                            if (l_Request == NULL)
+                                continue;
+                            m_InFlight--;
+                            if (l_Result > 0 && l_Request->m_Transferred + l_Result < l_Request->m_Length)
+                                {
+                                    l_Request->m_Transferred += l_Result;
+                                    queue(l_Request);
+                                    l_Resubmitted++;
+                                }
+                            else if (l_Result < 0)
+                                l_Completed.push_back(make_pair(l_Request, (ssize_t)l_Result));
+                            else
+                                l_Completed.push_back(make_pair(l_Request, (ssize_t)(l_Request->m_Transferred + l_Result)));
+                        }
+                    __atomic_store_n(m_CqHead, l_Head, __ATOMIC_RELEASE);
+
+                    while (!m_Pending.empty() && m_InFlight + 1 < m_Entries)
+                        {
+                            queue(m_Pending.front());
+                            m_Pending.pop_front();
+                            l_Resubmitted++;
+                        }
+                }
+                if (l_Resubmitted > 0)
+                    enter(l_Resubmitted, 0, 0);
+
+                //the clients are called without the lock so that they may submit
+                for (size_t i = 0; i < l_Completed.size(); i++)
+                    l_Completed[i].first->complete(l_Completed[i].second);
+
+                std::lock_guard<std::mutex> l_Lock(m_Mutex);
+                if (m_Stop && m_InFlight == 0 && m_Pending.empty())
+                    return;
+            }
+    }
+
+    int m_RingFd;
+
+    void* m_SqRing;
+
+    void* m_CqRing;
+
+    void* m_Sqes;
+
+    size_t m_SqRingSize;
+
+    size_t m_CqRingSize;
+
+    unsigned m_Entries;
+
+    unsigned* m_SqTail;
+
+    unsigned m_SqMask;
+
+    unsigned* m_SqArray;
+
+    unsigned* m_CqHead;
+
+    unsigned* m_CqTail;
+
+    unsigned m_CqMask;
+
+    struct io_uring_cqe* m_Cqes;
+
+    /*! \brief Guards the submission queue and the bookkeeping
+     * \private
+     */
+    std::mutex m_Mutex;
+
+    /*! \brief Requests waiting for room in the submission queue
+     * \private
+     */
+    std::deque<AsyncIO_Request*> m_Pending;
+
+    unsigned m_InFlight;
+
+    bool m_Stop;
+
+    std::thread m_Reaper;
+};
+
+#endif /* ASYNCIO_HAVE_URING */
+
+
+
+AsyncIO_Backend& AsyncIO_Backend::instance(void)
+{
+    static std::unique_ptr<AsyncIO_Backend> s_Backend;
+    static std::once_flag s_Once;
+
+    std::call_once(s_Once, []()
+                   {
+#ifdef ASYNCIO_HAVE_URING
+                       std::unique_ptr<UringBackend> l_Uring(new UringBackend());
+                       if (l_Uring->init(ASYNCIO_QUEUE_DEPTH))
+                           {
+                               s_Backend.reset(l_Uring.release());
+                               return;
+                           }
+#endif
+                       s_Backend.reset(new ThreadPoolBackend(ASYNCIO_THREADS));
+                   });
+    return *s_Backend;
+}
@@ -0,0 +1,194 @@
+/*! \file  AsyncIO.hpp
+ *  \brief     Asynchronous file I/O backends
+ *  \details   Defines the I/O request, the completion interface and the
+ *  backend shared by the asynchronous file readers and writers.
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 15:02:26 2026
+ */
+
+/*!
+ * \class AsyncIO_Backend
+ * \brief Executes positioned reads and writes outside the SystemC kernel
+ *  \details A request is submitted from a SystemC process and executed
+ * by the backend on its own threads. The submission never blocks: the
+ * requests that do not fit into the backend's queue are held back and
+ * submitted when earlier requests complete. When a request completes
+ * the backend calls the ioCompleted() of the request's client from a
+ * backend thread.
+ *
+ * Two backends are available. The io_uring backend talks to the kernel
+ * through the raw io_uring system calls and needs no library. The
+ * thread pool backend runs pread and pwrite on a set of worker threads
+ * and is used when io_uring cannot be set up, for example on old
+ * kernels or when the system call is filtered. instance() returns the
+ * process wide backend and selects it on the first call.
+ */
+
+
+#include <atomic>
+#include <cstddef>
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+
+using namespace std;
+
+#ifndef _ASYNCIO_H_
+#define _ASYNCIO_H_
+
+
+/*! \def ASYNCIO_QUEUE_DEPTH
+ *  \brief Defines the number of requests the io_uring backend keeps
+ *  in flight
+ */
+#define ASYNCIO_QUEUE_DEPTH 64
+
+/*! \def ASYNCIO_THREADS
+ *  \brief Defines the number of workers of the thread pool backend
+ */
+#define ASYNCIO_THREADS 4
+
+
+class AsyncIO_Request;
+
+/*!
+ * \class AsyncIO_Completion_If
+ * \brief Receives the completed requests
+ * \details Called from a backend thread, never from the SystemC kernel
+ */
+class AsyncIO_Completion_If
+{
+
+public:
+
+    virtual ~AsyncIO_Completion_If(){};
+
+    virtual void ioCompleted(AsyncIO_Request* p_Request) = 0;
+};
+
+
+/*!
+ * \class AsyncIO_Request
+ * \brief One positioned read or write
+ * \details The backend transfers the whole length unless the end of
+ * the file is reached or an error occurs. m_Result holds the number
+ * of bytes transferred or a negative errno value, and is valid once
+ * isDone() returns true. The client is notified after that, so the
+ * request and its client may only be destroyed once isIdle() returns
+ * true.
+ */
+class AsyncIO_Request
+{
+
+public:
+
+    AsyncIO_Request():m_Fd(-1), m_Write(false), m_Buffer(NULL), m_Length(0), m_Offset(0), m_Result(0), m_Transferred(0), m_Client(NULL), m_Done(true), m_Idle(true){};
+
+    /*! \brief Prepares the request for a new submission
+     * \public
+     */
+    void prepare(int p_Fd, bool p_Write, void* p_Buffer, size_t p_Length, uint64_t p_Offset, AsyncIO_Completion_If* p_Client)
+    {
+        m_Fd = p_Fd;
+        m_Write = p_Write;
+        m_Buffer = p_Buffer;
+        m_Length = p_Length;
+        m_Offset = p_Offset;
+        m_Result = 0;
+        m_Transferred = 0;
+        m_Client = p_Client;
+        m_Done.store(false, std::memory_order_relaxed);
+        m_Idle.store(false, std::memory_order_relaxed);
+    }
+
+    bool isDone(void) const
+    {
+        return m_Done.load(std::memory_order_acquire);
+    }
+
+    bool isIdle(void) const
+    {
+        return m_Idle.load(std::memory_order_acquire);
+    }
+
+    /*! \brief Publishes the result and notifies the client
+     * \details Called by the backends only
+     * \public
+     */
+    void complete(ssize_t p_Result)
+    {
+        AsyncIO_Completion_If* l_Client = m_Client;
+
+        m_Result = p_Result;
+        m_Done.store(true, std::memory_order_release);
+        if (l_Client != NULL)
+            l_Client->ioCompleted(this);
+        m_Idle.store(true, std::memory_order_release);
+    }
+
+    int m_Fd;
+
+    bool m_Write;
+
+    void* m_Buffer;
+
+    size_t m_Length;
+
+    /*! \brief The file offset of the first byte
+     */
+    uint64_t m_Offset;
+
+    ssize_t m_Result;
+
+    /*! \brief Bytes transferred so far by a partial completion
+     */
+    size_t m_Transferred;
+
+    /*! \brief The vector passed to the io_uring READV and WRITEV
+     */
+    struct iovec m_Vector;
+
+    AsyncIO_Completion_If* m_Client;
+
+private:
+
+    AsyncIO_Request(const AsyncIO_Request&);
+    AsyncIO_Request& operator = (const AsyncIO_Request&);
+
+    std::atomic<bool> m_Done;
+
+    std::atomic<bool> m_Idle;
+};
+
+
+class AsyncIO_Backend
+{
+
+public:
+
+    virtual ~AsyncIO_Backend(){};
+
+    /*! \brief Queues the request for execution
+     * \details Never blocks the caller
+     * \return <bool> False: if the backend has been shut down
+     * \public
+     */
+    virtual bool submit(AsyncIO_Request* p_Request) = 0;
+
+    /*! \brief The name of the backend, "io_uring" or "thread_pool"
+     * \public
+     */
+    virtual const char* kind(void) const = 0;
+
+    /*! \brief Returns the process wide backend
+     * \details Sets up io_uring on the first call and falls back to the
+     * thread pool if that fails
+     * \public
+     */
+    static AsyncIO_Backend& instance(void);
+};
+
+
+#endif /* _ASYNCIO_H_ */
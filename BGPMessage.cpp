@@ -10,7 +10,7 @@
 #include "BGPMessage.hpp"
 
 
-BGPMessage::BGPMessage(BGPMessage& p_Msg)
+BGPMessage::BGPMessage(const BGPMessage& p_Msg)
 {
     *this = p_Msg;
 }
@@ -18,12 +18,42 @@ BGPMessage::BGPMessage(BGPMessage& p_Msg)
 
 BGPMessage& BGPMessage::operator = (const BGPMessage& p_Msg)
 {
-    
+    setType(p_Msg.m_Type);
+    m_BGPIdentifier = p_Msg.m_BGPIdentifier;
+    m_OutboundInterface = p_Msg.m_OutboundInterface;
+    m_Prefix = p_Msg.m_Prefix;
+    m_PrefixLength = p_Msg.m_PrefixLength;
+    m_Withdraw = p_Msg.m_Withdraw;
+    m_PathLength = p_Msg.m_PathLength;
+    m_Origin = p_Msg.m_Origin;
+    m_AggregatorAS = p_Msg.m_AggregatorAS;
+    m_AggregatorIdentifier = p_Msg.m_AggregatorIdentifier;
     return *this;
 }
 
 
 
 bool BGPMessage::operator == (const BGPMessage& p_Msg) const {
-    return true;
+    return (p_Msg.m_Type == m_Type && p_Msg.m_BGPIdentifier == m_BGPIdentifier && p_Msg.m_OutboundInterface == m_OutboundInterface && p_Msg.m_Prefix == m_Prefix && p_Msg.m_PrefixLength == m_PrefixLength && p_Msg.m_Withdraw == m_Withdraw && p_Msg.m_PathLength == m_PathLength && p_Msg.m_Origin == m_Origin && p_Msg.m_AggregatorAS == m_AggregatorAS && p_Msg.m_AggregatorIdentifier == m_AggregatorIdentifier);
+}
+
+UpdateError BGPMessage::checkAttributes(void)
+{
+    UpdateError l_Error = UPDATE_VALID;
+
+    if (m_Type != BGPMessageType::Update || m_Withdraw)
+        return l_Error;
+
+    //an AGGREGATOR needs both the AS and the identifier
+    if ((m_AggregatorAS == 0) != (m_AggregatorIdentifier == 0))
+        {
+            m_AggregatorAS = 0;
+            m_AggregatorIdentifier = 0;
+            l_Error = UPDATE_ATTRIBUTE_DISCARD;
+        }
+
+    //the route cannot be used without a valid ORIGIN and AS_PATH
+    if (m_Origin < ORIGIN_IGP || m_Origin > ORIGIN_INCOMPLETE || m_PathLength < 0 || m_PathLength > BGP_MAX_PATH_LENGTH)
+        l_Error = UPDATE_TREAT_AS_WITHDRAW;
+    return l_Error;
 }
@@ -13,6 +13,7 @@
 
 
 #include <systemc>
+#include <stdint.h>
 
 
 using std::cout;
@@ -22,7 +23,6 @@ using std::string;
 
 using sc_core::sc_trace_file;
 using sc_core::sc_trace;
-using sc_dt::sc_int;
 
 #ifndef BGPMESSAGE_H
 #define BGPMESSAGE_H
@@ -53,22 +53,81 @@ using sc_dt::sc_int;
  */
 #define KEEPALIVE 4
 
+/*! \def ORIGIN_IGP
+ *  \brief Defines the ORIGIN of a route learned from an IGP
+ */
+#define ORIGIN_IGP 0
+
+/*! \def ORIGIN_EGP
+ *  \brief Defines the ORIGIN of a route learned from EGP
+ */
+#define ORIGIN_EGP 1
+
+/*! \def ORIGIN_INCOMPLETE
+ *  \brief Defines the ORIGIN of a route learned by other means
+ */
+#define ORIGIN_INCOMPLETE 2
+
+/*! \def BGP_MAX_PATH_LENGTH
+ *  \brief Defines the longest AS_PATH accepted in an UPDATE
+ */
+#define BGP_MAX_PATH_LENGTH 255
+
+/*! \def BGP_MESSAGE_TYPES
+ *  \brief Defines the number of BGP message types
+ */
+#define BGP_MESSAGE_TYPES 4
+
+
+/*! \brief The BGP message types for the dispatch of the handlers
+ * \details The type of a BGPMessage. The values are the type
+ * definitions above, which are the values on the wire. The enumerators
+ * are not named after the definitions, which the preprocessor would
+ * replace.
+ */
+enum class BGPMessageType : int
+{
+    Open = OPEN,
+    Update = UPDATE,
+    Notification = NOTIFICATION,
+    Keepalive = KEEPALIVE
+};
+
+
+/*! \brief The handling of a malformed UPDATE, by RFC 7606
+ * \details In the order of severity
+ */
+enum UpdateError
+{
+    UPDATE_VALID,
+    UPDATE_ATTRIBUTE_DISCARD,
+    UPDATE_TREAT_AS_WITHDRAW
+};
+
 class BGPMessage
 {
 public:
 
 
-    /*! \brief Holds the BGP message type value
-     * \details 
+    /*! \brief Holds the BGP message type
+     * \details Of the value 0 until the type is set. Shall be set with
+     * setType(), which keeps m_TracedType up to date. Converted to the
+     * type's value only on the wire and in the traces
      * \private
      */
-    int m_Type;
+    BGPMessageType m_Type;
+
+    /*! \brief The value of m_Type, which the trace file reads
+     * \details Not to be used by the model
+     * \private
+     */
+    int m_TracedType;
 
     /*! \brief The originator's BGP identifier
      * \details 
      * \private
      */
-    sc_int<32> m_BGPIdentifier;
+    uint32_t m_BGPIdentifier;
 
     /*! \brief The originator's BGP identifier
      * \details 
@@ -76,11 +135,54 @@ public:
      */
     int m_OutboundInterface;
 
-    BGPMessage():m_Type(0){};
+    /*! \brief The prefix announced or withdrawn by an UPDATE
+     * \details
+     * \private
+     */
+    uint32_t m_Prefix;
+
+    /*! \brief The length of m_Prefix in bits
+     * \details
+     * \private
+     */
+    int m_PrefixLength;
+
+    /*! \brief True: the UPDATE withdraws m_Prefix
+     * \details False: the UPDATE announces m_Prefix
+     * \private
+     */
+    bool m_Withdraw;
+
+    /*! \brief The number of AS hops of the announced route
+     * \details The length of the AS_PATH used by the best-path
+     * selection
+     * \private
+     */
+    int m_PathLength;
+
+    /*! \brief The ORIGIN of the announced route
+     * \details ORIGIN_IGP, ORIGIN_EGP or ORIGIN_INCOMPLETE
+     * \private
+     */
+    int m_Origin;
+
+    /*! \brief The AS of the AGGREGATOR, 0 if there is no AGGREGATOR
+     * \details
+     * \private
+     */
+    uint32_t m_AggregatorAS;
+
+    /*! \brief The BGP identifier of the AGGREGATOR
+     * \details
+     * \private
+     */
+    uint32_t m_AggregatorIdentifier;
+
+    BGPMessage():m_Type(), m_TracedType(0), m_BGPIdentifier(0), m_OutboundInterface(0), m_Prefix(0), m_PrefixLength(0), m_Withdraw(false), m_PathLength(0), m_Origin(ORIGIN_IGP), m_AggregatorAS(0), m_AggregatorIdentifier(0){};
     
     ~BGPMessage(){};
     
-    BGPMessage(BGPMessage& p_Msg);
+    BGPMessage(const BGPMessage& p_Msg);
     
     
 
@@ -95,7 +197,7 @@ public:
     inline friend ostream& operator << (ostream& os,  BGPMessage const & p_Msg )
     {   
 
-os  << " BGP type: " << p_Msg.m_Type;
+os  << " BGP type: " << (int)p_Msg.m_Type;
         return os;
     }
 
@@ -110,7 +212,8 @@ os  << " BGP type: " << p_Msg.m_Type;
      */
     inline friend void sc_trace(sc_trace_file *p_TraceFilePointer, const BGPMessage& p_Msg, const string & p_TraceObjectName )
     {
-        sc_trace(p_TraceFilePointer, p_Msg.m_Type, p_TraceObjectName + ".type");
+        sc_trace(p_TraceFilePointer, p_Msg.m_TracedType, p_TraceObjectName + ".type");
+        sc_trace(p_TraceFilePointer, p_Msg.m_BGPIdentifier, p_TraceObjectName + ".BGP_Identifier");
     }
 
 
@@ -135,6 +238,30 @@ os  << " BGP type: " << p_Msg.m_Type;
      */
     bool operator == (const BGPMessage& p_Msg) const;
 
+    /*!
+     * \brief Sets the message type
+     * \details Sets m_Type and its traced value m_TracedType
+     * @param[in] BGPMessageType p_Type The type of the message
+     * \public
+     */
+    void setType(BGPMessageType p_Type)
+    {
+        m_Type = p_Type;
+        m_TracedType = (int)p_Type;
+    }
+
+    /*!
+     * \brief Checks the path attributes of an UPDATE
+     * \details The errors are handled by RFC 7606 instead of resetting
+     * the session: a malformed AGGREGATOR is discarded from the message,
+     * and a malformed ORIGIN or AS_PATH makes the announcement be treated
+     * as a withdraw of its prefix. A withdraw carries no attributes.
+     * \return \b <UpdateError> The most severe handling the message
+     * needs, the discards are already made
+     * \public
+     */
+    UpdateError checkAttributes(void);
+
 private:
 
 
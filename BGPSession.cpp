@@ -10,7 +10,7 @@
 #include "BGPSession.hpp"
 
 
-BGPSession::BGPSession(sc_module_name p_ModuleName, BGPSessionParameters p_SessionParam):sc_module(p_ModuleName)
+BGPSession::BGPSession(sc_module_name p_ModuleName, SessionTable& p_Table, int p_Session, BGPSessionParameters p_SessionParam):sc_module(p_ModuleName), m_Table(&p_Table), m_Session(p_Session)
 {
 
     //assign the session parameters
@@ -30,7 +30,7 @@ BGPSession::BGPSession(sc_module_name p_ModuleName, BGPSessionParameters p_Sessi
 
 }
 
-BGPSession::BGPSession(sc_module_name p_ModuleName, int p_PeeringInterface, BGPSessionParameters p_SessionParam):sc_module(p_ModuleName)
+BGPSession::BGPSession(sc_module_name p_ModuleName, SessionTable& p_Table, int p_Session, int p_PeeringInterface, BGPSessionParameters p_SessionParam):sc_module(p_ModuleName), m_Table(&p_Table), m_Session(p_Session)
 {
 
     //assign the session parameters
@@ -62,7 +62,7 @@ BGPSession::~BGPSession()
 void BGPSession::sendKeepalive(void)
 {
     //send keepalives only if the session is valid
-    if (m_SessionValidity)
+    if (isSessionValid())
         {
         
     
@@ -73,6 +73,7 @@ void BGPSession::sendKeepalive(void)
             cout << name() << " sending keepalive at time " << sc_time_stamp() << endl;
             //write the message to the control plane
             port_ToDataPlane->write(m_KeepaliveMsg);
+            m_Table->countKeepaliveSent(m_Session);
         }
 
 
@@ -90,6 +91,7 @@ void BGPSession::sessionInvalidation(void)
 {
     cout << name() << " session invalid at time " << sc_time_stamp()  << endl;
 
+    m_Table->countExpiration(m_Session);
     sessionStop();
     next_trigger(m_BGPHoldDown);
 }
@@ -98,14 +100,14 @@ void BGPSession::sessionStop(void)
 {
     m_BGPHoldDown.cancel();
     m_BGPKeepalive.cancel();
-    m_SessionValidity = false;
+    m_Table->setState(m_Session, SESSION_IDLE);
 }
 
 void BGPSession::sessionStart(void)
 {
     resetHoldDown();
     resetKeepalive();
-    m_SessionValidity = true;
+    m_Table->setState(m_Session, SESSION_ESTABLISHED);
 }
 
 
@@ -114,6 +116,7 @@ void BGPSession::resetKeepalive(void)
     m_KeepaliveMutex.lock();
     m_BGPKeepalive.cancel();
     m_BGPKeepalive.notify(m_KeepaliveTime, SC_SEC);
+    m_Table->setKeepaliveDeadline(m_Session, sc_time_stamp().to_seconds() + m_KeepaliveTime);
     m_KeepaliveMutex.unlock();
 }
 
@@ -121,6 +124,7 @@ void BGPSession::resetHoldDown(void)
 {
     m_BGPHoldDown.cancel();
     m_BGPHoldDown.notify(m_HoldDownTime, SC_SEC);
+    m_Table->setHoldDownDeadline(m_Session, sc_time_stamp().to_seconds() + m_HoldDownTime);
 }
 
 void BGPSession::setSessionParameters(BGPSessionParameters p_SessionParam)
@@ -133,18 +137,18 @@ void BGPSession::setSessionParameters(BGPSessionParameters p_SessionParam)
 
 bool BGPSession::isSessionValid(void)
 {
-    return m_SessionValidity;
+    return m_Table->getState(m_Session) == SESSION_ESTABLISHED;
 }
 
-bool BGPSession::isThisSession(sc_int<32> p_BGPIdentifier)
+bool BGPSession::isThisSession(uint32_t p_BGPIdentifier)
 {
 
     
-    return m_BGPIdentifierPeer == p_BGPIdentifier ? true : false;
+    return m_Table->getPeerIdentifier(m_Session) == p_BGPIdentifier ? true : false;
 }
 
-void BGPSession::setPeerIdentifier(sc_int<32> p_BGPIdentifier)
+void BGPSession::setPeerIdentifier(uint32_t p_BGPIdentifier)
 {
-    m_BGPIdentifierPeer = p_BGPIdentifier;
+    m_Table->setPeerIdentifier(m_Session, p_BGPIdentifier);
 }
 
@@ -30,12 +30,17 @@
  * before the timers are reset. Whenever Control Plane notices that
  * the session is not valid it shall update the Routing table
  * accordingly and generate required notification messages.
+ *
+ * The state, the peer identifier, the timer deadlines and the
+ * counters of the session are kept in the Control Plane's
+ * SessionTable at the session's index.
  */
 
 
 #include "systemc"
 #include "BGPMessage.hpp"
 #include "BGPSessionParameters.hpp"
+#include "SessionTable.hpp"
 #include "DataPlane_In_If.hpp"
 
 
@@ -72,23 +77,29 @@ public:
      * \details 
      * @param[in] sc_module_name p_ModuleName Defines a unique name
      * for this module
+     * @param[in] SessionTable& p_Table The table holding the state of
+     * the session
+     * @param[in] int p_Session The index of the session in p_Table
      * @param[in] int p_PeeringInterface The outbound interface to
      * which the peer connects
      * @param[in] BGPSessionParameters p_SessionParameters Holds the
      * keepalive fraction, holddown time, etc. values for this session
      * \public
      */
-    BGPSession(sc_module_name p_ModuleName, int p_PeeringInterface, BGPSessionParameters p_SessionParam);
+    BGPSession(sc_module_name p_ModuleName, SessionTable& p_Table, int p_Session, int p_PeeringInterface, BGPSessionParameters p_SessionParam);
 
     /*! \brief Elaborates the BGPSession module
      * \details 
      * @param[in] sc_module_name p_ModuleName Defines a unique name
      * for this module
+     * @param[in] SessionTable& p_Table The table holding the state of
+     * the session
+     * @param[in] int p_Session The index of the session in p_Table
      * @param[in] BGPSessionParameters p_SessionParameters Holds the
      * keepalive fraction, holddown time, etc. values for this session
      * \public
      */
-    BGPSession(sc_module_name p_ModuleName, BGPSessionParameters p_SessionParam);
+    BGPSession(sc_module_name p_ModuleName, SessionTable& p_Table, int p_Session, BGPSessionParameters p_SessionParam);
 
 
 
@@ -153,21 +164,21 @@ public:
 
     /*! \brief Sets the BGP Identifier of the session peer
      * \details
-     * @param[in] sc_int<32> p_BGPIdentifier of the session peer
+     * @param[in] uint32_t p_BGPIdentifier of the session peer
      * received message
      * \public
      */
-    void setPeerIdentifier(sc_int<32> p_BGPIdentifier);
+    void setPeerIdentifier(uint32_t p_BGPIdentifier);
 
     /*! \brief Checks whether this session is for the passed BGP Identifier
      * \details
-     * @param[in] sc_int<32> p_BGPIdentifier The BGP Identifier of the
+     * @param[in] uint32_t p_BGPIdentifier The BGP Identifier of the
      * received message
      * \return <bool> True: if this session corresponds the received
      * message a identifier. False: in any other case
      * \public
      */
-    bool isThisSession(sc_int<32> p_BGPIdentifier);
+    bool isThisSession(uint32_t p_BGPIdentifier);
 
     /*! \brief Resets the Keepalive timer
      * \details 
@@ -243,13 +254,18 @@ private:
      */
     int m_KeepaliveFraction;
 
-    /*! \brief Indicates whether this session is valid or not
-     * \details Is set to True when the session start. When ever the
-     * HoldDown timer expires the value of m_SessionValidity shall be
-     * set to Fasle
+    /*! \brief The table holding the state of this session
+     * \details The session is valid while its state in the table is
+     * SESSION_ESTABLISHED. The state is set when the session starts
+     * and reset when the HoldDown timer expires
      * \private
      */
-    bool m_SessionValidity;
+    SessionTable* m_Table;
+
+    /*! \brief The index of this session in m_Table
+     * \private
+     */
+    int m_Session;
 
 
     /*! \brief BGP message object
@@ -258,8 +274,6 @@ private:
      */
     BGPMessage m_KeepaliveMsg;
 
-    sc_int<32> m_BGPIdentifierPeer;
-
     /***************************Private functions*****************/
 
 
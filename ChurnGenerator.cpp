@@ -0,0 +1,203 @@
+/*! \file ChurnGenerator.cpp
+ *  \brief     Implementation of ChurnGenerator.
+ *  \details
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 22:31:05 2026
+ */
+
+
+#include "ChurnGenerator.hpp"
+#include <random>
+#include <numeric>
+#include <algorithm>
+#include <cmath>
+
+
+ChurnGenerator::ChurnGenerator(sc_module_name p_ModuleName, ChurnParameters p_Parameters):sc_module(p_ModuleName), m_Parameters(p_Parameters), m_LinkState(true), m_UpdatesSent(0), m_WithdrawsSent(0), m_Received(0)
+{
+    encode();
+
+    SC_THREAD(generate);
+    SC_THREAD(sendKeepalives);
+}
+
+ChurnGenerator::~ChurnGenerator()
+{
+}
+
+
+bool ChurnGenerator::forward(Packet p_Packet)
+{
+    if (!m_LinkState)
+        return false;
+    m_Received++;
+    return true;
+}
+
+void ChurnGenerator::interfaceDown(void)
+{
+    m_LinkState = false;
+}
+
+void ChurnGenerator::interfaceUp(void)
+{
+    m_LinkState = true;
+}
+
+void ChurnGenerator::generate(void)
+{
+    BGPMessage l_Open;
+    const sc_time l_Tick(CHURN_TICK_US, SC_US);
+    double l_Rate = -1;
+    double l_Due = 0;
+    size_t l_Next = 0;
+
+    l_Open.setType(BGPMessageType::Open);
+    l_Open.m_BGPIdentifier = m_Parameters.m_PeerIdentifier;
+    l_Open.m_OutboundInterface = m_Parameters.m_Interface;
+    port_ToControlPlane->write(l_Open);
+
+    while (m_Encoded.size() > 0)
+        {
+            wait(l_Tick);
+            if (getRate(sc_time_stamp()) != l_Rate)
+                {
+                    l_Rate = getRate(sc_time_stamp());
+                    cout << name() << " offers " << l_Rate << " updates per second at " << sc_time_stamp() << endl;
+                }
+            if (!m_LinkState)
+                {
+                    l_Due = 0;
+                    continue;
+                }
+
+            //the fraction of a message left over is due in the next tick
+            for (l_Due += l_Rate * l_Tick.to_seconds(); l_Due >= 1; l_Due -= 1)
+                {
+                    const BGPMessage& l_Msg = m_Encoded[l_Next];
+
+                    port_ToControlPlane->write(l_Msg);
+                    m_UpdatesSent++;
+                    if (l_Msg.m_Withdraw)
+                        m_WithdrawsSent++;
+                    l_Next = l_Next + 1 == m_Encoded.size() ? 0 : l_Next + 1;
+                }
+        }
+}
+
+void ChurnGenerator::sendKeepalives(void)
+{
+    BGPMessage l_Keepalive;
+
+    l_Keepalive.setType(BGPMessageType::Keepalive);
+    l_Keepalive.m_BGPIdentifier = m_Parameters.m_PeerIdentifier;
+    l_Keepalive.m_OutboundInterface = m_Parameters.m_Interface;
+    while (true)
+        {
+            wait(m_Parameters.m_KeepaliveTime);
+            if (m_LinkState)
+                port_ToControlPlane->write(l_Keepalive);
+        }
+}
+
+double ChurnGenerator::getRate(const sc_time& p_Time) const
+{
+    if (m_Parameters.m_RateIncrease == 0 || m_Parameters.m_RampInterval == SC_ZERO_TIME)
+        return m_Parameters.m_UpdatesPerSecond;
+    return m_Parameters.m_UpdatesPerSecond + m_Parameters.m_RateIncrease * floor(p_Time / m_Parameters.m_RampInterval);
+}
+
+uint64_t ChurnGenerator::getUpdatesSent(void) const
+{
+    return m_UpdatesSent;
+}
+
+void ChurnGenerator::end_of_simulation()
+{
+    cout << name() << " updates sent " << m_UpdatesSent << ", withdraws " << m_WithdrawsSent << ", final rate " << getRate(sc_time_stamp()) << " per second, packets received " << m_Received << endl;
+}
+
+
+void ChurnGenerator::encode(void)
+{
+    int l_Prefixes = m_Parameters.m_Prefixes;
+    int l_Shift = 32 - m_Parameters.m_PrefixLength;
+
+    if (l_Prefixes <= 0 || m_Parameters.m_EncodedMessages <= 0 || l_Shift < 0 || l_Shift > 31)
+        return;
+
+    mt19937 l_Random(m_Parameters.m_Seed);
+    uniform_real_distribution<double> l_Uniform(0.0, 1.0);
+    uniform_int_distribution<int> l_PathLengths(1, CHURN_MAX_PATH_LENGTH);
+    vector<double> l_Weights(l_Prefixes);
+    vector<int> l_Ranked(l_Prefixes);
+    vector<int> l_PathLength(l_Prefixes, 0);
+
+    //the cumulative Zipf weights of the ranks, and the prefix of each
+    //rank spread over the range
+    for (int k = 0; k < l_Prefixes; ++k)
+        l_Weights[k] = (k > 0 ? l_Weights[k - 1] : 0) + pow(k + 1.0, -m_Parameters.m_FlapExponent);
+    iota(l_Ranked.begin(), l_Ranked.end(), 0);
+    shuffle(l_Ranked.begin(), l_Ranked.end(), l_Random);
+
+    m_Encoded.reserve(m_Parameters.m_EncodedMessages);
+    while ((int)m_Encoded.size() < m_Parameters.m_EncodedMessages)
+        {
+            size_t l_Rank = upper_bound(l_Weights.begin(), l_Weights.end(), l_Uniform(l_Random) * l_Weights.back()) - l_Weights.begin();
+            int l_Prefix = l_Ranked[min(l_Rank, l_Weights.size() - 1)];
+            double l_Burst = pow(1.0 - l_Uniform(l_Random), -1.0 / m_Parameters.m_BurstShape);
+
+            for (int i = 0; i < min((double)m_Parameters.m_MaxBurst, l_Burst) && (int)m_Encoded.size() < m_Parameters.m_EncodedMessages; ++i)
+                {
+                    BGPMessage l_Msg;
+                    double l_Draw = l_Uniform(l_Random);
+
+                    l_Msg.setType(BGPMessageType::Update);
+                    l_Msg.m_BGPIdentifier = m_Parameters.m_PeerIdentifier;
+                    l_Msg.m_OutboundInterface = m_Parameters.m_Interface;
+                    l_Msg.m_Prefix = m_Parameters.m_FirstPrefix + ((uint32_t)l_Prefix << l_Shift);
+                    l_Msg.m_PrefixLength = m_Parameters.m_PrefixLength;
+
+                    //a prefix that is not announced is announced
+                    if (l_PathLength[l_Prefix] != 0 && l_Draw < m_Parameters.m_WithdrawFraction)
+                        {
+                            l_Msg.m_Withdraw = true;
+                            l_PathLength[l_Prefix] = 0;
+                        }
+                    else if (l_PathLength[l_Prefix] == 0 || l_Draw < m_Parameters.m_WithdrawFraction + m_Parameters.m_AttributeChangeFraction)
+                        {
+                            int l_Length = l_PathLengths(l_Random);
+
+                            if (l_Length == l_PathLength[l_Prefix])
+                                l_Length = l_Length % CHURN_MAX_PATH_LENGTH + 1;
+                            l_PathLength[l_Prefix] = l_Length;
+                        }
+                    l_Msg.m_PathLength = l_PathLength[l_Prefix];
+
+                    //the peer withdraws a malformed announcement
+                    if (!l_Msg.m_Withdraw && l_Uniform(l_Random) < m_Parameters.m_MalformedFraction)
+                        {
+                            l_Msg.m_Origin = ORIGIN_INCOMPLETE + 1;
+                            l_PathLength[l_Prefix] = 0;
+                        }
+                    m_Encoded.push_back(l_Msg);
+                }
+        }
+
+    //the stream closes with the withdraws of the prefixes left
+    //announced, so each replay starts from no routes as the first one
+    for (int k = 0; k < l_Prefixes; ++k)
+        if (l_PathLength[k] != 0)
+            {
+                BGPMessage l_Msg;
+
+                l_Msg.setType(BGPMessageType::Update);
+                l_Msg.m_BGPIdentifier = m_Parameters.m_PeerIdentifier;
+                l_Msg.m_OutboundInterface = m_Parameters.m_Interface;
+                l_Msg.m_Prefix = m_Parameters.m_FirstPrefix + ((uint32_t)k << l_Shift);
+                l_Msg.m_PrefixLength = m_Parameters.m_PrefixLength;
+                l_Msg.m_Withdraw = true;
+                m_Encoded.push_back(l_Msg);
+            }
+}
@@ -0,0 +1,133 @@
+/*! \file  ChurnGenerator.hpp
+ *  \brief     Header file of ChurnGenerator module
+ *  \details
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 22:31:05 2026
+ */
+
+/*!
+ * \class ChurnGenerator
+ * \brief A fake BGP peer that floods a router with synthetic churn
+ *  \details The generator takes the place of a peer router on one of
+ * the router's interfaces. The router forwards to it as to a peer, and
+ * the generator discards what it receives. Its own messages are
+ * written directly into the Control Plane's receiving buffer, as a line
+ * card would pass them on, because the data plane forwards only one
+ * packet per clock cycle. The rate is thus bound only by the Control
+ * Plane, whose work queue drops the messages it cannot keep up with.
+ *
+ * The generator opens the session with an OPEN and keeps it up with
+ * KEEPALIVEs. The UPDATEs are encoded before the simulation starts
+ * (see ChurnParameters) and replayed in a loop, so sending a message
+ * only copies it into the buffer. The encoded stream ends with the
+ * withdraws of the prefixes it leaves announced, so every pass starts
+ * from the state the first one did. The messages due are sent every
+ * CHURN_TICK_US microseconds.
+ */
+
+
+#include "systemc"
+#include <vector>
+#include "BGPMessage.hpp"
+#include "Packet.hpp"
+#include "Interface_If.hpp"
+#include "ChurnParameters.hpp"
+
+
+using namespace std;
+using namespace sc_core;
+using namespace sc_dt;
+
+#ifndef _CHURNGENERATOR_H_
+#define _CHURNGENERATOR_H_
+
+
+/*! \def CHURN_TICK_US
+ *  \brief Defines the interval at which the due messages are sent in
+ *  microseconds
+ */
+#define CHURN_TICK_US 1000
+
+
+
+class ChurnGenerator: public sc_module, public Interface_If
+{
+
+public:
+
+    /*! \brief Writes the messages into the Control Plane
+     * \details Shall be bound to the router's export_ToControlPlane
+     * \public
+     */
+    sc_port<sc_fifo_out_if<BGPMessage> > port_ToControlPlane;
+
+
+    /*!
+     * \brief Constructor
+     * \details Encodes the UPDATEs
+     * \public
+     */
+    ChurnGenerator(sc_module_name p_ModuleName, ChurnParameters p_Parameters);
+
+    ~ChurnGenerator();
+
+    /*! \brief Discards a packet of the router
+     * \public
+     */
+    virtual bool forward(Packet p_Packet);
+
+    /*! \brief Pauses the churn while the link is down
+     * \public
+     */
+    virtual void interfaceDown(void);
+
+    virtual void interfaceUp(void);
+
+    /*! \brief Opens the session and sends the UPDATEs at the rate
+     * \public
+     */
+    void generate(void);
+
+    void sendKeepalives(void);
+
+    /*! \brief The rate the UPDATEs are offered at the time
+     * \public
+     */
+    double getRate(const sc_time& p_Time) const;
+
+    uint64_t getUpdatesSent(void) const;
+
+    void end_of_simulation();
+
+    SC_HAS_PROCESS(ChurnGenerator);
+
+private:
+
+    /*! \brief Builds the UPDATEs of m_Encoded
+     * \private
+     */
+    void encode(void);
+
+    ChurnParameters m_Parameters;
+
+    /*! \brief The UPDATEs replayed by generate()
+     * \details m_EncodedMessages of churn and the closing withdraws
+     * \private
+     */
+    vector<BGPMessage> m_Encoded;
+
+    bool m_LinkState;
+
+    uint64_t m_UpdatesSent;
+
+    uint64_t m_WithdrawsSent;
+
+    /*! \brief Number of packets the router forwarded to the generator
+     * \private
+     */
+    uint64_t m_Received;
+};
+
+
+#endif /* _CHURNGENERATOR_H_ */
@@ -0,0 +1,137 @@
+/*! \file  ChurnParameters.hpp
+ *  \brief    Holds the parameters of a synthetic BGP churn source
+ *  \details
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 22:31:05 2026
+ */
+
+/*!
+ * \class ChurnParameters
+ * \brief Holds the parameters of a ChurnGenerator
+ *  \details The generator announces and withdraws m_Prefixes
+ * consecutive prefixes of m_PrefixLength bits from m_FirstPrefix. The
+ * prefixes flap at heavy-tailed rates: the k-th most active prefix is
+ * picked in proportion to 1 / k^m_FlapExponent. Each pick starts a
+ * burst of updates of that prefix, whose size follows a Pareto
+ * distribution of shape m_BurstShape, capped at m_MaxBurst. An update
+ * of an announced prefix is a withdraw with the probability
+ * m_WithdrawFraction, an announcement with a changed AS path length
+ * with the probability m_AttributeChangeFraction, and otherwise a
+ * duplicate of the previous announcement. A fraction
+ * m_MalformedFraction of the announcements carry a malformed ORIGIN,
+ * which the router treats as a withdraw.
+ *
+ * The updates are sent at m_UpdatesPerSecond, which grows by
+ * m_RateIncrease every m_RampInterval to sweep the rate.
+ */
+
+
+#include "systemc"
+#include <stdint.h>
+
+
+using namespace std;
+using namespace sc_core;
+
+#ifndef _CHURNPARAMETERS_H_
+#define _CHURNPARAMETERS_H_
+
+
+/*! \def CHURN_PEER_IDENTIFIER
+ *  \brief Defines the default BGP identifier of the generator
+ */
+#define CHURN_PEER_IDENTIFIER 0xC6336401u
+
+/*! \def CHURN_PREFIXES
+ *  \brief Defines the default number of prefixes the generator flaps
+ */
+#define CHURN_PREFIXES 100000
+
+/*! \def CHURN_FIRST_PREFIX
+ *  \brief Defines the default first prefix, 100.0.0.0
+ */
+#define CHURN_FIRST_PREFIX 0x64000000u
+
+/*! \def CHURN_UPDATES_PER_SECOND
+ *  \brief Defines the default aggregate update rate
+ */
+#define CHURN_UPDATES_PER_SECOND 10000
+
+/*! \def CHURN_ENCODED_MESSAGES
+ *  \brief Defines the default number of messages encoded in advance
+ */
+#define CHURN_ENCODED_MESSAGES (1 << 18)
+
+/*! \def CHURN_MAX_PATH_LENGTH
+ *  \brief Defines the longest AS path of the generated announcements
+ */
+#define CHURN_MAX_PATH_LENGTH 8
+
+
+
+class ChurnParameters
+{
+
+public:
+
+    ChurnParameters(void):m_Interface(0), m_PeerIdentifier(CHURN_PEER_IDENTIFIER), m_Prefixes(CHURN_PREFIXES), m_FirstPrefix(CHURN_FIRST_PREFIX), m_PrefixLength(24), m_UpdatesPerSecond(CHURN_UPDATES_PER_SECOND), m_RateIncrease(0), m_RampInterval(1, SC_SEC), m_FlapExponent(1.0), m_BurstShape(1.5), m_MaxBurst(64), m_WithdrawFraction(0.3), m_AttributeChangeFraction(0.5), m_MalformedFraction(0), m_KeepaliveTime(60, SC_SEC), m_EncodedMessages(CHURN_ENCODED_MESSAGES), m_Seed(1){};
+
+    /*! \brief The router interface, and so the session, the generator
+     * peers on
+     */
+    int m_Interface;
+
+    uint32_t m_PeerIdentifier;
+
+    int m_Prefixes;
+
+    uint32_t m_FirstPrefix;
+
+    int m_PrefixLength;
+
+    /*! \brief The aggregate rate of the UPDATEs at the start
+     */
+    double m_UpdatesPerSecond;
+
+    /*! \brief The growth of the rate every m_RampInterval, 0 keeps the
+     * rate constant
+     */
+    double m_RateIncrease;
+
+    sc_time m_RampInterval;
+
+    /*! \brief The Zipf exponent of the prefixes' flap rates
+     * \details 0 flaps every prefix equally, the larger the exponent the
+     * more the churn concentrates on few prefixes
+     */
+    double m_FlapExponent;
+
+    /*! \brief The Pareto shape of the burst sizes, the smaller the
+     * heavier the tail
+     */
+    double m_BurstShape;
+
+    int m_MaxBurst;
+
+    double m_WithdrawFraction;
+
+    double m_AttributeChangeFraction;
+
+    double m_MalformedFraction;
+
+    /*! \brief The interval of the generator's KEEPALIVEs
+     */
+    sc_time m_KeepaliveTime;
+
+    /*! \brief Number of UPDATEs encoded before the simulation
+     * \details The encoded UPDATEs are followed by the withdraws of the
+     * prefixes they leave announced and replayed in a loop
+     */
+    int m_EncodedMessages;
+
+    uint32_t m_Seed;
+};
+
+
+#endif /* _CHURNPARAMETERS_H_ */
@@ -8,9 +8,12 @@
 
 
 #include "ControlPlane.hpp"
+#include <thread>
+#include <algorithm>
+#include <cstring>
 
 
-ControlPlane::ControlPlane(sc_module_name p_ModName, int p_Sessions, BGPSessionParameters p_BGPParameters):sc_module(p_ModName)
+ControlPlane::ControlPlane(sc_module_name p_ModName, int p_Sessions, BGPSessionParameters p_BGPParameters, RouteProcessorParameters p_RPParameters):sc_module(p_ModName), m_SessionTable(p_Sessions), m_Journal(this), m_JournalFile("Journal_File"), m_RPParameters(p_RPParameters), m_MessagesProcessed(0), m_BatchesProcessed(0), m_DuplicateUpdates(0), m_ImplicitWithdraws(0), m_QueueDrops(0), m_MaxQueueDepth(0), m_RoutesProgrammed(0), m_MaxFIBBacklog(0)
 {
 
   //make the inner bindings
@@ -19,20 +22,32 @@ ControlPlane::ControlPlane(sc_module_name p_ModName, int p_Sessions, BGPSessionP
                                              //interface for the data plane
 
 
+    m_MemoryRouter = MemoryAccounting::getRouter();
+
     //set the session count
     m_SessionCount = p_Sessions;
 
     //initiate the BGPSession pointer arrays
     m_BGPSessions = new BGPSession*[m_SessionCount];
 
+    //the Adj-RIB-In of each session
+    {
+        MemoryScope l_Scope(MEMORY_RIB);
+        m_AdjRibIn = new AdjRibIn[m_SessionCount];
+    }
+
     //inititate the sessions
+    MemoryScope l_Scope(MEMORY_SESSION);
     for (int i = 0; i < m_SessionCount; ++i)
         {
             //create a session 
-            m_BGPSessions[i] = new BGPSession("BGP_Session", p_BGPParameters);
+            m_BGPSessions[i] = new BGPSession("BGP_Session", m_SessionTable, i, p_BGPParameters);
         }
     
+    SC_THREAD(receiveMessages);
     SC_THREAD(controlPlaneMain);
+    SC_THREAD(programFIB);
+    SC_THREAD(flushJournal);
     sensitive << port_Clk.pos();
 }
 
@@ -42,6 +57,7 @@ ControlPlane::~ControlPlane()
     for (int i = 0; i < m_SessionCount; ++i)
         delete m_BGPSessions[i];
     delete m_BGPSessions;
+    delete[] m_AdjRibIn;
 }
 
 
@@ -54,56 +70,515 @@ void ControlPlane::controlPlaneMain(void)
   //The main thread of the control plane starts
     while(true)
     {
-        wait();
+        while (m_WorkQueue.empty())
+            wait(m_WorkEvent);
+
+        //take a batch in the arrival order and partition it by type
+        sc_time l_Cost = SC_ZERO_TIME;
+
+        for (int i = 0; i < m_RPParameters.m_BatchSize && !m_WorkQueue.empty(); ++i)
+            {
+                const BGPMessage& l_Msg = m_WorkQueue.front();
+                int l_Index = getDispatchIndex(l_Msg.m_Type);
+
+                m_SessionTable.countMessageReceived(l_Msg.m_OutboundInterface);
+
+                //a message of an unknown type is dropped
+                if (l_Index >= 0 && l_Index < BGP_MESSAGE_TYPES)
+                    {
+                        l_Cost += getMessageCost(l_Msg.m_Type);
+                        m_Batch[l_Index].push_back(l_Msg);
+                    }
+                m_WorkQueue.pop_front();
+                m_MessagesProcessed++;
+            }
+
+        //the processor is busy for the cost of the batch
+        wait(l_Cost);
+        m_BusyTime += l_Cost;
+        m_BatchesProcessed++;
+
+        for (int i = 0; i < BGP_MESSAGE_TYPES; ++i)
+            if (!m_Batch[i].empty())
+                {
+                    (this->*s_Dispatch[i].m_Handler)(m_Batch[i]);
+                    m_Batch[i].clear();
+                }
+    }
+}
 
-        //Check if there's messages in the input buffer
-      if(m_ReceivingBuffer.num_available() > 0)
-          {
-              m_ReceivingBuffer.read(m_BGPMsg);
-              
-              //check whether the session is valid     
-              if (m_BGPSessions[m_BGPMsg.m_OutboundInterface]->isThisSession(m_BGPMsg.m_BGPIdentifier)) 
-                  {
-                      //if the session is valid do the required routies
-                   
-                  }
-              //if the session was not valid but this is an OPEN message
-              else if (m_BGPMsg.m_Type = OPEN)
-                  {
 
-                      //start new session for the session index
-                      //corresponding the interface index to which the
-                      //peer is connected
-                      m_BGPSessions[m_BGPMsg.m_OutboundInterface]->setPeerIdentifier(m_BGPMsg.m_BGPIdentifier);
+void ControlPlane::receiveMessages(void)
+{
+    BGPMessage l_Msg;
 
-                      //start the session
-                      m_BGPSessions[m_BGPMsg.m_OutboundInterface]->sessionStart();
+    while (true)
+        {
+            m_ReceivingBuffer.read(l_Msg);
+            if ((int)m_WorkQueue.size() >= m_RPParameters.m_QueueCapacity)
+                {
+                    //the time the processor first fell behind
+                    if (m_QueueDrops++ == 0)
+                        m_FirstQueueDrop = sc_time_stamp();
+                    continue;
+                }
+
+            MemoryScope l_Scope(m_MemoryRouter, MEMORY_FIFO);
+            m_WorkQueue.push_back(l_Msg);
+            m_MaxQueueDepth = max(m_MaxQueueDepth, m_WorkQueue.size());
+            m_WorkEvent.notify();
+        }
+}
 
-                  }
-              //Ohterwise
-              else
-                  {
-                      //drop
+void ControlPlane::programFIB(void)
+{
+    while (true)
+        {
+            while (m_FIBQueue.empty())
+                wait(m_FIBEvent);
+
+            RouteEntry l_Route = m_FIBQueue.front();
+            m_FIBQueue.pop_front();
+            if (l_Route.m_OutboundInterface == NO_ROUTE)
+                removeRoute(l_Route.m_Prefix, l_Route.m_Length);
+            else
+                setRoute(l_Route.m_Prefix, l_Route.m_Length, l_Route.m_OutboundInterface);
+            m_RoutesProgrammed++;
+            m_LastProgrammed = sc_time_stamp();
+
+            wait(sc_time(1.0 / m_RPParameters.m_FIBRoutesPerSecond, SC_SEC));
+        }
+}
 
-                  }
+void ControlPlane::flushJournal(void)
+{
+    while (true)
+        {
+            wait();
 
+            //pass the journal records of the previous cycle to the file
+            m_Journal.flush();
+        }
+}
 
 
+bool ControlPlane::setRoute(uint32_t p_Prefix, int p_Length, int p_OutboundInterface)
+{
+    MemoryScope l_Scope(m_MemoryRouter, MEMORY_RIB);
+    bool l_Success = true;
+
+    for (int i = 0; i < port_RTManage.size(); ++i)
+        l_Success &= port_RTManage[i]->setRoute(p_Prefix, p_Length, p_OutboundInterface);
+    if (l_Success)
+        m_Journal.append(sc_time_stamp().value(), JOURNAL_FIB, JOURNAL_SET, p_Prefix, p_Length, p_OutboundInterface, 0);
+    return l_Success;
+}
 
+bool ControlPlane::removeRoute(uint32_t p_Prefix, int p_Length)
+{
+    MemoryScope l_Scope(m_MemoryRouter, MEMORY_RIB);
+    bool l_Success = true;
+
+    for (int i = 0; i < port_RTManage.size(); ++i)
+        l_Success &= port_RTManage[i]->removeRoute(p_Prefix, p_Length);
+    if (l_Success)
+        m_Journal.append(sc_time_stamp().value(), JOURNAL_FIB, JOURNAL_REMOVE, p_Prefix, p_Length, NO_ROUTE, 0);
+    return l_Success;
+}
 
-              //To send a message to data plane
-              port_ToDataPlane->write(m_BGPMsg);
+bool ControlPlane::setRoutes(const vector<RouteEntry>& p_Routes)
+{
+    MemoryScope l_Scope(m_MemoryRouter, MEMORY_RIB);
+    bool l_Success = true;
+
+    for (int i = 0; i < port_RTManage.size(); ++i)
+        l_Success &= port_RTManage[i]->setRoutes(p_Routes);
+    if (!l_Success)
+        return false;
+
+    uint64_t l_Time = sc_time_stamp().value();
+    for (size_t i = 0; i < p_Routes.size(); ++i)
+        m_Journal.append(l_Time, JOURNAL_FIB, JOURNAL_SET, p_Routes[i].m_Prefix, p_Routes[i].m_Length, p_Routes[i].m_OutboundInterface, 0);
+    return true;
+}
 
+bool ControlPlane::replaceRoutes(const vector<RouteEntry>& p_Routes)
+{
+    MemoryScope l_Scope(m_MemoryRouter, MEMORY_RIB);
+    bool l_Success = true;
+    vector<RouteEntry> l_Sorted(p_Routes);
+    vector<JournalRecord> l_OldRib;
+    vector<JournalRecord> l_OldFib;
+
+    stable_sort(l_Sorted.begin(), l_Sorted.end(), routeLess);
+    getJournalRoutes(JOURNAL_LOC_RIB, l_OldRib);
+    getJournalRoutes(JOURNAL_FIB, l_OldFib);
+
+    for (int i = 0; i < port_RTManage.size(); ++i)
+        l_Success &= port_RTManage[i]->replaceAll(l_Sorted.data(), l_Sorted.data() + l_Sorted.size());
+    if (!l_Success)
+        return false;
+
+    //the loaded routes are learned from no peer
+    m_LocRib.replaceAll(l_Sorted.begin(), l_Sorted.end(), [](const RouteEntry& p_Route)
+                        {
+                            RibRoute l_Route = {maskPrefix(p_Route.m_Prefix, p_Route.m_Length), p_Route.m_Length, p_Route.m_OutboundInterface, 0};
+                            return l_Route;
+                        });
+
+    //the changes queued for the replaced tables are dropped
+    m_FIBQueue.clear();
+    m_FIBBatch.clear();
+    m_FIBBatchIndex.clear();
+
+    journalReplacement(JOURNAL_LOC_RIB, l_OldRib, l_Sorted);
+    journalReplacement(JOURNAL_FIB, l_OldFib, l_Sorted);
+    return true;
+}
 
-              
-              
-              //Handle the message here
-          }
+void ControlPlane::journalReplacement(uint8_t p_Table, const vector<JournalRecord>& p_Old, const vector<RouteEntry>& p_New)
+{
+    uint64_t l_Time = sc_time_stamp().value();
+    size_t l_New = 0;
 
+    //both are sorted, so the old routes that are not in the new table
+    //are found in one pass over the two
+    for (size_t i = 0; i < p_Old.size(); ++i)
+        {
+            uint64_t l_Key = packPrefix(p_Old[i].m_Prefix, p_Old[i].m_Length);
 
+            while (l_New < p_New.size() && packPrefix(maskPrefix(p_New[l_New].m_Prefix, p_New[l_New].m_Length), p_New[l_New].m_Length) < l_Key)
+                l_New++;
+            if (l_New == p_New.size() || packPrefix(maskPrefix(p_New[l_New].m_Prefix, p_New[l_New].m_Length), p_New[l_New].m_Length) != l_Key)
+                m_Journal.append(l_Time, p_Table, JOURNAL_REMOVE, p_Old[i].m_Prefix, p_Old[i].m_Length, NO_ROUTE, p_Old[i].m_PeerIdentifier);
+        }
+    for (size_t i = 0; i < p_New.size(); ++i)
+        m_Journal.append(l_Time, p_Table, JOURNAL_SET, p_New[i].m_Prefix, p_New[i].m_Length, p_New[i].m_OutboundInterface, 0);
+}
 
-        
-    
-    }
+const SessionTable& ControlPlane::getSessionTable(void) const
+{
+    return m_SessionTable;
+}
+
+void ControlPlane::printStatistics(void)
+{
+    SessionTableSnapshot l_Snapshot = m_SessionTable.snapshot();
+    vector<JournalRecord> l_Journalled;
+
+    cout << name() << " sessions: " << l_Snapshot.m_Sessions << ", established " << l_Snapshot.m_Established << ", messages received " << l_Snapshot.m_MessagesReceived << ", keepalives sent " << l_Snapshot.m_KeepalivesSent << ", expirations " << l_Snapshot.m_Expirations << ", treated as withdraw " << l_Snapshot.m_TreatAsWithdraws << ", attributes discarded " << l_Snapshot.m_AttributeDiscards << endl;
+    cout << name() << " route processor: Loc-RIB routes " << m_LocRib.size() << ", duplicate updates " << m_DuplicateUpdates << ", implicit withdraws " << m_ImplicitWithdraws << ", messages processed " << m_MessagesProcessed << " in " << m_BatchesProcessed << " batches, busy " << m_BusyTime << ", queue drops " << m_QueueDrops << " from " << m_FirstQueueDrop << ", max queue depth " << m_MaxQueueDepth << ", routes programmed " << m_RoutesProgrammed << ", max FIB backlog " << m_MaxFIBBacklog << ", FIB backlog " << m_FIBQueue.size() << ", last programmed at " << m_LastProgrammed << endl;
+
+    //the Loc-RIB rebuilt from the journal shall match the Loc-RIB
+    m_Journal.replay(sc_time_stamp().value(), JOURNAL_LOC_RIB, l_Journalled);
+    cout << name() << " journal: records " << m_Journal.getRecordCount() << " after " << m_Journal.getBaseCount() << " bases, Loc-RIB routes replayed " << l_Journalled.size() << (l_Journalled.size() == m_LocRib.size() ? "" : ", differs from the Loc-RIB") << endl;
+}
+
+const RibJournal& ControlPlane::getJournal(void) const
+{
+    return m_Journal;
+}
+
+const LocRib& ControlPlane::getLocRib(void) const
+{
+    return m_LocRib;
+}
+
+bool ControlPlane::setJournalFile(const string& p_Path)
+{
+    if (!m_JournalFile.open(p_Path))
+        return false;
+    m_Journal.attachFile(&m_JournalFile);
+    return true;
+}
+
+void ControlPlane::getJournalRoutes(uint8_t p_Table, vector<JournalRecord>& p_Image) const
+{
+    JournalRecord l_Record;
+
+    memset(&l_Record, 0, sizeof(l_Record));
+    l_Record.m_Table = p_Table;
+
+    if (p_Table == JOURNAL_LOC_RIB)
+        {
+            m_LocRib.walk([&l_Record, &p_Image](uint32_t p_Prefix, int p_Length, const RibRoute& p_Route)
+                          {
+                              l_Record.m_Prefix = p_Prefix;
+                              l_Record.m_Length = (uint8_t)p_Length;
+                              l_Record.m_OutboundInterface = p_Route.m_OutboundInterface;
+                              l_Record.m_PeerIdentifier = p_Route.m_PeerIdentifier;
+                              p_Image.push_back(l_Record);
+                          });
+            return;
+        }
+
+    vector<RouteEntry> l_Routes;
+
+    if (port_RTManage.size() > 0)
+        port_RTManage[0]->getRoutes(l_Routes);
+    for (size_t i = 0; i < l_Routes.size(); ++i)
+        {
+            l_Record.m_Prefix = l_Routes[i].m_Prefix;
+            l_Record.m_Length = (uint8_t)l_Routes[i].m_Length;
+            l_Record.m_OutboundInterface = l_Routes[i].m_OutboundInterface;
+            p_Image.push_back(l_Record);
+        }
+}
+
+void ControlPlane::processUpdate(const BGPMessage& p_Msg)
+{
+    MemoryScope l_Scope(m_MemoryRouter, MEMORY_RIB);
+    if (p_Msg.m_PrefixLength < 0 || p_Msg.m_PrefixLength > 32)
+        return;
+
+    uint64_t l_Key = packPrefix(maskPrefix(p_Msg.m_Prefix, p_Msg.m_PrefixLength), p_Msg.m_PrefixLength);
+    AdjRibIn& l_AdjRibIn = m_AdjRibIn[p_Msg.m_OutboundInterface];
+
+    if (p_Msg.m_Withdraw)
+        {
+            if (!l_AdjRibIn.erase(l_Key))
+                return;
+            selectRoute(l_Key);
+            return;
+        }
+
+    bool l_Inserted;
+    AdjRibRoute& l_AdjRoute = l_AdjRibIn.insert(l_Key, l_Inserted);
+
+    if (!l_Inserted)
+        {
+            if (l_AdjRoute.m_PeerIdentifier == p_Msg.m_BGPIdentifier && l_AdjRoute.m_PathLength == p_Msg.m_PathLength && l_AdjRoute.m_Origin == p_Msg.m_Origin && l_AdjRoute.m_AggregatorAS == p_Msg.m_AggregatorAS && l_AdjRoute.m_AggregatorIdentifier == p_Msg.m_AggregatorIdentifier)
+                {
+                    m_DuplicateUpdates++;
+                    return;
+                }
+            m_ImplicitWithdraws++;
+        }
+    l_AdjRoute.m_OutboundInterface = p_Msg.m_OutboundInterface;
+    l_AdjRoute.m_PeerIdentifier = p_Msg.m_BGPIdentifier;
+    l_AdjRoute.m_PathLength = p_Msg.m_PathLength;
+    l_AdjRoute.m_Origin = p_Msg.m_Origin;
+    l_AdjRoute.m_AggregatorAS = p_Msg.m_AggregatorAS;
+    l_AdjRoute.m_AggregatorIdentifier = p_Msg.m_AggregatorIdentifier;
+    selectRoute(l_Key);
 }
 
+void ControlPlane::selectRoute(uint64_t p_Key)
+{
+    uint32_t l_Prefix = (uint32_t)(p_Key >> 8);
+    int l_Length = (int)(p_Key & 0xFF);
+    uint64_t l_Time = sc_time_stamp().value();
+    const AdjRibRoute* l_Best = NULL;
+
+    for (int i = 0; i < m_SessionCount; ++i)
+        {
+            const AdjRibRoute* l_Route = m_AdjRibIn[i].find(p_Key);
+
+            if (l_Route != NULL && isBetterRoute(*l_Route, l_Best))
+                l_Best = l_Route;
+        }
+
+    RibRoute* l_Current = m_LocRib.find(l_Prefix, l_Length);
+
+    if (l_Best == NULL)
+        {
+            if (l_Current == NULL)
+                return;
+
+            uint32_t l_Peer = l_Current->m_PeerIdentifier;
+
+            m_LocRib.erase(l_Prefix, l_Length);
+            m_Journal.append(l_Time, JOURNAL_LOC_RIB, JOURNAL_REMOVE, l_Prefix, l_Length, NO_ROUTE, l_Peer);
+            queueFIBChange(l_Prefix, l_Length, NO_ROUTE);
+            return;
+        }
+
+    //the FIB only changes with the interface
+    bool l_NewInterface = l_Current == NULL || l_Current->m_OutboundInterface != l_Best->m_OutboundInterface;
+
+    if (!l_NewInterface && l_Current->m_PeerIdentifier == l_Best->m_PeerIdentifier)
+        return;
+
+    RibRoute& l_Route = m_LocRib.insert(l_Prefix, l_Length);
+
+    l_Route.m_Prefix = l_Prefix;
+    l_Route.m_Length = l_Length;
+    l_Route.m_OutboundInterface = l_Best->m_OutboundInterface;
+    l_Route.m_PeerIdentifier = l_Best->m_PeerIdentifier;
+    m_Journal.append(l_Time, JOURNAL_LOC_RIB, JOURNAL_SET, l_Prefix, l_Length, l_Route.m_OutboundInterface, l_Route.m_PeerIdentifier);
+    if (l_NewInterface)
+        queueFIBChange(l_Prefix, l_Length, l_Route.m_OutboundInterface);
+}
+
+bool ControlPlane::isBetterRoute(const AdjRibRoute& p_Route, const AdjRibRoute* p_Best)
+{
+    if (p_Best == NULL)
+        return true;
+    if (p_Route.m_PathLength != p_Best->m_PathLength)
+        return p_Route.m_PathLength < p_Best->m_PathLength;
+    if (p_Route.m_Origin != p_Best->m_Origin)
+        return p_Route.m_Origin < p_Best->m_Origin;
+    return p_Route.m_PeerIdentifier < p_Best->m_PeerIdentifier;
+}
+
+void ControlPlane::clearAdjRibIn(int p_Session)
+{
+    MemoryScope l_Scope(m_MemoryRouter, MEMORY_RIB);
+    vector<uint64_t> l_Keys;
+
+    l_Keys.reserve(m_AdjRibIn[p_Session].size());
+    m_AdjRibIn[p_Session].walk([&l_Keys](uint64_t p_Key, const AdjRibRoute&) { l_Keys.push_back(p_Key); });
+    m_AdjRibIn[p_Session].clear();
+    for (size_t i = 0; i < l_Keys.size(); ++i)
+        selectRoute(l_Keys[i]);
+}
+
+void ControlPlane::processUpdates(const vector<BGPMessage>& p_Msgs)
+{
+    for (size_t i = 0; i < p_Msgs.size(); ++i)
+        processUpdate(p_Msgs[i]);
+    programFIBBatch();
+}
+
+void ControlPlane::programFIBBatch(void)
+{
+    MemoryScope l_Scope(m_MemoryRouter, MEMORY_RIB);
+    vector<RouteEntry> l_Sets;
+
+    if (m_FIBBatch.empty())
+        return;
+
+    //the removals one by one, the routes set in one batch
+    for (size_t i = 0; i < m_FIBBatch.size(); ++i)
+        {
+            if (m_FIBBatch[i].m_OutboundInterface == NO_ROUTE)
+                removeRoute(m_FIBBatch[i].m_Prefix, m_FIBBatch[i].m_Length);
+            else
+                l_Sets.push_back(m_FIBBatch[i]);
+        }
+    if (!l_Sets.empty())
+        setRoutes(l_Sets);
+    m_RoutesProgrammed += m_FIBBatch.size();
+    m_LastProgrammed = sc_time_stamp();
+    m_FIBBatch.clear();
+    m_FIBBatchIndex.clear();
+}
+
+void ControlPlane::queueFIBChange(uint32_t p_Prefix, int p_Length, int p_OutboundInterface)
+{
+    RouteEntry l_Route = {p_Prefix, p_Length, p_OutboundInterface};
+
+    if (m_RPParameters.m_FIBRoutesPerSecond <= 0)
+        {
+            //a later change of the prefix replaces the earlier one
+            uint64_t l_Key = packPrefix(maskPrefix(p_Prefix, p_Length), p_Length);
+            pair<unordered_map<uint64_t, size_t>::iterator, bool> l_Index = m_FIBBatchIndex.insert(make_pair(l_Key, m_FIBBatch.size()));
+
+            if (l_Index.second)
+                m_FIBBatch.push_back(l_Route);
+            else
+                m_FIBBatch[l_Index.first->second] = l_Route;
+            return;
+        }
+
+    m_FIBQueue.push_back(l_Route);
+    m_MaxFIBBacklog = max(m_MaxFIBBacklog, m_FIBQueue.size());
+    m_FIBEvent.notify();
+}
+
+sc_time ControlPlane::getMessageCost(BGPMessageType p_Type) const
+{
+    switch (p_Type)
+        {
+        case BGPMessageType::Open:
+            return m_RPParameters.m_OpenCost;
+        case BGPMessageType::Update:
+            return m_RPParameters.m_UpdateCost;
+        case BGPMessageType::Notification:
+            return m_RPParameters.m_NotificationCost;
+        case BGPMessageType::Keepalive:
+            return m_RPParameters.m_KeepaliveCost;
+        default:
+            return SC_ZERO_TIME;
+        }
+}
+
+constexpr ControlPlane::MessageDispatch ControlPlane::s_Dispatch[BGP_MESSAGE_TYPES] =
+    {
+        {BGPMessageType::Open, &ControlPlane::handleOpens},
+        {BGPMessageType::Update, &ControlPlane::handleUpdates},
+        {BGPMessageType::Notification, &ControlPlane::handleNotifications},
+        {BGPMessageType::Keepalive, &ControlPlane::handleKeepalives}
+    };
+
+//the table is indexed by the type's value
+static_assert(ControlPlane::isDispatchOrdered(), "the dispatch table is not in the order of the message types");
+
+void ControlPlane::handleOpens(const vector<BGPMessage>& p_Batch)
+{
+    for (size_t i = 0; i < p_Batch.size(); ++i)
+        {
+            BGPSession* l_Session = m_BGPSessions[p_Batch[i].m_OutboundInterface];
+
+            //an OPEN of an established session changes nothing
+            if (l_Session->isThisSession(p_Batch[i].m_BGPIdentifier))
+                continue;
+
+            //start new session for the session index corresponding the
+            //interface index to which the peer is connected, the routes
+            //of a previous peer are forgotten
+            l_Session->setPeerIdentifier(p_Batch[i].m_BGPIdentifier);
+            clearAdjRibIn(p_Batch[i].m_OutboundInterface);
+            l_Session->sessionStart();
+        }
+    programFIBBatch();
+}
+
+void ControlPlane::handleUpdates(const vector<BGPMessage>& p_Batch)
+{
+    //the UPDATEs of unknown sessions are dropped
+    for (size_t i = 0; i < p_Batch.size(); ++i)
+        if (m_BGPSessions[p_Batch[i].m_OutboundInterface]->isThisSession(p_Batch[i].m_BGPIdentifier))
+            {
+                m_Updates.push_back(p_Batch[i]);
+
+                //a malformed UPDATE costs its prefix, not the session
+                BGPMessage& l_Msg = m_Updates.back();
+                UpdateError l_Error = l_Msg.checkAttributes();
+
+                if (l_Error == UPDATE_TREAT_AS_WITHDRAW)
+                    l_Msg.m_Withdraw = true;
+                if (l_Error != UPDATE_VALID)
+                    m_SessionTable.countUpdateError(l_Msg.m_OutboundInterface, l_Error);
+            }
+    processUpdates(m_Updates);
+    m_Updates.clear();
+}
+
+void ControlPlane::handleNotifications(const vector<BGPMessage>& p_Batch)
+{
+    //the sessions are closed by their hold timers
+}
+
+void ControlPlane::handleKeepalives(const vector<BGPMessage>& p_Batch)
+{
+    //a KEEPALIVE of an established session keeps it up, the others
+    //are dropped
+    for (size_t i = 0; i < p_Batch.size(); ++i)
+        {
+            BGPSession* l_Session = m_BGPSessions[p_Batch[i].m_OutboundInterface];
+
+            if (l_Session->isThisSession(p_Batch[i].m_BGPIdentifier) && l_Session->isSessionValid())
+                l_Session->resetHoldDown();
+        }
+}
+
+void ControlPlane::end_of_simulation()
+{
+    printStatistics();
+
+    //the kernel has stopped, so the remaining records may be waited for
+    while (!m_Journal.flush())
+        std::this_thread::yield();
+    m_JournalFile.close();
+}
@@ -9,7 +9,16 @@
 /*!
  * \class ControlPlane
  * \brief ControlPlane module runs the BGP process
- *  \details   
+ *  \details The received BGP messages wait in a work queue for the
+ * route processor, which takes them in batches and is busy for the
+ * processing cost of each message in simulated time. A batch is
+ * partitioned by the message type and each partition is passed to the
+ * handler of its type from a dispatch table, so that the KEEPALIVEs are
+ * handled in one loop and the UPDATEs reach the RIB together. The selected
+ * routes wait in a second queue to be programmed into the FIB replicas
+ * at a limited rate. With the RouteProcessorParameters the convergence
+ * of a router is thus bound by its processor and its FIB download
+ * rate, as in a real router.
  */
 
 
@@ -17,7 +26,16 @@
 #include "BGPMessage.hpp"
 //#include "BGPSessionParameters.hpp"
 #include "BGPSession.hpp"
+#include "SessionTable.hpp"
 #include "RoutingTable_Manage_If.hpp"
+#include "RingChannel.hpp"
+#include "RibJournal.hpp"
+#include "AsyncFile.hpp"
+#include "PatriciaTrie.hpp"
+#include "SwissTable.hpp"
+#include "RouteProcessorParameters.hpp"
+#include <unordered_map>
+#include <deque>
 
 
 using namespace std;
@@ -30,9 +48,57 @@ using namespace sc_dt;
 #define CONTROLPLANE_H
 
 
+/*!
+ * \class RibRoute
+ * \brief A route of the Loc-RIB
+ */
+struct RibRoute
+{
+    uint32_t m_Prefix;
+
+    int m_Length;
+
+    int m_OutboundInterface;
+
+    /*! \brief The BGP identifier of the peer the route was learned from
+     */
+    uint32_t m_PeerIdentifier;
+};
+
+/*! \brief The Loc-RIB in prefix order
+ * \details The nodes are kept in slabs on huge pages
+ */
+typedef PatriciaTrie<RibRoute, MEMORY_RIB> LocRib;
+
+/*!
+ * \class AdjRibRoute
+ * \brief A route of a peer's Adj-RIB-In
+ * \details Holds what the best-path selection compares and what a
+ * repeated announcement shall change to be more than a duplicate
+ */
+struct AdjRibRoute
+{
+    int m_OutboundInterface;
+
+    uint32_t m_PeerIdentifier;
+
+    int m_PathLength;
+
+    int m_Origin;
+
+    uint32_t m_AggregatorAS;
+
+    uint32_t m_AggregatorIdentifier;
+};
+
+/*! \brief The Adj-RIB-In of a peer keyed by the packed prefix and
+ * length
+ */
+typedef SwissTable<AdjRibRoute, MEMORY_RIB> AdjRibIn;
+
 
 
-class ControlPlane: public sc_module
+class ControlPlane: public sc_module, public RibJournalSource
 {
 
 public:
@@ -51,17 +117,19 @@ public:
     sc_port<DataPlane_In_If,0, SC_ZERO_OR_MORE_BOUND> port_ToDataPlane;
    
     /*! \brief Routing Table's management port
-     * \details Used to manage the routing table. Add, remove, update routes
+     * \details Used to manage the routing table. Add, remove, update
+     * routes. The port is bound to the FIB replica of every line card
+     * and each change is broadcast to all of them.
      * \public
      */
-    sc_port<RoutingTable_Manage_If,1, SC_ZERO_OR_MORE_BOUND> port_RTManage;
+    sc_port<RoutingTable_Manage_If,0, SC_ZERO_OR_MORE_BOUND> port_RTManage;
    
     /*! \brief Input interface
      * \details Allows data plane to write received BGP messages into
      *  m_ReceivingBuffer-fifo
      * \public
      */
-    sc_export<sc_fifo_in_if<BGPMessage> > export_ToControlPlane;
+    sc_export<sc_fifo_out_if<BGPMessage> > export_ToControlPlane;
    
    
     /*! \brief This provides the DataPlane_In_If for BGP sessions
@@ -88,9 +156,11 @@ void before_end_of_elaboration()
 
   /*! \brief Elaborates the ControlPlane module
    * \details 
+   * @param[in] RouteProcessorParameters p_RPParameters The capacity of
+   * the route processor
    * \public
    */
-    ControlPlane(sc_module_name p_ModuleName, int p_Sessions, BGPSessionParameters p_BGPParameters);
+    ControlPlane(sc_module_name p_ModuleName, int p_Sessions, BGPSessionParameters p_BGPParameters, RouteProcessorParameters p_RPParameters = RouteProcessorParameters());
 
 
 
@@ -103,7 +173,8 @@ void before_end_of_elaboration()
 
 
   /*! \brief The main process of Control Plane module
-   * \details \li Reads BGP messages from the m_ReceivingBuffer. \li
+   * \details \li Takes batches of BGP messages from the work queue and
+   * dispatches them by type. \li
    * performs the route resolution process accoriding to BGP protocol.
    * \li Generates the required update messages. \li Keeps track on
    * different BGP sessions.
@@ -111,6 +182,103 @@ void before_end_of_elaboration()
    */
   void controlPlaneMain(void);
 
+  /*! \brief Moves the received messages into the work queue
+   * \details The messages that find the queue full are dropped
+   * \public
+   */
+  void receiveMessages(void);
+
+  /*! \brief Programs the queued route changes into the FIB replicas
+   * at the configured rate
+   * \public
+   */
+  void programFIB(void);
+
+  /*! \brief Passes the journal records of each clock cycle to the file
+   * \public
+   */
+  void flushJournal(void);
+
+  /*! \brief Sets a route to every FIB replica
+   * \details
+   * @param[in] uint32_t p_Prefix The destination prefix
+   * @param[in] int p_Length The prefix length in bits
+   * @param[in] int p_OutboundInterface The interface towards the next hop
+   * \return <bool> True: if every replica accepted the route
+   * \public
+   */
+  bool setRoute(uint32_t p_Prefix, int p_Length, int p_OutboundInterface);
+
+  /*! \brief Removes a route from every FIB replica
+   * \details
+   * @param[in] uint32_t p_Prefix The destination prefix
+   * @param[in] int p_Length The prefix length in bits
+   * \return <bool> True: if every replica held the route
+   * \public
+   */
+  bool removeRoute(uint32_t p_Prefix, int p_Length);
+
+  /*! \brief Sets a batch of routes to every FIB replica
+   * \details
+   * @param[in] vector<RouteEntry>& p_Routes The routes in any order
+   * \return <bool> True: if every replica accepted the routes
+   * \public
+   */
+  bool setRoutes(const vector<RouteEntry>& p_Routes);
+
+  /*! \brief Replaces the Loc-RIB and the content of every FIB replica
+   * \details For loading a full table, the Loc-RIB trie and the
+   * replicas are built in one pass over the sorted routes. The loaded
+   * routes are learned from no peer (identifier 0). The Adj-RIB-Ins
+   * are kept, so a later UPDATE of a loaded prefix selects its route
+   * from them again. The FIB changes still queued are dropped
+   * @param[in] vector<RouteEntry>& p_Routes The routes in any order
+   * \return <bool> True: if every replica was replaced, False: if a
+   * route is not valid, in which case nothing is changed
+   * \public
+   */
+  bool replaceRoutes(const vector<RouteEntry>& p_Routes);
+
+  /*! \brief The state of the BGP sessions
+   * \public
+   */
+  const SessionTable& getSessionTable(void) const;
+
+  /*! \brief The journal of the Loc-RIB and FIB changes
+   * \public
+   */
+  const RibJournal& getJournal(void) const;
+
+  /*! \brief The Loc-RIB
+   * \details For the ordered walks of the table dumps and of the
+   * queries of the covered and the covering routes
+   * \public
+   */
+  const LocRib& getLocRib(void) const;
+
+  /*! \brief Writes the journal also into a file
+   * \details Shall be called before the simulation starts
+   * @param[in] string p_Path The journal file, truncated if it exists
+   * \return <bool> False: if the file cannot be opened
+   * \public
+   */
+  bool setJournalFile(const string& p_Path);
+
+  /*! \brief Gives the journal the routes of a base
+   * \details Walks the Loc-RIB trie or the FIB in prefix order. The
+   * FIB is read from the first replica, the replicas are equal
+   * \public
+   */
+  virtual void getJournalRoutes(uint8_t p_Table, vector<JournalRecord>& p_Image) const;
+
+  /*! \brief Prints the totals of the session table and of the route
+   * processor
+   * \public
+   */
+  void printStatistics(void);
+
+  void end_of_simulation();
+
   /*! \brief Indicate the systemC producer that this module has a process.
    * \sa http://www.iro.umontreal.ca/~lablasso/docs/SystemC2.0.1/html/classproducer.html
    * \public
@@ -126,10 +294,11 @@ private:
 
     /*! \brief Receiving buffer
      * \details Data plain writes all the received BGP messages into
-     * this fifo
+     * this fifo. The ring accepts several concurrent writers so that
+     * the data plane work can be moved to other threads.
      * \private
      */
-    sc_fifo<BGPMessage> m_ReceivingBuffer;
+    RingChannel<BGPMessage, MpscRing<BGPMessage> > m_ReceivingBuffer;
 
   /*! \brief Number of BGP sessions
    * \details This defines how many BGP sessions there are in this router
@@ -142,12 +311,223 @@ private:
    * \private
    */
     BGPSession **m_BGPSessions;
-    
-  /*! \brief BGP message
-   * \details 
+
+  /*! \brief The state of the BGP sessions in parallel arrays
+   * \details Shared with the session modules, which update it
+   * \private
+   */
+    SessionTable m_SessionTable;
+
+  /*! \brief The Loc-RIB
+   * \private
+   */
+    LocRib m_LocRib;
+
+  /*! \brief The Adj-RIB-In of each session
+   * \details Finds the duplicate UPDATEs and the implicit withdraws,
+   * and holds the candidates of the best-path selection
+   * \private
+   */
+    AdjRibIn* m_AdjRibIn;
+
+  /*! \brief Every change of the Loc-RIB and of the FIB replicas
+   * \private
+   */
+    RibJournal m_Journal;
+
+    AsyncFileWriter m_JournalFile;
+
+  /*! \brief Applies the NLRI of an UPDATE to the Loc-RIB and the FIB
+   * \details The UPDATE is first applied to the peer's Adj-RIB-In. A
+   * duplicate of the peer's route is dropped there, otherwise the
+   * best route of the prefix is selected again
+   * \private
+   */
+    void processUpdate(const BGPMessage& p_Msg);
+
+  /*! \brief Selects the best route of a prefix from the Adj-RIB-Ins
+   * into the Loc-RIB and the FIB
+   * \details The shortest AS path wins, then the lowest ORIGIN and
+   * then the lowest peer identifier. The prefix is removed if no peer
+   * announces it
+   * @param[in] uint64_t p_Key The packed masked prefix
+   * \private
+   */
+    void selectRoute(uint64_t p_Key);
+
+  /*! \brief True: if p_Route is preferred to p_Best
+   * \private
+   */
+    static bool isBetterRoute(const AdjRibRoute& p_Route, const AdjRibRoute* p_Best);
+
+  /*! \brief Journals the replacement of a table
+   * \details The removal of the old routes that are not in the new
+   * table and the new routes
+   * @param[in] vector<JournalRecord>& p_Old The old routes, sorted
+   * @param[in] vector<RouteEntry>& p_New The new routes, sorted
+   * \private
+   */
+    void journalReplacement(uint8_t p_Table, const vector<JournalRecord>& p_Old, const vector<RouteEntry>& p_New);
+
+  /*! \brief Forgets the routes of a session's previous peer
+   * \details Clears the Adj-RIB-In and selects the routes of its
+   * prefixes from the other peers
+   * \private
+   */
+    void clearAdjRibIn(int p_Session);
+
+  /*! \brief Programs the route changes collected into m_FIBBatch
+   * \private
+   */
+    void programFIBBatch(void);
+
+  /*! \brief Applies a batch of UPDATEs to the Loc-RIB and the FIB
+   * \details Without a FIB rate limit the changes of the batch are
+   * programmed together, only the last change of each prefix
+   * \private
+   */
+    void processUpdates(const vector<BGPMessage>& p_Msgs);
+
+  /*! \brief Handler of the messages of one type
+   * \private
+   */
+    typedef void (ControlPlane::*MessageHandler)(const vector<BGPMessage>& p_Batch);
+
+    struct MessageDispatch
+    {
+        BGPMessageType m_Type;
+
+        MessageHandler m_Handler;
+    };
+
+  /*! \brief The handlers in the order of the types' values
+   * \private
+   */
+    static const MessageDispatch s_Dispatch[BGP_MESSAGE_TYPES];
+
+public:
+
+  /*! \brief Checks at compile time that each type's handler is at the
+   * index of the type's value
+   * \public
+   */
+    static constexpr bool isDispatchOrdered(void)
+    {
+        for (int i = 0; i < BGP_MESSAGE_TYPES; ++i)
+            if (getDispatchIndex(s_Dispatch[i].m_Type) != i)
+                return false;
+        return true;
+    }
+
+  /*! \brief The index of a type's handler in s_Dispatch
+   * \details Out of the table's range for an unknown type
+   * \public
+   */
+    static constexpr int getDispatchIndex(BGPMessageType p_Type)
+    {
+        return (int)p_Type - (int)BGPMessageType::Open;
+    }
+
+private:
+
+  /*! \brief Starts the sessions of the OPENs of new peers
+   * \private
+   */
+    void handleOpens(const vector<BGPMessage>& p_Batch);
+
+    void handleUpdates(const vector<BGPMessage>& p_Batch);
+
+    void handleNotifications(const vector<BGPMessage>& p_Batch);
+
+    void handleKeepalives(const vector<BGPMessage>& p_Batch);
+
+  /*! \brief The batch taken from the work queue, a partition for each
+   * message type
+   * \private
+   */
+    vector<BGPMessage> m_Batch[BGP_MESSAGE_TYPES];
+
+  /*! \brief The UPDATEs of the batch from established sessions
+   * \private
+   */
+    vector<BGPMessage> m_Updates;
+
+  /*! \brief The FIB changes of a batch of UPDATEs without a rate limit
+   * \details A route with NO_ROUTE as the interface is removed
+   * \private
+   */
+    vector<RouteEntry> m_FIBBatch;
+
+  /*! \brief The index of each prefix's change in m_FIBBatch
+   * \private
+   */
+    unordered_map<uint64_t, size_t> m_FIBBatchIndex;
+
+  /*! \brief The router the RIB memory is charged to
+   * \private
+   */
+    int m_MemoryRouter;
+
+  /*! \brief Queues a route change for programFIB()
+   * \details Collected into m_FIBBatch if the rate is not limited
+   * @param[in] int p_OutboundInterface NO_ROUTE: the route is removed
+   * \private
+   */
+    void queueFIBChange(uint32_t p_Prefix, int p_Length, int p_OutboundInterface);
+
+  /*! \brief The processing cost of a message type
+   * \private
+   */
+    sc_time getMessageCost(BGPMessageType p_Type) const;
+
+    RouteProcessorParameters m_RPParameters;
+
+  /*! \brief The messages waiting for the route processor
+   * \private
+   */
+    deque<BGPMessage> m_WorkQueue;
+
+    sc_event m_WorkEvent;
+
+  /*! \brief The route changes waiting to be programmed
+   * \details A route with NO_ROUTE as the interface is removed
+   * \private
+   */
+    deque<RouteEntry> m_FIBQueue;
+
+    sc_event m_FIBEvent;
+
+    uint64_t m_MessagesProcessed;
+
+    uint64_t m_BatchesProcessed;
+
+    uint64_t m_DuplicateUpdates;
+
+  /*! \brief Number of announcements that replaced the peer's route
+   * \private
+   */
+    uint64_t m_ImplicitWithdraws;
+
+    uint64_t m_QueueDrops;
+
+    sc_time m_FirstQueueDrop;
+
+    size_t m_MaxQueueDepth;
+
+    uint64_t m_RoutesProgrammed;
+
+    size_t m_MaxFIBBacklog;
+
+  /*! \brief The time the route processor has spent on the messages
+   * \private
+   */
+    sc_time m_BusyTime;
+
+  /*! \brief The time the last route was programmed, the convergence
+   * time of the FIB
    * \private
    */
-    BGPMessage m_BGPMsg;
+    sc_time m_LastProgrammed;
 
 };
 
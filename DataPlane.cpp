@@ -9,7 +9,7 @@
 
 #include "DataPlane.hpp"
 
-DataPlane::DataPlane(sc_module_name p_ModuleName, int p_InterfaceCount):sc_module(p_ModuleName), m_InterfaceCount(p_InterfaceCount)
+DataPlane::DataPlane(sc_module_name p_ModuleName, int p_InterfaceCount, int p_FirstInterface, int p_LineCardId):sc_module(p_ModuleName), m_InterfaceCount(p_InterfaceCount), m_FirstInterface(p_FirstInterface), m_LineCardId(p_LineCardId), m_SessionMessageDrops(0), m_ControlPlaneDrops(0)
 {
     // Export the BGP message buffer interface
     //    export_ToDataPlane(m_BGPForwardingBuffer);
@@ -28,40 +28,153 @@ void DataPlane::main(void)
 {
 
   cout << name() << " starts processing at time" << sc_time_stamp() << endl;
-  int i = 0;
+
+  m_Replication.setFloodCount(port_ToFabric->getEgressCount());
+  m_Pipeline.getStage<PIPELINE_MULTICAST>().setReplicationTable(&m_Replication);
+  //the cache is coherent only if the route changes pass through it
+  if(m_FIBCache.getFIB() != NULL)
+    m_Pipeline.getStage<PIPELINE_FIB>().setFIB(&m_FIBCache);
+  else if(port_FIB.size() > 0)
+    m_Pipeline.getStage<PIPELINE_FIB>().setFIB(port_FIB[0]);
  
-  m_Packet.setProtocolType(0);
-  m_Packet.setIPPayload("1");
+  //the first line card seeds a packet to show that the connections work
+  if(m_FirstInterface == 0)
+    {
+      const unsigned char l_Seed[] = {1};
+
+      m_Packet.setProtocolType(IP_PROTOCOL);
+      m_Packet.setIPPayload(l_Seed, sizeof(l_Seed));
+      port_ToFabric->enqueue(m_LineCardId, 0, m_Packet);
+    }
+
+  //use the compile-time specialised scheduler for the common shapes
+  switch(m_InterfaceCount)
+    {
+    case 1: serveFixed<1>(); break;
+    case 2: serveFixed<2>(); break;
+    case 4: serveFixed<4>(); break;
+    case 8: serveFixed<8>(); break;
+    case 32: serveFixed<32>(); break;
+    default: serveDynamic(); break;
+    }
+}
+
+void DataPlane::serveDynamic(void)
+{
+  int l_Next = 0;
 
-  port_ToInterface[0]->write(m_Packet);
     while(true)
     {
       wait();
-      
-      if(port_FromInterface[i]->num_available() > 0)
+
+      forwardSessionMessage();
+
+      //serve the next interface with a packet in round robin order
+      for(int k = 0; k < m_InterfaceCount; k++)
           {
-              port_FromInterface[i]->read(m_Packet);
-              //              cout << name() << " received: " << m_Packet << ". At time: " << sc_time_stamp() << endl;
-              m_Packet.setProtocolType(m_Packet.getProtocolType()+1);
-              m_Packet.setIPPayload(m_Packet.getIPPayload() << 1);
-              //              cout << name() << " forwarding out from interface 0" << endl;
-              port_ToInterface[0]->write(m_Packet);
-              //              cout << name() << " forwarding out from interface 1" << endl;
-              port_ToInterface[1]->write(m_Packet);
-              
+              int l_Local = (l_Next + k) % m_InterfaceCount;
+              if(port_FromInterface[l_Local]->num_available() > 0)
+                  {
+                      processPacket(port_FromInterface[l_Local], l_Local);
+                      l_Next = (l_Local + 1) % m_InterfaceCount;
+                      break;
+                  }
           }
-      i++;
-      if(i == m_InterfaceCount-1)
-	i = 0;
+    }
+}
 
+void DataPlane::forwardSessionMessage(void)
+{
+  //send the BGP messages of the sessions to their peers
+  if(m_BGPForwardingBuffer.num_available() > 0)
+      {
+          m_BGPForwardingBuffer.read(m_BGPMsg);
+          Packet l_BGPPacket(m_BGPMsg, BGP_PROTOCOL);
+          port_ToFabric->enqueue(m_LineCardId, m_BGPMsg.m_OutboundInterface, l_BGPPacket);
+      }
+}
 
-    }
+void DataPlane::processPacket(sc_fifo_in_if<Packet> *p_Input, int p_LocalInterface)
+{
+  int l_Ingress = m_FirstInterface + p_LocalInterface;
+
+  p_Input->read(m_Packet);
+
+  PacketContext l_Context(m_Packet, l_Ingress);
+  m_Pipeline.apply(l_Context);
+
+  if(l_Context.m_ToControlPlane)
+      {
+          //pass the message to the control plane with the
+          //interface it was received from
+          m_BGPMsg = m_Packet.getBGPPayload();
+          m_BGPMsg.m_OutboundInterface = l_Ingress;
+          if(!port_ToControlPlane->nb_write(m_BGPMsg))
+            m_ControlPlaneDrops++;
+      }
+  else if(l_Context.m_Drop)
+      {
+          //dropped by the pipeline
+      }
+  else if(l_Context.m_Egresses)
+      replicate(*l_Context.m_Egresses, l_Ingress);
+  else if(l_Context.m_Egress == NO_ROUTE)
+      replicate(m_Replication.getFloodList(), l_Ingress);
+  else
+      port_ToFabric->enqueue(m_LineCardId, l_Context.m_Egress, m_Packet);
+}
+
+void DataPlane::replicate(const vector<int>& p_Egresses, int p_IngressInterface)
+{
+    for(size_t i = 0; i < p_Egresses.size(); i++)
+        if(p_Egresses[i] != p_IngressInterface)
+            port_ToFabric->enqueue(m_LineCardId, p_Egresses[i], m_Packet);
 }
 
 bool DataPlane::write(BGPMessage p_BGPMsg)
 {
-    m_BGPForwardingBufferMutex.lock();
-    m_BGPForwardingBuffer.write(p_BGPMsg);
-    m_BGPForwardingBufferMutex.unlock();
-    return true;
+    //the buffer is drained one message per clock cycle, and a writer
+    //may be a method, so a message that does not fit is dropped
+    if(m_BGPForwardingBuffer.nb_write(p_BGPMsg))
+      return true;
+    m_SessionMessageDrops++;
+    return false;
+}
+
+uint64_t DataPlane::getSessionMessageDrops(void) const
+{
+    return m_SessionMessageDrops;
+}
+
+uint64_t DataPlane::getControlPlaneDrops(void) const
+{
+    return m_ControlPlaneDrops;
+}
+
+void DataPlane::end_of_simulation()
+{
+  if(m_SessionMessageDrops > 0)
+    cout << name() << " session messages dropped: " << m_SessionMessageDrops << endl;
+  if(m_ControlPlaneDrops > 0)
+    cout << name() << " messages to the control plane dropped: " << m_ControlPlaneDrops << endl;
+}
+
+bool DataPlane::setMulticastGroup(uint32_t p_Group, const vector<int>& p_Egresses)
+{
+    return m_Replication.setGroup(p_Group, p_Egresses);
+}
+
+bool DataPlane::removeMulticastGroup(uint32_t p_Group)
+{
+    return m_Replication.removeGroup(p_Group);
+}
+
+ForwardingPipeline& DataPlane::getPipeline(void)
+{
+    return m_Pipeline;
+}
+
+FibCache& DataPlane::getFIBCache(void)
+{
+    return m_FIBCache;
 }
@@ -10,15 +10,40 @@
 /*!
  * \class DataPlane
  * \brief Protocol Engine module
- *  \details
+ *  \details The forwarding engine of one line card. It serves the
+ * receiving buffers of the line card's own interfaces in round robin
+ * order. BGP packets are passed to the Control Plane and IP packets
+ * are forwarded to the interface resolved from the line card's FIB
+ * replica. All the forwarded packets pass through the router's switch
+ * fabric, which queues them per (line card, egress interface) pair.
+ * Multicast packets and packets without a route are replicated to the
+ * egress list of their group or to every interface. The replicas share
+ * the payload of the received packet.
+ *
+ * The forwarding decision is made by the ForwardingPipeline: a parser
+ * followed by an ACL, the multicast group lookup and the FIB lookup.
+ * New forwarding behaviours are prototyped by changing the pipeline
+ * type, the engine only acts on the decision left in the context.
+ *
+ * On every clock cycle the engine serves the next interface that has
+ * a packet waiting, in round robin order. For 1, 2, 4, 8 and 32
+ * interfaces the scheduler is a template specialised for the count:
+ * the receiving buffer interfaces are kept in a std::array and the
+ * scan over them is unrolled at compile time.
  */
 
 
 
 #include "systemc"
+#include <array>
 #include "Packet.hpp"
 #include "BGPMessage.hpp"
 #include "DataPlane_In_If.hpp"
+#include "RoutingTable_Manage_If.hpp"
+#include "FibCache.hpp"
+#include "Fabric_In_If.hpp"
+#include "ReplicationTable.hpp"
+#include "Pipeline.hpp"
 
 using namespace std;
 using namespace sc_core;
@@ -28,6 +53,34 @@ using namespace sc_dt;
 #define _DATAPLANE_H_
 
 
+/*! \def PIPELINE_PARSER
+ *  \brief Stage index of the parser in the forwarding pipeline
+ */
+#define PIPELINE_PARSER 0
+
+/*! \def PIPELINE_ACL
+ *  \brief Stage index of the destination ACL, a ternary table
+ */
+#define PIPELINE_ACL 1
+
+/*! \def PIPELINE_MULTICAST
+ *  \brief Stage index of the multicast group lookup
+ */
+#define PIPELINE_MULTICAST 2
+
+/*! \def PIPELINE_FIB
+ *  \brief Stage index of the FIB lookup
+ */
+#define PIPELINE_FIB 3
+
+/*! \brief The forwarding pipeline of the engine
+ */
+typedef Pipeline<Parser<ParseProtocol, ParseIPv4>,
+                 TernaryMatchTable<DestinationKey, DropAction>,
+                 MulticastLookup,
+                 FIBLookup> ForwardingPipeline;
+
+
 
 
 class DataPlane: public sc_module, public DataPlane_In_If
@@ -50,19 +103,28 @@ public:
      * receiving FIFO
      * \public
      */
-    sc_port<sc_fifo_in_if<BGPMessage>,1, SC_ZERO_OR_MORE_BOUND> port_ToControlPlane;
+    sc_port<sc_fifo_out_if<BGPMessage>,1, SC_ZERO_OR_MORE_BOUND> port_ToControlPlane;
+
+    /*! \brief Route resolution port
+     * \details Bound to the FIB replica of the line card. Used
+     * directly when the FIB cache has not been given the FIB
+     * \public
+     */
+    sc_port<RoutingTable_Manage_If,1, SC_ZERO_OR_MORE_BOUND> port_FIB;
 
     /*! \brief Neighbor writes to the receiving buffer
-     * \details
+     * \details Bound to the receiving buffers of the line card's own
+     * interfaces
      * \public
      */
     sc_port<sc_fifo_in_if<Packet>,0, SC_ZERO_OR_MORE_BOUND> port_FromInterface;
 
     /*! \brief Forward to the neighbor
-     * \details
+     * \details Bound to the router's switch fabric, which delivers
+     * the packets to the forwarding buffers of the egress interfaces
      * \public
      */
-    sc_port<sc_fifo_out_if<Packet>,0, SC_ZERO_OR_MORE_BOUND> port_ToInterface;
+    sc_port<Fabric_In_If,1, SC_ZERO_OR_MORE_BOUND> port_ToFabric;
 
     /*! \brief Clock signal
      * \details 
@@ -72,19 +134,70 @@ public:
 
     /*!
      * \brief Constructor
-     * \details Builds the router
+     * \details Builds the forwarding engine
      * @param[in] p_Name The name of the module
+     * @param[in] int p_InterfaceCount The number of the line card's
+     * own interfaces
+     * @param[in] int p_FirstInterface The router level index of the
+     * line card's first interface
+     * @param[in] int p_LineCardId The index of the line card, used as
+     * the ingress index of the fabric
      * \public
      */
-    DataPlane(sc_module_name p_ModuleName, int p_InterfaceCount);
+    DataPlane(sc_module_name p_ModuleName, int p_InterfaceCount, int p_FirstInterface = 0, int p_LineCardId = 0);
 
     ~DataPlane();
 
     void main(void);
 
 
+    /*! \brief Queues a BGP message of the sessions to its peer
+     * \details Never blocks: a message that does not fit in the
+     * buffer is dropped and counted
+     * \return <bool> False: if the message was dropped
+     * \public
+     */
     virtual bool write(BGPMessage p_BGPMsg);
 
+    /*! \brief Number of session messages dropped as the buffer was
+     * full
+     * \public
+     */
+    uint64_t getSessionMessageDrops(void) const;
+
+    /*! \brief Number of received BGP messages dropped as the Control
+     * Plane's input was full
+     * \public
+     */
+    uint64_t getControlPlaneDrops(void) const;
+
+    void end_of_simulation();
+
+    /*! \brief Sets the egress interface list of a multicast group
+     * @param[in] uint32_t p_Group The multicast group address
+     * @param[in] vector<int>& p_Egresses The egress interface indices
+     * \return <bool> True: if p_Group is a multicast address
+     * \public
+     */
+    bool setMulticastGroup(uint32_t p_Group, const vector<int>& p_Egresses);
+
+    /*! \brief Removes a multicast group
+     * \public
+     */
+    bool removeMulticastGroup(uint32_t p_Group);
+
+    /*! \brief Access to the forwarding pipeline for managing its tables
+     * \public
+     */
+    ForwardingPipeline& getPipeline(void);
+
+    /*! \brief The cache of the hot destinations
+     * \details Takes the route changes in front of the FIB, see
+     * FibCache::setFIB()
+     * \public
+     */
+    FibCache& getFIBCache(void);
+
     /*! \brief Indicate the systemC producer that this module has a process.
      * \sa http://www.iro.umontreal.ca/~lablasso/docs/SystemC2.0.1/html/classproducer.html
      * \public
@@ -93,16 +206,134 @@ public:
 
 private:
 
-    sc_mutex m_BGPForwardingBufferMutex;
-
     sc_fifo<BGPMessage> m_BGPForwardingBuffer;
 
+    /*! \brief Scheduler loop for any number of interfaces
+     * \private
+     */
+    void serveDynamic(void);
+
+    /*! \brief Scheduler loop specialised for N interfaces
+     * \details N shall be a power of two
+     * \private
+     */
+    template <int N>
+    void serveFixed(void);
+
+    /*! \brief Finds the next interface with a packet waiting
+     * \details The scan starting from p_Next is unrolled by the
+     * template recursion
+     * \return <int> The local interface index or -1 if all are empty
+     * \private
+     */
+    template <int K, int N>
+    struct FindReady
+    {
+        static int find(const array<sc_fifo_in_if<Packet>*, N>& p_Inputs, int p_Next)
+        {
+            int l_Local = (p_Next + K) & (N - 1);
+            if (p_Inputs[l_Local]->num_available() > 0)
+                return l_Local;
+            return FindReady<K + 1, N>::find(p_Inputs, p_Next);
+        }
+    };
+
+    template <int N>
+    struct FindReady<N, N>
+    {
+        static int find(const array<sc_fifo_in_if<Packet>*, N>& p_Inputs, int p_Next)
+        {
+            return -1;
+        }
+    };
+
+    /*! \brief Sends one BGP message of the sessions to the fabric
+     * \private
+     */
+    void forwardSessionMessage(void);
+
+    /*! \brief Reads a packet from the receiving buffer and forwards it
+     * @param[in] sc_fifo_in_if<Packet>* p_Input The receiving buffer
+     * @param[in] int p_LocalInterface The line card level index of
+     * the receiving interface
+     * \private
+     */
+    void processPacket(sc_fifo_in_if<Packet> *p_Input, int p_LocalInterface);
+
+    /*! \brief Queues a replica of m_Packet to each interface of
+     * the list except the ingress
+     * \details The replicas are packet descriptors that share the
+     * payload of m_Packet
+     * \private
+     */
+    void replicate(const vector<int>& p_Egresses, int p_IngressInterface);
+
+    /*! \brief The multicast groups and the flood list
+     * \private
+     */
+    ReplicationTable m_Replication;
+
+    /*! \brief Makes the forwarding decisions
+     * \private
+     */
+    ForwardingPipeline m_Pipeline;
+
+    /*! \brief The fast path of the FIB lookups
+     * \private
+     */
+    FibCache m_FIBCache;
+
+    /*! \brief Number of the line card's own interfaces
+     * \private
+     */
     int m_InterfaceCount;
+
+    /*! \brief Router level index of the line card's first interface
+     * \private
+     */
+    int m_FirstInterface;
+
+    /*! \brief Ingress index of the line card in the fabric
+     * \private
+     */
+    int m_LineCardId;
+
+    uint64_t m_SessionMessageDrops;
+
+    uint64_t m_ControlPlaneDrops;
   
     Packet m_Packet;
 
+    BGPMessage m_BGPMsg;
+
 };
 
 
+template <int N>
+void DataPlane::serveFixed(void)
+{
+    array<sc_fifo_in_if<Packet>*, N> l_Inputs;
+    int l_Next = 0;
+
+    //resolve the ports once
+    for (int i = 0; i < N; ++i)
+        l_Inputs[i] = port_FromInterface[i];
+
+    while(true)
+        {
+            wait();
+
+            forwardSessionMessage();
+
+            int l_Local = FindReady<0, N>::find(l_Inputs, l_Next);
+            if (l_Local != -1)
+                {
+                    processPacket(l_Inputs[l_Local], l_Local);
+                    l_Next = (l_Local + 1) & (N - 1);
+                }
+        }
+}
+
+
 #endif /* _DATAPLANE_H_ */
 
@@ -0,0 +1,56 @@
+/*! \file  Fabric_In_If.hpp
+ *  \brief
+ *  \details
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 12:21:07 2026
+ */
+
+/*!
+ * \class Fabric_In_If
+ * \brief Ingress interface of the switch fabric
+ *  \details The forwarding engines of the line cards pass the
+ * forwarded packets to the fabric through this interface.
+ */
+
+
+#include "systemc"
+#include "Packet.hpp"
+
+using namespace std;
+using namespace sc_core;
+using namespace sc_dt;
+
+#ifndef _FABRIC_IN_IF_H_
+#define _FABRIC_IN_IF_H_
+
+
+
+
+class Fabric_In_If: virtual public sc_interface
+{
+
+public:
+
+  /*! \brief Queues a packet to the virtual output queue of the
+   * (ingress, egress) pair
+   * \details
+   * @param[in] int p_Ingress The index of the ingress line card
+   * @param[in] int p_Egress The index of the egress interface
+   * @param[in] Packet& p_Packet The packet to be switched
+   * \return bool True: if the packet was queued, False: if the queue
+   * is full and the packet was dropped
+   * \public
+   */
+  virtual bool enqueue(int p_Ingress, int p_Egress, const Packet& p_Packet) = 0;
+
+  /*! \brief Number of egress interfaces of the fabric
+   * \public
+   */
+  virtual int getEgressCount(void) = 0;
+
+
+};
+
+
+#endif /* _FABRIC_IN_IF_H_ */
@@ -0,0 +1,257 @@
+/*! \file FibCache.cpp
+ *  \brief     Implementation of the forwarding cache.
+ *  \details
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 18:41:12 2026
+ */
+
+
+#include "FibCache.hpp"
+
+
+FibCache::FibCache(RoutingTable_Manage_If* p_FIB):m_FIB(p_FIB), m_Entries(FIB_CACHE_SIZE), m_Candidates(FIB_CACHE_SIZE), m_Hits(0), m_Misses(0), m_Promotions(0)
+{
+    flush();
+}
+
+FibCache::~FibCache()
+{
+}
+
+
+void FibCache::setFIB(RoutingTable_Manage_If* p_FIB)
+{
+    m_FIB = p_FIB;
+    flush();
+}
+
+RoutingTable_Manage_If* FibCache::getFIB(void) const
+{
+    return m_FIB;
+}
+
+bool FibCache::setRoute(uint32_t p_Prefix, int p_Length, int p_OutboundInterface)
+{
+    if (!m_FIB->setRoute(p_Prefix, p_Length, p_OutboundInterface))
+        return false;
+    invalidate(p_Prefix, p_Length);
+    return true;
+}
+
+bool FibCache::updateRoute(uint32_t p_Prefix, int p_Length, int p_OutboundInterface)
+{
+    if (!m_FIB->updateRoute(p_Prefix, p_Length, p_OutboundInterface))
+        return false;
+    invalidate(p_Prefix, p_Length);
+    return true;
+}
+
+bool FibCache::removeRoute(uint32_t p_Prefix, int p_Length)
+{
+    if (!m_FIB->removeRoute(p_Prefix, p_Length))
+        return false;
+    invalidate(p_Prefix, p_Length);
+    return true;
+}
+
+bool FibCache::setRoutes(const vector<RouteEntry>& p_Routes)
+{
+    if (!m_FIB->setRoutes(p_Routes))
+        return false;
+
+    //stops early once the batch has dropped every entry
+    for (size_t i = 0; i < p_Routes.size() && m_Lengths != 0; ++i)
+        invalidate(p_Routes[i].m_Prefix, p_Routes[i].m_Length);
+    return true;
+}
+
+bool FibCache::replaceAll(const RouteEntry* p_Begin, const RouteEntry* p_End)
+{
+    bool l_Success = m_FIB->replaceAll(p_Begin, p_End);
+
+    flush();
+    return l_Success;
+}
+
+void FibCache::getRoutes(vector<RouteEntry>& p_Routes) const
+{
+    m_FIB->getRoutes(p_Routes);
+}
+
+int FibCache::resolveRoute(uint32_t p_IPAddress)
+{
+    int l_Entry;
+
+    return resolveRoute(p_IPAddress, l_Entry);
+}
+
+int FibCache::resolveRoute(uint32_t p_IPAddress, int& p_Entry)
+{
+    //the entries do not overlap, so the first hit is the answer
+    for (uint64_t l_Lengths = m_Lengths; l_Lengths != 0; l_Lengths &= l_Lengths - 1)
+        {
+            int l_Length = __builtin_ctzll(l_Lengths);
+            uint32_t l_Prefix = maskPrefix(p_IPAddress, l_Length);
+            Entry* l_Set = &m_Entries[hash(l_Prefix, l_Length)];
+
+            for (int i = 0; i < FIB_CACHE_WAYS; ++i)
+                if (l_Set[i].m_Length == l_Length && l_Set[i].m_Prefix == l_Prefix)
+                    {
+                        l_Set[i].m_Hits++;
+                        m_Hits++;
+                        p_Entry = l_Set[i].m_Entry;
+                        return l_Set[i].m_OutboundInterface;
+                    }
+        }
+
+    int l_Length;
+    int l_Interface = m_FIB->resolveRoute(p_IPAddress, l_Length, p_Entry);
+
+    m_Misses++;
+    miss(maskPrefix(p_IPAddress, l_Length), l_Length, l_Interface, p_Entry);
+    return l_Interface;
+}
+
+int FibCache::resolveRoute(uint32_t p_IPAddress, int& p_Length, int& p_Entry)
+{
+    return m_FIB->resolveRoute(p_IPAddress, p_Length, p_Entry);
+}
+
+void FibCache::countTraffic(int p_Entry, uint32_t p_Bytes)
+{
+    m_FIB->countTraffic(p_Entry, p_Bytes);
+}
+
+void FibCache::flush(void)
+{
+    for (size_t i = 0; i < m_Entries.size(); ++i)
+        {
+            m_Entries[i].m_Length = -1;
+            m_Entries[i].m_Hits = 0;
+        }
+    for (size_t i = 0; i < m_Candidates.size(); ++i)
+        {
+            m_Candidates[i].m_Key = 0;
+            m_Candidates[i].m_Misses = 0;
+        }
+    m_Lengths = 0;
+    for (int i = 0; i <= 32; ++i)
+        m_LengthCount[i] = 0;
+}
+
+uint64_t FibCache::getHits(void) const
+{
+    return m_Hits;
+}
+
+uint64_t FibCache::getMisses(void) const
+{
+    return m_Misses;
+}
+
+uint64_t FibCache::getPromotions(void) const
+{
+    return m_Promotions;
+}
+
+
+uint32_t FibCache::hash(uint32_t p_Prefix, int p_Length)
+{
+    uint32_t l_Hash = (p_Prefix ^ ((uint32_t)p_Length * 0x9E3779B9u)) * 0x85EBCA6Bu;
+
+    //the index of the first entry of the set
+    return (l_Hash >> 16) & (FIB_CACHE_SIZE - FIB_CACHE_WAYS);
+}
+
+void FibCache::miss(uint32_t p_Prefix, int p_Length, int p_OutboundInterface, int p_Entry)
+{
+    uint64_t l_Key = packPrefix(p_Prefix, p_Length);
+    Candidate& l_Candidate = m_Candidates[hash(p_Prefix, p_Length) | (p_Prefix & (FIB_CACHE_WAYS - 1))];
+
+    if (l_Candidate.m_Key != l_Key)
+        {
+            l_Candidate.m_Key = l_Key;
+            l_Candidate.m_Misses = 0;
+        }
+    if (++l_Candidate.m_Misses < FIB_CACHE_PROMOTE_MISSES)
+        return;
+    l_Candidate.m_Misses = 0;
+
+    //replace the empty or the least hit entry of the set and age the rest
+    Entry* l_Set = &m_Entries[hash(p_Prefix, p_Length)];
+    Entry* l_Victim = &l_Set[0];
+
+    for (int i = 0; i < FIB_CACHE_WAYS; ++i)
+        {
+            if (l_Set[i].m_Length < 0)
+                {
+                    l_Victim = &l_Set[i];
+                    break;
+                }
+            if (l_Set[i].m_Hits < l_Victim->m_Hits)
+                l_Victim = &l_Set[i];
+        }
+    for (int i = 0; i < FIB_CACHE_WAYS; ++i)
+        l_Set[i].m_Hits >>= 1;
+
+    drop(*l_Victim);
+    l_Victim->m_Prefix = p_Prefix;
+    l_Victim->m_Length = p_Length;
+    l_Victim->m_OutboundInterface = p_OutboundInterface;
+    l_Victim->m_Entry = p_Entry;
+    l_Victim->m_Hits = 0;
+    if (m_LengthCount[p_Length]++ == 0)
+        m_Lengths |= (uint64_t)1 << p_Length;
+    m_Promotions++;
+}
+
+void FibCache::invalidate(uint32_t p_Prefix, int p_Length)
+{
+    uint32_t l_Prefix = maskPrefix(p_Prefix, p_Length);
+    uint64_t l_Probes = 0;
+
+    //an entry overlaps the prefix if they agree on the shorter length:
+    //of a length up to the prefix's only the one covering it, of a
+    //longer length L the 2^(L - p_Length) ones below it
+    for (uint64_t l_Lengths = m_Lengths; l_Lengths != 0; l_Lengths &= l_Lengths - 1)
+        {
+            int l_Length = __builtin_ctzll(l_Lengths);
+            l_Probes += l_Length > p_Length ? (uint64_t)1 << (l_Length - p_Length) : 1;
+        }
+
+    //a wide prefix may hold more entries than the table, scan it then
+    if (l_Probes > FIB_CACHE_SIZE / FIB_CACHE_WAYS)
+        {
+            for (size_t i = 0; i < m_Entries.size(); ++i)
+                if (m_Entries[i].m_Length >= 0 && maskPrefix(m_Entries[i].m_Prefix ^ l_Prefix, min(m_Entries[i].m_Length, p_Length)) == 0)
+                    drop(m_Entries[i]);
+            return;
+        }
+
+    for (uint64_t l_Lengths = m_Lengths; l_Lengths != 0; l_Lengths &= l_Lengths - 1)
+        {
+            int l_Length = __builtin_ctzll(l_Lengths);
+            uint32_t l_First = maskPrefix(l_Prefix, l_Length);
+            uint32_t l_Count = l_Length > p_Length ? 1u << (l_Length - p_Length) : 1;
+
+            for (uint32_t n = 0; n < l_Count; ++n)
+                {
+                    uint32_t l_Entry = n == 0 ? l_First : l_First | (n << (32 - l_Length));
+                    Entry* l_Set = &m_Entries[hash(l_Entry, l_Length)];
+
+                    for (int i = 0; i < FIB_CACHE_WAYS; ++i)
+                        if (l_Set[i].m_Length == l_Length && l_Set[i].m_Prefix == l_Entry)
+                            drop(l_Set[i]);
+                }
+        }
+}
+
+void FibCache::drop(Entry& p_Entry)
+{
+    if (p_Entry.m_Length < 0)
+        return;
+    if (--m_LengthCount[p_Entry.m_Length] == 0)
+        m_Lengths &= ~((uint64_t)1 << p_Entry.m_Length);
+    p_Entry.m_Length = -1;
+}
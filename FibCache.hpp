@@ -0,0 +1,189 @@
+/*! \file  FibCache.hpp
+ *  \brief     Header file of the forwarding cache of a DataPlane
+ *  \details
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 18:41:12 2026
+ */
+
+/*!
+ * \class FibCache
+ * \brief Small fast table of the destinations that carry traffic
+ *  \details The cache sits in front of a FIB and holds the results of
+ * the lookups of the hot destinations. A cached entry is not a route of
+ * the FIB but the widest prefix of the looked up address in which
+ * every address resolves alike, as told by the FIB's two-argument
+ * resolveRoute(). The entries therefore never overlap and never hide a
+ * more specific route, so a hit is always the longest prefix match.
+ *
+ * The entries are kept in a set associative table of FIB_CACHE_SIZE
+ * entries, small enough to stay in the L1 and L2 caches. A lookup
+ * probes the table once for each prefix length present in it. A
+ * missed prefix is counted in a candidate table and promoted into the
+ * cache on its FIB_CACHE_PROMOTE_MISSES:th miss, replacing the entry
+ * of its set with the fewest hits.
+ *
+ * The route changes shall be made through the cache, which passes
+ * them to the FIB and drops the entries they overlap, also for each
+ * route of a batch. The overlapped entries are probed by their set for
+ * each cached prefix length, so a change costs a few probes rather than
+ * a pass over the table. A full load drops every entry.
+ *
+ * A cached entry also holds the FIB entry of its destinations, so the
+ * traffic of a hit is counted to the same route as the one of a miss.
+ */
+
+
+#include "systemc"
+#include <vector>
+#include <stdint.h>
+#include "RoutingTable_Manage_If.hpp"
+#include "HugePageArena.hpp"
+
+
+using namespace std;
+using namespace sc_core;
+using namespace sc_dt;
+
+#ifndef _FIBCACHE_H_
+#define _FIBCACHE_H_
+
+
+/*! \def FIB_CACHE_SIZE
+ *  \brief Defines the number of entries in the cache, a power of two
+ */
+#define FIB_CACHE_SIZE 4096
+
+/*! \def FIB_CACHE_WAYS
+ *  \brief Defines the number of entries in a set of the cache
+ */
+#define FIB_CACHE_WAYS 4
+
+/*! \def FIB_CACHE_PROMOTE_MISSES
+ *  \brief Defines the number of misses that promote a prefix
+ */
+#define FIB_CACHE_PROMOTE_MISSES 2
+
+
+
+class FibCache: public RoutingTable_Manage_If
+{
+
+public:
+
+    /*! \brief Builds an empty cache
+     * @param[in] RoutingTable_Manage_If* p_FIB The FIB behind the cache
+     * \public
+     */
+    FibCache(RoutingTable_Manage_If* p_FIB = NULL);
+
+    ~FibCache();
+
+    /*! \brief Sets the FIB behind the cache and drops every entry
+     * \public
+     */
+    void setFIB(RoutingTable_Manage_If* p_FIB);
+
+    RoutingTable_Manage_If* getFIB(void) const;
+
+    virtual bool setRoute(uint32_t p_Prefix, int p_Length, int p_OutboundInterface);
+
+    virtual bool updateRoute(uint32_t p_Prefix, int p_Length, int p_OutboundInterface);
+
+    virtual bool removeRoute(uint32_t p_Prefix, int p_Length);
+
+    virtual bool setRoutes(const vector<RouteEntry>& p_Routes);
+
+    virtual bool replaceAll(const RouteEntry* p_Begin, const RouteEntry* p_End);
+
+    virtual void getRoutes(vector<RouteEntry>& p_Routes) const;
+
+    /*! \brief Resolves from the cache, or from the FIB on a miss
+     * \public
+     */
+    virtual int resolveRoute(uint32_t p_IPAddress);
+
+    virtual int resolveRoute(uint32_t p_IPAddress, int& p_Entry);
+
+    virtual int resolveRoute(uint32_t p_IPAddress, int& p_Length, int& p_Entry);
+
+    virtual void countTraffic(int p_Entry, uint32_t p_Bytes);
+
+    /*! \brief Drops every entry
+     * \public
+     */
+    void flush(void);
+
+    uint64_t getHits(void) const;
+
+    uint64_t getMisses(void) const;
+
+    uint64_t getPromotions(void) const;
+
+private:
+
+    struct Entry
+    {
+        uint32_t m_Prefix;
+
+        /*! \brief -1: the entry is empty
+         */
+        int m_Length;
+
+        int m_OutboundInterface;
+
+        /*! \brief The FIB entry of the destinations
+         */
+        int m_Entry;
+
+        uint32_t m_Hits;
+    };
+
+    struct Candidate
+    {
+        uint64_t m_Key;
+
+        uint32_t m_Misses;
+    };
+
+    static uint32_t hash(uint32_t p_Prefix, int p_Length);
+
+    /*! \brief Counts the miss and promotes the prefix when it is due
+     * \private
+     */
+    void miss(uint32_t p_Prefix, int p_Length, int p_OutboundInterface, int p_Entry);
+
+    /*! \brief Drops the entries that overlap the prefix
+     * \details Probes the sets of the overlapping prefixes, or scans
+     * the table when the prefix is too wide for that to be cheaper
+     * \private
+     */
+    void invalidate(uint32_t p_Prefix, int p_Length);
+
+    void drop(Entry& p_Entry);
+
+    RoutingTable_Manage_If* m_FIB;
+
+    vector<Entry, HugePageAllocator<Entry, MEMORY_FIB> > m_Entries;
+
+    vector<Candidate, HugePageAllocator<Candidate, MEMORY_FIB> > m_Candidates;
+
+    /*! \brief Bit n set: the cache holds prefixes of length n
+     * \private
+     */
+    uint64_t m_Lengths;
+
+    /*! \brief The number of entries of each prefix length
+     * \private
+     */
+    int m_LengthCount[33];
+
+    uint64_t m_Hits;
+
+    uint64_t m_Misses;
+
+    uint64_t m_Promotions;
+};
+
+
+#endif /* _FIBCACHE_H_ */
@@ -0,0 +1,407 @@
+/*! \file FibCompressor.cpp
+ *  \brief     Implementation of the FIB compression stage.
+ *  \details
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 18:05:40 2026
+ */
+
+
+#include "FibCompressor.hpp"
+#include <algorithm>
+
+
+FibCompressor::FibCompressor(RoutingTable_Manage_If* p_FIB):m_FIB(p_FIB), m_CountTraffic(false), m_RouteCount(0), m_InstalledCount(0)
+{
+    //allocate the root node
+    allocateNode();
+}
+
+FibCompressor::~FibCompressor()
+{
+}
+
+
+bool FibCompressor::setRoute(uint32_t p_Prefix, int p_Length, int p_OutboundInterface)
+{
+    if (!isValidLength(p_Length) || p_OutboundInterface == NO_ROUTE)
+        return false;
+
+    int l_Covering;
+    uint32_t l_Prefix = maskPrefix(p_Prefix, p_Length);
+    int l_Node = findNode(l_Prefix, p_Length, true, l_Covering);
+    int l_Old = m_Nodes[l_Node].m_OutboundInterface;
+
+    if (l_Old == p_OutboundInterface)
+        return true;
+    if (l_Old == NO_ROUTE)
+        m_RouteCount++;
+
+    m_Nodes[l_Node].m_OutboundInterface = p_OutboundInterface;
+    sync(l_Node, l_Prefix, p_Length, l_Covering, true);
+    syncBelow(l_Node, l_Prefix, p_Length, p_OutboundInterface);
+    return true;
+}
+
+bool FibCompressor::updateRoute(uint32_t p_Prefix, int p_Length, int p_OutboundInterface)
+{
+    if (!isValidLength(p_Length))
+        return false;
+
+    int l_Covering;
+    int l_Node = findNode(maskPrefix(p_Prefix, p_Length), p_Length, false, l_Covering);
+
+    if (l_Node == 0 && p_Length > 0)
+        return false;
+    if (m_Nodes[l_Node].m_OutboundInterface == NO_ROUTE)
+        return false;
+    return setRoute(p_Prefix, p_Length, p_OutboundInterface);
+}
+
+bool FibCompressor::removeRoute(uint32_t p_Prefix, int p_Length)
+{
+    if (!isValidLength(p_Length))
+        return false;
+
+    uint32_t l_Prefix = maskPrefix(p_Prefix, p_Length);
+    int l_Path[33];
+    int l_Node = 0;
+    int l_Covering = NO_ROUTE;
+
+    //walk down and remember the path for pruning
+    l_Path[0] = 0;
+    for (int i = 0; i < p_Length; ++i)
+        {
+            if (m_Nodes[l_Node].m_OutboundInterface != NO_ROUTE)
+                l_Covering = m_Nodes[l_Node].m_OutboundInterface;
+            l_Node = m_Nodes[l_Node].m_Child[(l_Prefix >> (31 - i)) & 1];
+            if (l_Node == 0)
+                return false;
+            l_Path[i + 1] = l_Node;
+        }
+
+    if (m_Nodes[l_Node].m_OutboundInterface == NO_ROUTE)
+        return false;
+
+    if (m_Nodes[l_Node].m_Installed)
+        {
+            m_FIB->removeRoute(l_Prefix, p_Length);
+            m_Nodes[l_Node].m_Installed = false;
+            m_InstalledCount--;
+        }
+    m_Nodes[l_Node].m_OutboundInterface = NO_ROUTE;
+    m_RouteCount--;
+    if (m_CountTraffic)
+        m_Counters[l_Node].m_Packets = m_Counters[l_Node].m_Bytes = 0;
+
+    //the routes below are now covered by the route above
+    syncBelow(l_Node, l_Prefix, p_Length, l_Covering);
+
+    //release the nodes that do not lead to any route anymore
+    for (int i = p_Length; i > 0; --i)
+        {
+            Node& l_Current = m_Nodes[l_Path[i]];
+            if (l_Current.m_OutboundInterface != NO_ROUTE || l_Current.m_Child[0] || l_Current.m_Child[1])
+                break;
+            m_Nodes[l_Path[i - 1]].m_Child[(l_Prefix >> (32 - i)) & 1] = 0;
+            m_FreeNodes.push_back(l_Path[i]);
+        }
+    return true;
+}
+
+bool FibCompressor::setRoutes(const vector<RouteEntry>& p_Routes)
+{
+    for (size_t i = 0; i < p_Routes.size(); ++i)
+        if (!isValidLength(p_Routes[i].m_Length) || p_Routes[i].m_OutboundInterface == NO_ROUTE)
+            return false;
+
+    for (size_t i = 0; i < p_Routes.size(); ++i)
+        setRoute(p_Routes[i].m_Prefix, p_Routes[i].m_Length, p_Routes[i].m_OutboundInterface);
+    return true;
+}
+
+bool FibCompressor::replaceAll(const RouteEntry* p_Begin, const RouteEntry* p_End)
+{
+    for (const RouteEntry* l_Route = p_Begin; l_Route != p_End; ++l_Route)
+        {
+            if (!isValidLength(l_Route->m_Length) || l_Route->m_OutboundInterface == NO_ROUTE)
+                return false;
+            if (l_Route != p_Begin && routeLess(*l_Route, *(l_Route - 1)))
+                return false;
+        }
+
+    m_Nodes.clear();
+    m_FreeNodes.clear();
+    m_Counters.clear();
+    m_RouteCount = 0;
+    allocateNode();
+
+    //build the trie in one pass as RoutingTable does
+    int l_Path[33];
+    uint32_t l_Previous = 0;
+    int l_Depth = 0;
+
+    l_Path[0] = 0;
+    for (const RouteEntry* l_Route = p_Begin; l_Route != p_End; ++l_Route)
+        {
+            uint32_t l_Prefix = maskPrefix(l_Route->m_Prefix, l_Route->m_Length);
+            uint32_t l_Differ = l_Prefix ^ l_Previous;
+            int l_Shared = l_Differ == 0 ? 32 : __builtin_clz(l_Differ);
+            int i = min(l_Depth, min(l_Shared, l_Route->m_Length));
+
+            for (; i < l_Route->m_Length; ++i)
+                {
+                    int l_Bit = (l_Prefix >> (31 - i)) & 1;
+                    int l_Next = m_Nodes[l_Path[i]].m_Child[l_Bit];
+                    if (l_Next == 0)
+                        {
+                            l_Next = allocateNode();
+                            m_Nodes[l_Path[i]].m_Child[l_Bit] = l_Next;
+                        }
+                    l_Path[i + 1] = l_Next;
+                }
+
+            Node& l_Node = m_Nodes[l_Path[l_Route->m_Length]];
+            if (l_Node.m_OutboundInterface == NO_ROUTE)
+                m_RouteCount++;
+            l_Node.m_OutboundInterface = l_Route->m_OutboundInterface;
+
+            l_Previous = l_Prefix;
+            l_Depth = l_Route->m_Length;
+        }
+
+    //the pre-order walk gives the compressed routes sorted
+    vector<RouteEntry> l_Routes;
+    collect(0, 0, 0, NO_ROUTE, l_Routes);
+    m_InstalledCount = (int)l_Routes.size();
+    return m_FIB->replaceAll(l_Routes.data(), l_Routes.data() + l_Routes.size());
+}
+
+void FibCompressor::getRoutes(vector<RouteEntry>& p_Routes) const
+{
+    collectAll(0, 0, 0, p_Routes);
+}
+
+int FibCompressor::resolveRoute(uint32_t p_IPAddress)
+{
+    return m_FIB->resolveRoute(p_IPAddress);
+}
+
+int FibCompressor::resolveRoute(uint32_t p_IPAddress, int& p_Entry)
+{
+    int l_Length;
+
+    return resolveRoute(p_IPAddress, l_Length, p_Entry);
+}
+
+int FibCompressor::resolveRoute(uint32_t p_IPAddress, int& p_Length, int& p_Entry)
+{
+    unsigned l_Address = p_IPAddress;
+    int l_Node = 0;
+
+    //no route lies below the first missing branch
+    p_Length = 32;
+    p_Entry = m_Nodes[0].m_OutboundInterface == NO_ROUTE ? NO_ROUTE : 0;
+    for (int i = 0; i < 32; ++i)
+        {
+            l_Node = m_Nodes[l_Node].m_Child[(l_Address >> (31 - i)) & 1];
+            if (l_Node == 0)
+                {
+                    p_Length = i + 1;
+                    break;
+                }
+            if (m_Nodes[l_Node].m_OutboundInterface != NO_ROUTE)
+                p_Entry = l_Node;
+        }
+    return p_Entry == NO_ROUTE ? NO_ROUTE : m_Nodes[p_Entry].m_OutboundInterface;
+}
+
+void FibCompressor::countTraffic(int p_Entry, uint32_t p_Bytes)
+{
+    if (!m_CountTraffic || p_Entry < 0)
+        return;
+    m_Counters[p_Entry].m_Packets++;
+    m_Counters[p_Entry].m_Bytes += p_Bytes;
+}
+
+void FibCompressor::enableTrafficCounters(bool p_Enable)
+{
+    Counter l_Zero = {0, 0};
+
+    m_CountTraffic = p_Enable;
+    m_Counters.clear();
+    if (p_Enable)
+        m_Counters.resize(m_Nodes.size(), l_Zero);
+}
+
+void FibCompressor::getTraffic(vector<RouteTraffic>& p_Traffic) const
+{
+    collectTraffic(0, 0, 0, p_Traffic);
+}
+
+int FibCompressor::getRouteCount(void) const
+{
+    return m_RouteCount;
+}
+
+int FibCompressor::getInstalledCount(void) const
+{
+    return m_InstalledCount;
+}
+
+
+int FibCompressor::findNode(uint32_t p_Prefix, int p_Length, bool p_Create, int& p_Covering)
+{
+    int l_Node = 0;
+
+    p_Covering = NO_ROUTE;
+    for (int i = 0; i < p_Length; ++i)
+        {
+            if (m_Nodes[l_Node].m_OutboundInterface != NO_ROUTE)
+                p_Covering = m_Nodes[l_Node].m_OutboundInterface;
+
+            int l_Bit = (p_Prefix >> (31 - i)) & 1;
+            int l_Next = m_Nodes[l_Node].m_Child[l_Bit];
+            if (l_Next == 0)
+                {
+                    if (!p_Create)
+                        return 0;
+                    l_Next = allocateNode();
+                    m_Nodes[l_Node].m_Child[l_Bit] = l_Next;
+                }
+            l_Node = l_Next;
+        }
+    return l_Node;
+}
+
+int FibCompressor::allocateNode(void)
+{
+    Node l_Empty;
+    l_Empty.m_Child[0] = 0;
+    l_Empty.m_Child[1] = 0;
+    l_Empty.m_OutboundInterface = NO_ROUTE;
+    l_Empty.m_Installed = false;
+
+    Counter l_Zero = {0, 0};
+
+    if (!m_FreeNodes.empty())
+        {
+            int l_Index = m_FreeNodes.back();
+            m_FreeNodes.pop_back();
+            m_Nodes[l_Index] = l_Empty;
+            if (m_CountTraffic)
+                m_Counters[l_Index] = l_Zero;
+            return l_Index;
+        }
+    m_Nodes.push_back(l_Empty);
+    if (m_CountTraffic)
+        m_Counters.push_back(l_Zero);
+    return (int)m_Nodes.size() - 1;
+}
+
+void FibCompressor::sync(int p_Node, uint32_t p_Prefix, int p_Length, int p_Covering, bool p_Changed)
+{
+    Node& l_Node = m_Nodes[p_Node];
+
+    //a route with the interface of its covering route is redundant
+    if (l_Node.m_OutboundInterface != p_Covering)
+        {
+            if (!l_Node.m_Installed)
+                m_InstalledCount++;
+            else if (!p_Changed)
+                return;
+            l_Node.m_Installed = true;
+            m_FIB->setRoute(p_Prefix, p_Length, l_Node.m_OutboundInterface);
+        }
+    else if (l_Node.m_Installed)
+        {
+            l_Node.m_Installed = false;
+            m_InstalledCount--;
+            m_FIB->removeRoute(p_Prefix, p_Length);
+        }
+}
+
+void FibCompressor::syncBelow(int p_Node, uint32_t p_Prefix, int p_Length, int p_Covering)
+{
+    if (p_Length >= 32)
+        return;
+
+    for (int l_Bit = 0; l_Bit < 2; ++l_Bit)
+        {
+            int l_Child = m_Nodes[p_Node].m_Child[l_Bit];
+            if (l_Child == 0)
+                continue;
+
+            uint32_t l_Prefix = p_Prefix | ((uint32_t)l_Bit << (31 - p_Length));
+
+            //the routes further down are covered by this one
+            if (m_Nodes[l_Child].m_OutboundInterface != NO_ROUTE)
+                sync(l_Child, l_Prefix, p_Length + 1, p_Covering, false);
+            else
+                syncBelow(l_Child, l_Prefix, p_Length + 1, p_Covering);
+        }
+}
+
+void FibCompressor::collect(int p_Node, uint32_t p_Prefix, int p_Length, int p_Covering, vector<RouteEntry>& p_Routes)
+{
+    Node& l_Node = m_Nodes[p_Node];
+
+    l_Node.m_Installed = false;
+    if (l_Node.m_OutboundInterface != NO_ROUTE)
+        {
+            if (l_Node.m_OutboundInterface != p_Covering)
+                {
+                    RouteEntry l_Route = {p_Prefix, p_Length, l_Node.m_OutboundInterface};
+                    p_Routes.push_back(l_Route);
+                    l_Node.m_Installed = true;
+                }
+            p_Covering = l_Node.m_OutboundInterface;
+        }
+
+    for (int l_Bit = 0; l_Bit < 2 && p_Length < 32; ++l_Bit)
+        {
+            int l_Child = m_Nodes[p_Node].m_Child[l_Bit];
+            if (l_Child != 0)
+                collect(l_Child, p_Prefix | ((uint32_t)l_Bit << (31 - p_Length)), p_Length + 1, p_Covering, p_Routes);
+        }
+}
+
+void FibCompressor::collectAll(int p_Node, uint32_t p_Prefix, int p_Length, vector<RouteEntry>& p_Routes) const
+{
+    const Node& l_Node = m_Nodes[p_Node];
+
+    if (l_Node.m_OutboundInterface != NO_ROUTE)
+        {
+            RouteEntry l_Route = {p_Prefix, p_Length, l_Node.m_OutboundInterface};
+            p_Routes.push_back(l_Route);
+        }
+
+    for (int l_Bit = 0; l_Bit < 2 && p_Length < 32; ++l_Bit)
+        if (l_Node.m_Child[l_Bit] != 0)
+            collectAll(l_Node.m_Child[l_Bit], p_Prefix | ((uint32_t)l_Bit << (31 - p_Length)), p_Length + 1, p_Routes);
+}
+
+void FibCompressor::collectTraffic(int p_Node, uint32_t p_Prefix, int p_Length, vector<RouteTraffic>& p_Traffic) const
+{
+    const Node& l_Node = m_Nodes[p_Node];
+
+    if (l_Node.m_OutboundInterface != NO_ROUTE)
+        {
+            RouteTraffic l_Traffic = {p_Prefix, p_Length, 0, 0};
+            if (m_CountTraffic)
+                {
+                    l_Traffic.m_Packets = m_Counters[p_Node].m_Packets;
+                    l_Traffic.m_Bytes = m_Counters[p_Node].m_Bytes;
+                }
+            p_Traffic.push_back(l_Traffic);
+        }
+
+    for (int l_Bit = 0; l_Bit < 2 && p_Length < 32; ++l_Bit)
+        if (l_Node.m_Child[l_Bit] != 0)
+            collectTraffic(l_Node.m_Child[l_Bit], p_Prefix | ((uint32_t)l_Bit << (31 - p_Length)), p_Length + 1, p_Traffic);
+}
+
+bool FibCompressor::isValidLength(int p_Length) const
+{
+    return p_Length >= 0 && p_Length <= 32;
+}
@@ -0,0 +1,203 @@
+/*! \file  FibCompressor.hpp
+ *  \brief     Header file of the FIB compression stage
+ *  \details
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 18:05:40 2026
+ */
+
+/*!
+ * \class FibCompressor
+ * \brief Keeps a forwarding-equivalent subset of the routes in a FIB
+ *  \details Sits between the Control Plane and a FIB and takes the
+ * route changes in place of the FIB. The compressor holds every route
+ * in its own trie, but passes to the FIB only the routes whose
+ * outbound interface differs from the one of their nearest covering
+ * route. The others resolve to the same interface through the covering
+ * route, so the FIB gives the same result for every address with fewer
+ * entries.
+ *
+ * The changes are incremental: a change of a prefix re-evaluates only
+ * the prefix and the routes directly below it, that is, the routes
+ * whose nearest covering route it is. A full load replaceAll() passes
+ * the compressed table to the FIB as one sorted replaceAll().
+ *
+ * The traffic of a redundant route would be counted by the FIB to its
+ * covering route, so the stage counts the traffic itself: its
+ * resolveRoute() with an entry matches in its own trie and
+ * countTraffic() counts to the uncompressed route.
+ */
+
+
+#include "systemc"
+#include <vector>
+#include "RoutingTable_Manage_If.hpp"
+#include "HugePageArena.hpp"
+
+
+using namespace std;
+using namespace sc_core;
+using namespace sc_dt;
+
+#ifndef _FIBCOMPRESSOR_H_
+#define _FIBCOMPRESSOR_H_
+
+
+
+class FibCompressor: public RoutingTable_Manage_If
+{
+
+public:
+
+    /*! \brief Builds an empty stage
+     * @param[in] RoutingTable_Manage_If* p_FIB The FIB the compressed
+     * routes are passed to, shall be empty
+     * \public
+     */
+    FibCompressor(RoutingTable_Manage_If* p_FIB);
+
+    ~FibCompressor();
+
+    virtual bool setRoute(uint32_t p_Prefix, int p_Length, int p_OutboundInterface);
+
+    virtual bool updateRoute(uint32_t p_Prefix, int p_Length, int p_OutboundInterface);
+
+    virtual bool removeRoute(uint32_t p_Prefix, int p_Length);
+
+    virtual bool setRoutes(const vector<RouteEntry>& p_Routes);
+
+    virtual bool replaceAll(const RouteEntry* p_Begin, const RouteEntry* p_End);
+
+    /*! \brief Gives every route given to the stage
+     * \details Including the redundant routes, which are not in the FIB
+     * \public
+     */
+    virtual void getRoutes(vector<RouteEntry>& p_Routes) const;
+
+    /*! \brief Resolves from the compressed FIB
+     * \public
+     */
+    virtual int resolveRoute(uint32_t p_IPAddress);
+
+    /*! \brief Resolves from the uncompressed trie of the stage
+     * \details The entries are the routes given to the stage, the
+     * redundant ones included. The interface is the one the FIB
+     * resolves to
+     * \public
+     */
+    virtual int resolveRoute(uint32_t p_IPAddress, int& p_Entry);
+
+    virtual int resolveRoute(uint32_t p_IPAddress, int& p_Length, int& p_Entry);
+
+    /*! \brief Counts to the uncompressed route
+     * \details The entry is one given by the stage's own
+     * resolveRoute(), not by the FIB's
+     * \public
+     */
+    virtual void countTraffic(int p_Entry, uint32_t p_Bytes);
+
+    /*! \brief Starts or stops counting the traffic of the routes
+     * \details Stopping drops the counts
+     * \public
+     */
+    void enableTrafficCounters(bool p_Enable);
+
+    /*! \brief Appends the traffic of every route given to the stage
+     * \details The routes are appended in routeLess() order
+     * \public
+     */
+    void getTraffic(vector<RouteTraffic>& p_Traffic) const;
+
+    /*! \brief Number of routes given to the stage
+     * \public
+     */
+    int getRouteCount(void) const;
+
+    /*! \brief Number of routes passed to the FIB
+     * \public
+     */
+    int getInstalledCount(void) const;
+
+private:
+
+    /*! \brief A trie node
+     * \details As in RoutingTable, zero in m_Child means no branch
+     * \private
+     */
+    struct Node
+    {
+        int m_Child[2];
+        int m_OutboundInterface;
+
+        /*! \brief True: the route is in the FIB
+         */
+        bool m_Installed;
+    };
+
+    /*! \brief Finds the node of the given prefix
+     * @param[out] int& p_Covering The outbound interface of the
+     * nearest covering route, NO_ROUTE if there is none
+     * \return <int> The node index or zero if the node does not exist
+     * \private
+     */
+    int findNode(uint32_t p_Prefix, int p_Length, bool p_Create, int& p_Covering);
+
+    int allocateNode(void);
+
+    /*! \brief Installs or removes the route of the node in the FIB
+     * @param[in] int p_Covering The interface of the covering route
+     * @param[in] bool p_Changed The route's interface has changed
+     * \private
+     */
+    void sync(int p_Node, uint32_t p_Prefix, int p_Length, int p_Covering, bool p_Changed);
+
+    /*! \brief Re-evaluates the routes whose nearest covering route is
+     * at the node
+     * \private
+     */
+    void syncBelow(int p_Node, uint32_t p_Prefix, int p_Length, int p_Covering);
+
+    /*! \brief Collects the routes to install in trie pre-order
+     * \private
+     */
+    void collect(int p_Node, uint32_t p_Prefix, int p_Length, int p_Covering, vector<RouteEntry>& p_Routes);
+
+    /*! \brief Collects every route in trie pre-order
+     * \private
+     */
+    void collectAll(int p_Node, uint32_t p_Prefix, int p_Length, vector<RouteEntry>& p_Routes) const;
+
+    void collectTraffic(int p_Node, uint32_t p_Prefix, int p_Length, vector<RouteTraffic>& p_Traffic) const;
+
+    bool isValidLength(int p_Length) const;
+
+    struct Counter
+    {
+        uint64_t m_Packets;
+        uint64_t m_Bytes;
+    };
+
+    RoutingTable_Manage_If* m_FIB;
+
+    /*! \brief The trie nodes, index 0 is the root
+     * \private
+     */
+    vector<Node, HugePageAllocator<Node, MEMORY_FIB> > m_Nodes;
+
+    /*! \brief The traffic counters of the nodes
+     * \details Empty when the traffic is not counted
+     * \private
+     */
+    vector<Counter, HugePageAllocator<Counter, MEMORY_FIB> > m_Counters;
+
+    bool m_CountTraffic;
+
+    vector<int> m_FreeNodes;
+
+    int m_RouteCount;
+
+    int m_InstalledCount;
+};
+
+
+#endif /* _FIBCOMPRESSOR_H_ */
@@ -0,0 +1,82 @@
+/*! \file FixedRouter.hpp
+ *  \brief     Router module with a compile-time interface count
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Mon Oct 19 09:12:44 2026
+ */
+
+
+
+/*!
+ * \class FixedRouter
+ * \brief Router module of N interfaces
+ *  \details The same router as Router, but the interface count N and
+ * the number of interfaces per line card are template parameters, for
+ * the common 2, 4, 8 and 32 port shapes of the topologies. The
+ * receiving exports and the forwarding ports are held in std::array
+ * instead of arrays of pointers allocated with new, and the line card
+ * engines of PER_CARD interfaces run the scheduler specialised for
+ * their count (see DataPlane). The planes and the line cards are
+ * built by RouterBase, as in Router.
+ */
+
+
+
+#include "systemc"
+#include <array>
+#include "RouterBase.hpp"
+
+using namespace std;
+using namespace sc_core;
+using namespace sc_dt;
+
+
+
+#ifndef FIXEDROUTER_H
+#define FIXEDROUTER_H
+
+
+
+template <int N, int PER_CARD = 1>
+class FixedRouter: public RouterBase
+{
+
+    static_assert(N > 0 && PER_CARD > 0, "a router needs interfaces and line cards");
+
+public:
+
+    array<sc_export<Interface_If>, N> export_ReceivingInterface;
+
+    array<sc_port<Interface_If, 1, SC_ZERO_OR_MORE_BOUND>, N> port_ForwardingInterface;
+
+
+    /*!
+     * \brief Constructor
+     * \details Builds the router
+     * @param[in] p_Name The name of the module
+     * @param[in] BGPSessionParameters p_BGPSessionParam The default
+     * session parameters
+     * @param[in] RouteProcessorParameters p_RPParam The capacity of the
+     * Control Plane
+     * \public
+     */
+    FixedRouter(sc_module_name p_ModuleName, BGPSessionParameters p_BGPSessionParam, RouteProcessorParameters p_RPParam = RouteProcessorParameters()):RouterBase(p_ModuleName, N, p_BGPSessionParam, PER_CARD, p_RPParam)
+    {
+        //bind the network interfaces in the order of the fabric's
+        //egresses
+        for (int i = 0; i < N; i++)
+            bindInterface(i, export_ReceivingInterface[i], port_ForwardingInterface[i]);
+    }
+
+    virtual sc_export<Interface_If>& getReceivingInterface(int p_InterfaceId)
+    {
+        return export_ReceivingInterface[p_InterfaceId];
+    }
+
+    virtual sc_port<Interface_If, 1, SC_ZERO_OR_MORE_BOUND>& getForwardingInterface(int p_InterfaceId)
+    {
+        return port_ForwardingInterface[p_InterfaceId];
+    }
+};
+
+#endif
@@ -0,0 +1,87 @@
+/*! \file FlapDampening.cpp
+ *  \brief     Implementation of the interface flap dampening.
+ *  \details
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 21:04:36 2026
+ */
+
+
+#include "FlapDampening.hpp"
+#include <cmath>
+#include <algorithm>
+
+
+FlapDampening::FlapDampening(void):m_Penalty(0), m_Updated(0), m_Suppressed(false), m_Flaps(0), m_SuppressedTransitions(0)
+{
+}
+
+
+bool FlapDampening::flap(double p_Time)
+{
+    //the penalty that decays to the reuse threshold in the longest
+    //suppression time
+    static const double s_MaxPenalty = DAMPENING_REUSE * pow(2.0, DAMPENING_MAX_SUPPRESS / DAMPENING_HALF_LIFE);
+
+    m_Flaps++;
+    if (!INTERFACE_DAMPENING)
+        return false;
+
+    decay(p_Time);
+    m_Penalty = min(m_Penalty + DAMPENING_PENALTY, s_MaxPenalty);
+    if (m_Penalty > DAMPENING_SUPPRESS)
+        m_Suppressed = true;
+    return m_Suppressed;
+}
+
+bool FlapDampening::isSuppressed(double p_Time)
+{
+    if (!m_Suppressed)
+        return false;
+
+    //tolerate the rounding of a wait of getTimeToReuse()
+    decay(p_Time);
+    if (m_Penalty < DAMPENING_REUSE * (1.0 + 1e-9))
+        m_Suppressed = false;
+    return m_Suppressed;
+}
+
+double FlapDampening::getPenalty(double p_Time)
+{
+    decay(p_Time);
+    return m_Penalty;
+}
+
+double FlapDampening::getTimeToReuse(double p_Time)
+{
+    if (!isSuppressed(p_Time))
+        return 0;
+
+    //the penalty halves every half-life
+    return DAMPENING_HALF_LIFE * log2(m_Penalty / DAMPENING_REUSE);
+}
+
+void FlapDampening::countSuppressed(void)
+{
+    m_SuppressedTransitions++;
+}
+
+uint64_t FlapDampening::getFlaps(void) const
+{
+    return m_Flaps;
+}
+
+uint64_t FlapDampening::getSuppressedTransitions(void) const
+{
+    return m_SuppressedTransitions;
+}
+
+
+void FlapDampening::decay(double p_Time)
+{
+    if (p_Time > m_Updated)
+        {
+            m_Penalty *= exp2((m_Updated - p_Time) / DAMPENING_HALF_LIFE);
+            m_Updated = p_Time;
+        }
+}
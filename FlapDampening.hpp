@@ -0,0 +1,128 @@
+/*! \file  FlapDampening.hpp
+ *  \brief     Header file of the interface flap dampening
+ *  \details
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 21:04:36 2026
+ */
+
+/*!
+ * \class FlapDampening
+ * \brief Penalty of a flapping interface with exponential decay
+ *  \details Each time the link goes down the penalty grows by
+ * DAMPENING_PENALTY, and the penalty halves every DAMPENING_HALF_LIFE
+ * seconds. When the penalty goes over DAMPENING_SUPPRESS the interface
+ * is suppressed: it is held down even if the link comes back up, until
+ * the penalty has decayed under DAMPENING_REUSE. The penalty is capped
+ * so that an interface is suppressed at most DAMPENING_MAX_SUPPRESS
+ * seconds after its last flap.
+ *
+ * The decay is lazy: the penalty is only brought up to date when it is
+ * read or increased, so an idle interface costs nothing.
+ */
+
+
+#include <stdint.h>
+
+
+using namespace std;
+
+#ifndef _FLAPDAMPENING_H_
+#define _FLAPDAMPENING_H_
+
+
+/*! \def INTERFACE_DAMPENING
+ *  \brief Defines whether the flapping interfaces are suppressed, 0 or 1
+ */
+#ifndef INTERFACE_DAMPENING
+#define INTERFACE_DAMPENING 1
+#endif
+
+/*! \def DAMPENING_PENALTY
+ *  \brief Defines the penalty of one flap
+ */
+#define DAMPENING_PENALTY 1000.0
+
+/*! \def DAMPENING_SUPPRESS
+ *  \brief Defines the penalty over which the interface is suppressed
+ */
+#define DAMPENING_SUPPRESS 2000.0
+
+/*! \def DAMPENING_REUSE
+ *  \brief Defines the penalty under which the interface is reused
+ */
+#define DAMPENING_REUSE 1000.0
+
+/*! \def DAMPENING_HALF_LIFE
+ *  \brief Defines the half-life of the penalty in seconds
+ */
+#define DAMPENING_HALF_LIFE 5.0
+
+/*! \def DAMPENING_MAX_SUPPRESS
+ *  \brief Defines the longest suppression after a flap in seconds
+ */
+#define DAMPENING_MAX_SUPPRESS 20.0
+
+
+
+class FlapDampening
+{
+
+public:
+
+    FlapDampening(void);
+
+    /*! \brief Adds the penalty of a flap
+     * @param[in] double p_Time The simulation time in seconds
+     * \return <bool> True: if the interface is suppressed
+     * \public
+     */
+    bool flap(double p_Time);
+
+    /*! \brief Checks whether the interface is suppressed
+     * \details Ends the suppression if the penalty has decayed under
+     * the reuse threshold
+     * \public
+     */
+    bool isSuppressed(double p_Time);
+
+    double getPenalty(double p_Time);
+
+    /*! \brief Time until the suppression ends in seconds
+     * \details Zero if the interface is not suppressed
+     * \public
+     */
+    double getTimeToReuse(double p_Time);
+
+    /*! \brief Counts a transition that was not passed on
+     * \public
+     */
+    void countSuppressed(void);
+
+    uint64_t getFlaps(void) const;
+
+    uint64_t getSuppressedTransitions(void) const;
+
+private:
+
+    /*! \brief Brings the penalty up to date
+     * \private
+     */
+    void decay(double p_Time);
+
+    double m_Penalty;
+
+    /*! \brief The time the penalty was brought up to date
+     * \private
+     */
+    double m_Updated;
+
+    bool m_Suppressed;
+
+    uint64_t m_Flaps;
+
+    uint64_t m_SuppressedTransitions;
+};
+
+
+#endif /* _FLAPDAMPENING_H_ */
@@ -0,0 +1,176 @@
+/*! \file HugePageArena.cpp
+ *  \brief     Implementation of the huge page arena.
+ *  \details
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 19:26:05 2026
+ */
+
+
+#include "HugePageArena.hpp"
+#include <sys/mman.h>
+
+
+atomic<size_t> HugePageArena::s_MappedBytes(0);
+
+atomic<size_t> HugePageArena::s_FallbackCount(0);
+
+mutex HugePageArena::s_Lock;
+
+HugePageArena::FreeBlock* HugePageArena::s_Free[HUGE_PAGE_SIZE / HUGE_PAGE_UNIT + 1];
+
+
+void* HugePageArena::allocate(size_t p_Bytes)
+{
+    if (!isMapped(p_Bytes))
+        return ::operator new(p_Bytes);
+
+    void* l_Block;
+    size_t l_Bytes;
+
+    if (isShared(p_Bytes))
+        {
+            lock_guard<mutex> l_Guard(s_Lock);
+
+            l_Bytes = toUnits(p_Bytes) * HUGE_PAGE_UNIT;
+            l_Block = carve(toUnits(p_Bytes));
+        }
+    else
+        {
+            l_Bytes = roundUp(p_Bytes);
+            l_Block = mapPages(l_Bytes);
+        }
+    MemoryAccounting::add(MemoryAccounting::getRouter(), MemoryAccounting::getTag(), (int64_t)l_Bytes, 1);
+    return l_Block;
+}
+
+void HugePageArena::release(void* p_Block, size_t p_Bytes)
+{
+    if (p_Block == NULL)
+        return;
+    if (!isMapped(p_Bytes))
+        {
+            ::operator delete(p_Block);
+            return;
+        }
+
+    size_t l_Bytes;
+
+    if (isShared(p_Bytes))
+        {
+            lock_guard<mutex> l_Guard(s_Lock);
+
+            l_Bytes = toUnits(p_Bytes) * HUGE_PAGE_UNIT;
+            pushFree(p_Block, toUnits(p_Bytes));
+        }
+    else
+        {
+            //the kernel knows which kind of pages the region has
+            l_Bytes = roundUp(p_Bytes);
+            munmap(p_Block, l_Bytes);
+            s_MappedBytes -= l_Bytes;
+        }
+    MemoryAccounting::add(MemoryAccounting::getRouter(), MemoryAccounting::getTag(), -(int64_t)l_Bytes, -1);
+}
+
+size_t HugePageArena::getMappedBytes(void)
+{
+    return s_MappedBytes;
+}
+
+size_t HugePageArena::getFallbackCount(void)
+{
+    return s_FallbackCount;
+}
+
+
+void* HugePageArena::mapPages(size_t p_Bytes)
+{
+    void* l_Region = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+    l_Region = mmap(NULL, p_Bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+    if (l_Region == MAP_FAILED)
+        {
+            l_Region = mapTransparent(p_Bytes);
+            if (l_Region == NULL)
+                throw bad_alloc();
+            s_FallbackCount++;
+        }
+    s_MappedBytes += p_Bytes;
+    return l_Region;
+}
+
+void* HugePageArena::mapTransparent(size_t p_Bytes)
+{
+    //map one page more and trim the region to the page boundaries
+    size_t l_Mapped = p_Bytes + HUGE_PAGE_SIZE;
+    void* l_Region = mmap(NULL, l_Mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (l_Region == MAP_FAILED)
+        return NULL;
+
+    uintptr_t l_Start = (uintptr_t)l_Region;
+    uintptr_t l_Aligned = (l_Start + HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(HUGE_PAGE_SIZE - 1);
+
+    if (l_Aligned > l_Start)
+        munmap(l_Region, l_Aligned - l_Start);
+    if (l_Start + l_Mapped > l_Aligned + p_Bytes)
+        munmap((void*)(l_Aligned + p_Bytes), l_Start + l_Mapped - l_Aligned - p_Bytes);
+
+#ifdef MADV_HUGEPAGE
+    madvise((void*)l_Aligned, p_Bytes, MADV_HUGEPAGE);
+#endif
+    return (void*)l_Aligned;
+}
+
+void* HugePageArena::carve(size_t p_Units)
+{
+    const size_t l_PageUnits = HUGE_PAGE_SIZE / HUGE_PAGE_UNIT;
+    size_t l_Units = p_Units;
+
+    //the smallest free block that is large enough, or a new page
+    while (l_Units <= l_PageUnits && s_Free[l_Units] == NULL)
+        l_Units++;
+    if (l_Units > l_PageUnits)
+        {
+            l_Units = l_PageUnits;
+            pushFree(mapPages(HUGE_PAGE_SIZE), l_Units);
+        }
+
+    FreeBlock* l_Block = s_Free[l_Units];
+
+    s_Free[l_Units] = l_Block->m_Next;
+    if (l_Units > p_Units)
+        pushFree((char*)l_Block + p_Units * HUGE_PAGE_UNIT, l_Units - p_Units);
+    return l_Block;
+}
+
+void HugePageArena::pushFree(void* p_Block, size_t p_Units)
+{
+    FreeBlock* l_Block = static_cast<FreeBlock*>(p_Block);
+
+    l_Block->m_Next = s_Free[p_Units];
+    s_Free[p_Units] = l_Block;
+}
+
+bool HugePageArena::isMapped(size_t p_Bytes)
+{
+    return HUGE_PAGE_ARENA && p_Bytes >= HUGE_PAGE_MIN_BYTES;
+}
+
+bool HugePageArena::isShared(size_t p_Bytes)
+{
+    return p_Bytes < HUGE_PAGE_SIZE;
+}
+
+size_t HugePageArena::roundUp(size_t p_Bytes)
+{
+    return (p_Bytes + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+}
+
+size_t HugePageArena::toUnits(size_t p_Bytes)
+{
+    return (p_Bytes + HUGE_PAGE_UNIT - 1) / HUGE_PAGE_UNIT;
+}
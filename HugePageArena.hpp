@@ -0,0 +1,226 @@
+/*! \file  HugePageArena.hpp
+ *  \brief     Allocator of memory backed by huge pages
+ *  \details   Defines the HugePageArena and the HugePageAllocator the
+ *  large routing tables are kept in.
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 19:26:05 2026
+ */
+
+/*!
+ * \class HugePageArena
+ * \brief Maps the large blocks of memory on 2 MB pages
+ *  \details The tries of the RIB and the FIB are large and looked up at
+ * random, so with 4 kB pages nearly every lookup misses the TLB. The
+ * arena keeps the blocks on 2 MB aligned regions, mapped first from the
+ * explicit huge page pool (MAP_HUGETLB) and, if the pool is empty or
+ * not configured, from ordinary memory which it advises the kernel to
+ * back with transparent huge pages. The blocks smaller than
+ * HUGE_PAGE_MIN_BYTES come from the heap, as they are too small to
+ * gain from the huge pages.
+ *
+ * A block of a huge page or more is mapped on a region of its own and
+ * unmapped when released. The smaller blocks are rounded up to
+ * HUGE_PAGE_UNIT and carved out of shared huge pages, so e.g. the two
+ * tables of a FibCache take 144 kB of one page instead of a page each.
+ * The free blocks are kept in a list for each size: a block is taken
+ * from the list of its size or split from the smallest larger free
+ * block, and a new page is mapped only when there is none. The
+ * released blocks return to the lists and are not merged, and the
+ * shared pages stay mapped. As the tables grow by doubling, the
+ * blocks a table releases are taken by the tables that grow after it.
+ *
+ * The blocks are charged to the open MemoryScope.
+ */
+
+
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <cstddef>
+#include <stdint.h>
+#include "MemoryAccounting.hpp"
+
+
+using namespace std;
+
+#ifndef _HUGEPAGEARENA_H_
+#define _HUGEPAGEARENA_H_
+
+
+/*! \def HUGE_PAGE_ARENA
+ *  \brief Defines whether the large tables are kept on huge pages, 0
+ *  or 1
+ */
+#ifndef HUGE_PAGE_ARENA
+#define HUGE_PAGE_ARENA 1
+#endif
+
+/*! \def HUGE_PAGE_SIZE
+ *  \brief Defines the size of a huge page in bytes
+ */
+#define HUGE_PAGE_SIZE ((size_t)2 << 20)
+
+/*! \def HUGE_PAGE_MIN_BYTES
+ *  \brief Defines the size of the smallest block mapped on huge pages
+ */
+#define HUGE_PAGE_MIN_BYTES ((size_t)64 << 10)
+
+/*! \def HUGE_PAGE_UNIT
+ *  \brief Defines the size the blocks carved out of the shared huge
+ *  pages are rounded up to
+ */
+#define HUGE_PAGE_UNIT ((size_t)4 << 10)
+
+
+
+class HugePageArena
+{
+
+public:
+
+    /*! \brief Allocates a block
+     * @param[in] size_t p_Bytes The size of the block
+     * \return <void*> The block, std::bad_alloc is thrown if there is
+     * no memory
+     * \public
+     */
+    static void* allocate(size_t p_Bytes);
+
+    /*! \brief Releases a block
+     * @param[in] size_t p_Bytes The size the block was allocated with
+     * \public
+     */
+    static void release(void* p_Block, size_t p_Bytes);
+
+    /*! \brief Number of bytes currently mapped by the arena, with the
+     * free space of the shared pages
+     * \public
+     */
+    static size_t getMappedBytes(void);
+
+    /*! \brief Number of blocks mapped for transparent huge pages as
+     * the explicit huge page pool had no room for them
+     * \public
+     */
+    static size_t getFallbackCount(void);
+
+private:
+
+    /*! \brief A free block of a shared page
+     * \private
+     */
+    struct FreeBlock
+    {
+        FreeBlock* m_Next;
+    };
+
+    /*! \brief Maps a 2 MB aligned region of whole huge pages
+     * \details std::bad_alloc is thrown if there is no memory
+     * \private
+     */
+    static void* mapPages(size_t p_Bytes);
+
+    /*! \brief Maps a 2 MB aligned region for transparent huge pages
+     * \return <void*> The region or NULL
+     * \private
+     */
+    static void* mapTransparent(size_t p_Bytes);
+
+    /*! \brief Takes a block of p_Units units from the shared pages
+     * \details s_Lock shall be held
+     * \private
+     */
+    static void* carve(size_t p_Units);
+
+    static void pushFree(void* p_Block, size_t p_Units);
+
+    static bool isMapped(size_t p_Bytes);
+
+    static bool isShared(size_t p_Bytes);
+
+    static size_t roundUp(size_t p_Bytes);
+
+    static size_t toUnits(size_t p_Bytes);
+
+    static atomic<size_t> s_MappedBytes;
+
+    static atomic<size_t> s_FallbackCount;
+
+    /*! \brief Guards the free lists
+     * \private
+     */
+    static mutex s_Lock;
+
+    /*! \brief The free blocks of the shared pages by their size in units
+     * \private
+     */
+    static FreeBlock* s_Free[HUGE_PAGE_SIZE / HUGE_PAGE_UNIT + 1];
+};
+
+
+/*!
+ * \class HugePageAllocator
+ * \brief Standard allocator that allocates from the HugePageArena
+ *  \details Lets the containers of the tables keep their elements on
+ * huge pages, e.g. vector<Node, HugePageAllocator<Node, MEMORY_FIB> >.
+ * The memory is charged to the subsystem TAG of the router of the
+ * scope open when the container is built, as with TaggedAllocator.
+ */
+template <class T, int TAG>
+class HugePageAllocator
+{
+
+public:
+
+    typedef T value_type;
+
+    template <class U>
+    struct rebind
+    {
+        typedef HugePageAllocator<U, TAG> other;
+    };
+
+    HugePageAllocator(void):m_Router(MemoryAccounting::getRouter()){};
+
+    template <class U>
+    HugePageAllocator(const HugePageAllocator<U, TAG>& p_Other):m_Router(p_Other.getRouter()){};
+
+    T* allocate(size_t p_Count)
+    {
+        MemoryScope l_Scope(m_Router, TAG);
+
+        return static_cast<T*>(HugePageArena::allocate(p_Count * sizeof(T)));
+    }
+
+    void deallocate(T* p_Block, size_t p_Count)
+    {
+        MemoryScope l_Scope(m_Router, TAG);
+
+        HugePageArena::release(p_Block, p_Count * sizeof(T));
+    }
+
+    int getRouter(void) const
+    {
+        return m_Router;
+    }
+
+private:
+
+    int m_Router;
+};
+
+template <class T, class U, int TAG>
+bool operator==(const HugePageAllocator<T, TAG>&, const HugePageAllocator<U, TAG>&)
+{
+    return true;
+}
+
+template <class T, class U, int TAG>
+bool operator!=(const HugePageAllocator<T, TAG>&, const HugePageAllocator<U, TAG>&)
+{
+    return false;
+}
+
+
+#endif /* _HUGEPAGEARENA_H_ */
@@ -17,9 +17,14 @@ Interface::Interface(sc_module_name p_ModName):sc_module(p_ModName)
     export_ToDataPlane(m_ReceivingBuffer); // //export the forwarding buffer's input interface for the protocol engine
 
     m_InterfaceState = DOWN;
+    m_LinkState = DOWN;
 
     SC_THREAD(interfaceMain);
     sensitive << port_Clk.pos();
+
+    SC_METHOD(reuse);
+    sensitive << m_ReuseEvent;
+    dont_initialize();
 }
 
 Interface::~Interface()
@@ -55,10 +60,53 @@ bool Interface::forward(Packet p_Packet)
 
 void Interface::interfaceDown(void)
 {
+  if(m_LinkState == DOWN)
+    return;
+  m_LinkState = DOWN;
+
+  //a suppressed interface is already held down
+  if(m_InterfaceState == DOWN)
+    m_Dampening.countSuppressed();
   m_InterfaceState = DOWN;
+  m_Dampening.flap(sc_time_stamp().to_seconds());
 }
 
 void Interface::interfaceUp(void)
 {
+  if(m_LinkState == UP)
+    return;
+  m_LinkState = UP;
+
+  double l_Now = sc_time_stamp().to_seconds();
+  if(m_Dampening.isSuppressed(l_Now))
+    {
+      m_Dampening.countSuppressed();
+      m_ReuseEvent.notify(sc_time(m_Dampening.getTimeToReuse(l_Now), SC_SEC));
+      return;
+    }
   m_InterfaceState = UP;
 }
+
+void Interface::reuse(void)
+{
+  double l_Now = sc_time_stamp().to_seconds();
+
+  if(m_LinkState == DOWN || m_InterfaceState == UP)
+    return;
+  //a flap during the wait has extended the suppression
+  if(m_Dampening.isSuppressed(l_Now))
+    m_ReuseEvent.notify(sc_time(m_Dampening.getTimeToReuse(l_Now), SC_SEC));
+  else
+    m_InterfaceState = UP;
+}
+
+const FlapDampening& Interface::getDampening(void) const
+{
+  return m_Dampening;
+}
+
+void Interface::end_of_simulation()
+{
+  if(m_Dampening.getFlaps() > 0)
+    cout << name() << " flaps: " << m_Dampening.getFlaps() << ", suppressed transitions " << m_Dampening.getSuppressedTransitions() << endl;
+}
@@ -9,13 +9,18 @@
 /*!
  * \class Interface
  * \brief Interface module inside a Router module
- *  \details   
+ *  \details The link state set by interfaceUp() and interfaceDown()
+ * passes through a FlapDampening. An interface whose link flaps is
+ * suppressed: it is held down after the link comes back up until its
+ * penalty has decayed, so the flaps do not reach the BGP sessions.
  */
 
 
 #include "systemc"
 #include "Packet.hpp"
 #include "Interface_If.hpp"
+#include "RingChannel.hpp"
+#include "FlapDampening.hpp"
 
 
 
@@ -76,6 +81,19 @@ public:
 
   virtual void interfaceUp(void);
 
+  /*! \brief Brings a suppressed interface up when its link is up and
+   * the penalty has decayed
+   * \public
+   */
+  void reuse(void);
+
+  /*! \brief The flap counters of the interface
+   * \public
+   */
+  const FlapDampening& getDampening(void) const;
+
+  void end_of_simulation();
+
   /*! \brief Indicate the systemC producer that this module has a process.
    * \sa http://www.iro.umontreal.ca/~lablasso/docs/SystemC2.0.1/html/classproducer.html
    * \public
@@ -93,16 +111,28 @@ private:
    * \details 
    * \private
    */
-  sc_fifo<Packet> m_ReceivingBuffer;
+  RingChannel<Packet> m_ReceivingBuffer;
 
   /*! \brief Forwardig buffer
    * \details 
    * \private
    */
-  sc_fifo<Packet> m_ForwardingBuffer;
+  RingChannel<Packet> m_ForwardingBuffer;
 
+  /*! \brief The state seen by the router, held down while suppressed
+   * \private
+   */
   bool m_InterfaceState;
 
+  /*! \brief The state of the link
+   * \private
+   */
+  bool m_LinkState;
+
+  FlapDampening m_Dampening;
+
+  sc_event m_ReuseEvent;
+
 };
 
 
@@ -0,0 +1,87 @@
+/*! \file LineCard.cpp
+ *  \brief     Implementation of LineCard module.
+ *  \details
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 11:40:51 2026
+ */
+
+
+#include "LineCard.hpp"
+
+
+LineCard::LineCard(sc_module_name p_ModuleName, int p_LineCardId, int p_FirstInterface, int p_InterfaceCount):sc_module(p_ModuleName), m_Engine("Engine", p_InterfaceCount, p_FirstInterface, p_LineCardId), m_Compressor(&m_Engine.getFIBCache()), m_FirstInterface(p_FirstInterface), m_InterfaceCount(p_InterfaceCount)
+{
+    //make the inner bindings
+    m_Engine.getFIBCache().setFIB(&m_FIB);
+    if (FIB_COMPRESSION)
+        {
+            //the compressed replica has no entries of the redundant routes
+            m_Compressor.enableTrafficCounters(FIB_TRAFFIC_COUNTERS);
+            if (FIB_TRAFFIC_COUNTERS)
+                m_Engine.getPipeline().getStage<PIPELINE_FIB>().setTrafficTable(&m_Compressor);
+            export_FIB(m_Compressor);
+        }
+    else
+        {
+            m_FIB.enableTrafficCounters(FIB_TRAFFIC_COUNTERS);
+            export_FIB(m_Engine.getFIBCache());
+        }
+    export_FromControlPlane(m_Engine);
+
+    m_Engine.port_Clk(port_Clk);
+    m_Engine.port_FIB(m_FIB);
+    m_Engine.port_ToControlPlane(port_ToControlPlane);
+    m_Engine.port_ToFabric(port_ToFabric);
+
+    //allocate reference array for network interface modules
+    m_NetworkInterface = new Interface*[m_InterfaceCount];
+
+    for(int i = 0; i < m_InterfaceCount; i++)
+        {
+            //the interfaces keep the router level names
+            m_NetworkInterface[i] = new Interface(appendName("Interface_", m_FirstInterface + i).c_str());
+            m_NetworkInterface[i]->port_Clk(port_Clk);
+
+            //bind the receiving buffer's output to the engine
+            m_Engine.port_FromInterface(m_NetworkInterface[i]->export_ToDataPlane);
+        }
+}
+
+LineCard::~LineCard()
+{
+    for(int i = 0; i < m_InterfaceCount; i++)
+        delete m_NetworkInterface[i];
+    delete[] m_NetworkInterface;
+}
+
+Interface* LineCard::getInterface(int p_InterfaceId)
+{
+    return m_NetworkInterface[p_InterfaceId - m_FirstInterface];
+}
+
+bool LineCard::hasInterface(int p_InterfaceId) const
+{
+    return p_InterfaceId >= m_FirstInterface && p_InterfaceId < m_FirstInterface + m_InterfaceCount;
+}
+
+bool LineCard::setMulticastGroup(uint32_t p_Group, const vector<int>& p_Egresses)
+{
+    return m_Engine.setMulticastGroup(p_Group, p_Egresses);
+}
+
+void LineCard::getTraffic(vector<RouteTraffic>& p_Traffic) const
+{
+    if (FIB_COMPRESSION)
+        m_Compressor.getTraffic(p_Traffic);
+    else
+        m_FIB.getTraffic(p_Traffic);
+}
+
+string LineCard::appendName(string p_Name, int p)
+{
+    stringstream ss;
+    ss << p;
+    p_Name += ss.str();
+    return p_Name;
+}
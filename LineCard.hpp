@@ -0,0 +1,180 @@
+/*! \file  LineCard.hpp
+ *  \brief     Header file of LineCard module
+ *  \details
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 11:40:51 2026
+ */
+
+/*!
+ * \class LineCard
+ * \brief A group of network interfaces served by one forwarding engine
+ *  \details The line card owns its network interfaces, a forwarding
+ * engine (DataPlane) and a FIB replica (RoutingTable). The engine only
+ * serves the receiving buffers of the card's own interfaces, so the
+ * forwarding capacity of a router grows with the number of line cards.
+ * The line cards of a router share nothing but the channels they are
+ * connected with, which makes each of them an independent unit of
+ * simulation work.
+ *
+ * The route changes pass through the engine's FibCache on their way
+ * to the replica, so that the cache of the hot destinations stays
+ * coherent. With FIB_COMPRESSION they first pass a FibCompressor,
+ * which then leaves in the replica only the routes that differ from
+ * their covering route.
+ *
+ * With FIB_TRAFFIC_COUNTERS the replica counts the packets and the
+ * bytes the card's engine forwards by each of its routes. With
+ * FIB_COMPRESSION the FibCompressor counts them instead, against the
+ * uncompressed routes, so that a redundant route is reported with its
+ * own traffic rather than in the one of its covering route. This costs
+ * the engine a second lookup per packet in the compressor. The counters
+ * of a card are written by its own engine only, so the cards do not
+ * share them and the router sums them when they are read.
+ *
+ * The Control Plane feeds the FIB replica through export_FIB and
+ * passes the BGP messages of the sessions through
+ * export_FromControlPlane.
+ */
+
+
+#include "systemc"
+#include "Interface.hpp"
+#include "DataPlane.hpp"
+#include "RoutingTable.hpp"
+#include "FibCompressor.hpp"
+
+using namespace std;
+using namespace sc_core;
+using namespace sc_dt;
+
+#ifndef _LINECARD_H_
+#define _LINECARD_H_
+
+
+/*! \def FIB_COMPRESSION
+ *  \brief Defines whether the FIB replicas are compressed, 0 or 1
+ */
+#ifndef FIB_COMPRESSION
+#define FIB_COMPRESSION 1
+#endif
+
+/*! \def FIB_TRAFFIC_COUNTERS
+ *  \brief Defines whether the FIB replicas count the traffic of their
+ * routes, 0 or 1
+ */
+#ifndef FIB_TRAFFIC_COUNTERS
+#define FIB_TRAFFIC_COUNTERS 1
+#endif
+
+
+
+
+class LineCard: public sc_module
+{
+
+public:
+
+    /*! \brief Clock signal
+     * \details The router's internal clock
+     * \public
+     */
+    sc_in_clk port_Clk;
+
+    /*! \brief Forwarding port
+     * \details Shall be bound to the router's switch fabric
+     * \public
+     */
+    sc_port<Fabric_In_If,1, SC_ZERO_OR_MORE_BOUND> port_ToFabric;
+
+    /*! \brief Output port for BGP messages
+     * \details Shall be bound to the Control Plane's receiving buffer
+     * \public
+     */
+    sc_port<sc_fifo_out_if<BGPMessage>,1, SC_ZERO_OR_MORE_BOUND> port_ToControlPlane;
+
+    /*! \brief FIB replica's management interface
+     * \details The Control Plane binds its routing table management
+     * port to this export
+     * \public
+     */
+    sc_export<RoutingTable_Manage_If> export_FIB;
+
+    /*! \brief BGP messages to be sent from the card's interfaces
+     * \public
+     */
+    sc_export<DataPlane_In_If> export_FromControlPlane;
+
+
+    /*!
+     * \brief Constructor
+     * \details Builds the line card and its interfaces
+     * @param[in] p_ModuleName The name of the module
+     * @param[in] int p_LineCardId The index of the card in the router
+     * @param[in] int p_FirstInterface The router level index of the
+     * card's first interface
+     * @param[in] int p_InterfaceCount The number of interfaces on the card
+     * \public
+     */
+    LineCard(sc_module_name p_ModuleName, int p_LineCardId, int p_FirstInterface, int p_InterfaceCount);
+
+    ~LineCard();
+
+    /*! \brief Returns the card's network interface
+     * @param[in] int p_InterfaceId The router level interface index
+     * \public
+     */
+    Interface* getInterface(int p_InterfaceId);
+
+    /*! \brief Checks whether the interface is on this card
+     * @param[in] int p_InterfaceId The router level interface index
+     * \public
+     */
+    bool hasInterface(int p_InterfaceId) const;
+
+    /*! \brief Sets a multicast group on the card's engine
+     * \public
+     */
+    bool setMulticastGroup(uint32_t p_Group, const vector<int>& p_Egresses);
+
+    /*! \brief Appends the traffic the card has forwarded by each route
+     * \details Every route set by the Control Plane, also with
+     * FIB_COMPRESSION
+     * \public
+     */
+    void getTraffic(vector<RouteTraffic>& p_Traffic) const;
+
+private:
+
+    /*! \brief The forwarding engine of the card
+     * \private
+     */
+    DataPlane m_Engine;
+
+    /*! \brief The FIB replica of the card
+     * \private
+     */
+    RoutingTable m_FIB;
+
+    /*! \brief Passes the compressed route changes to m_FIB
+     * \private
+     */
+    FibCompressor m_Compressor;
+
+    Interface **m_NetworkInterface;
+
+    int m_FirstInterface;
+
+    int m_InterfaceCount;
+
+    /*!
+     * \fn   string appendName(string p_Name, int p)
+     * \brief Append integer to a string
+     * \details  Used to append module id into the module base name
+     * \private
+     */
+    string appendName(string p_Name, int p);
+};
+
+
+#endif /* _LINECARD_H_ */
@@ -0,0 +1,59 @@
+/*! \file LocalLink.cpp
+ *  \brief     Implementation of LocalLink.
+ *  \details
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 23:58:41 2026
+ */
+
+
+#include "LocalLink.hpp"
+
+
+LocalLink::LocalLink(sc_module_name p_ModuleName, sc_time p_Delay):sc_module(p_ModuleName), m_Delay(p_Delay), m_LinkState(true)
+{
+    SC_THREAD(deliver);
+}
+
+LocalLink::~LocalLink()
+{
+}
+
+
+bool LocalLink::forward(Packet p_Packet)
+{
+    if (!m_LinkState)
+        return false;
+
+    m_Pending.push_back(make_pair(sc_time_stamp() + m_Delay, p_Packet));
+    m_Arrival.notify();
+    return true;
+}
+
+void LocalLink::interfaceDown(void)
+{
+    m_LinkState = false;
+}
+
+void LocalLink::interfaceUp(void)
+{
+    m_LinkState = true;
+}
+
+void LocalLink::deliver(void)
+{
+    while (true)
+        {
+            while (m_Pending.empty())
+                wait(m_Arrival);
+
+            if (m_Pending.front().first > sc_time_stamp())
+                wait(m_Pending.front().first - sc_time_stamp());
+
+            Packet l_Packet = m_Pending.front().second;
+
+            m_Pending.pop_front();
+            if (port_Output.size() > 0)
+                port_Output->forward(l_Packet);
+        }
+}
@@ -0,0 +1,92 @@
+/*! \file  LocalLink.hpp
+ *  \brief     Header file of LocalLink module
+ *  \details
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 23:58:41 2026
+ */
+
+/*!
+ * \class LocalLink
+ * \brief One direction of a link between two routers of the same process
+ *  \details The router forwards to the link as it would forward to the
+ * peer router's interface, and the link forwards each packet to the
+ * peer through port_Output after the link delay. The links between the
+ * partitions of a split simulation, the PartitionLinks, have the same
+ * delay, so the network simulated does not depend on how it is split.
+ */
+
+
+#include "systemc"
+#include <deque>
+#include <utility>
+#include "Packet.hpp"
+#include "Interface_If.hpp"
+
+
+using namespace std;
+using namespace sc_core;
+using namespace sc_dt;
+
+#ifndef _LOCALLINK_H_
+#define _LOCALLINK_H_
+
+
+
+
+class LocalLink: public sc_module, public Interface_If
+{
+
+public:
+
+    /*! \brief Delivers the packets to the peer
+     * \details Shall be bound to the peer router's receiving interface
+     * \public
+     */
+    sc_port<Interface_If,1, SC_ZERO_OR_MORE_BOUND> port_Output;
+
+
+    /*!
+     * \brief Constructor
+     * @param[in] sc_module_name p_ModuleName The name of the module
+     * @param[in] sc_time p_Delay The link delay
+     * \public
+     */
+    LocalLink(sc_module_name p_ModuleName, sc_time p_Delay);
+
+    ~LocalLink();
+
+    /*! \brief Sends a packet to the peer
+     * \details Never blocks, the packet is held for the link delay
+     * \public
+     */
+    virtual bool forward(Packet p_Packet);
+
+    virtual void interfaceDown(void);
+
+    virtual void interfaceUp(void);
+
+    /*! \brief Forwards the packets when their delay has passed
+     * \public
+     */
+    void deliver(void);
+
+    SC_HAS_PROCESS(LocalLink);
+
+private:
+
+    /*! \brief Packets on the link and the times they are due
+     * \details In time order, as the delay is constant
+     * \private
+     */
+    deque<pair<sc_time, Packet> > m_Pending;
+
+    sc_event m_Arrival;
+
+    sc_time m_Delay;
+
+    bool m_LinkState;
+};
+
+
+#endif /* _LOCALLINK_H_ */
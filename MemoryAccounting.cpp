@@ -0,0 +1,325 @@
+/*! \file MemoryAccounting.cpp
+ *  \brief     Implementation of the memory accounting.
+ *  \details
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 20:02:47 2026
+ */
+
+
+#include "MemoryAccounting.hpp"
+#include <new>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+
+thread_local MemoryAccounting::ThreadCounters* MemoryAccounting::t_Counters = NULL;
+
+thread_local int MemoryAccounting::t_Router = MEMORY_NO_ROUTER;
+
+thread_local int MemoryAccounting::t_Tag = MEMORY_OTHER;
+
+atomic<MemoryAccounting::ThreadCounters*> MemoryAccounting::s_Threads(NULL);
+
+mutex MemoryAccounting::s_Mutex;
+
+
+void MemoryAccounting::add(int p_Router, int p_Tag, int64_t p_Bytes, int64_t p_Objects)
+{
+    size_t l_Row = p_Router < MEMORY_NO_ROUTER ? 0 : (size_t)(p_Router + 1);
+    ThreadCounters* l_Counters = getCounters(l_Row);
+
+    //a table that cannot grow leaves the allocation uncounted
+    if (l_Counters == NULL || l_Row >= l_Counters->m_Rows)
+        return;
+
+    Counter& l_Counter = l_Counters->m_Counters[l_Row * MEMORY_TAG_COUNT + p_Tag];
+    l_Counter.m_Bytes.store(l_Counter.m_Bytes.load(memory_order_relaxed) + p_Bytes, memory_order_relaxed);
+    l_Counter.m_Objects.store(l_Counter.m_Objects.load(memory_order_relaxed) + p_Objects, memory_order_relaxed);
+}
+
+int MemoryAccounting::getRouter(void)
+{
+    return t_Router;
+}
+
+int MemoryAccounting::getTag(void)
+{
+    return t_Tag;
+}
+
+int64_t MemoryAccounting::getBytes(int p_Router, int p_Tag)
+{
+    size_t l_Rows = countRows();
+    vector<int64_t> l_Sums(l_Rows * MEMORY_TAG_COUNT * 2);
+    int64_t l_Bytes = 0;
+
+    sum(l_Rows, l_Sums.data());
+    for (size_t l_Row = 0; l_Row < l_Rows; ++l_Row)
+        if (p_Router == MEMORY_ALL_ROUTERS || l_Row == (size_t)(p_Router + 1))
+            l_Bytes += l_Sums[(l_Row * MEMORY_TAG_COUNT + p_Tag) * 2];
+    return l_Bytes;
+}
+
+int64_t MemoryAccounting::getObjects(int p_Router, int p_Tag)
+{
+    size_t l_Rows = countRows();
+    vector<int64_t> l_Sums(l_Rows * MEMORY_TAG_COUNT * 2);
+    int64_t l_Objects = 0;
+
+    sum(l_Rows, l_Sums.data());
+    for (size_t l_Row = 0; l_Row < l_Rows; ++l_Row)
+        if (p_Router == MEMORY_ALL_ROUTERS || l_Row == (size_t)(p_Router + 1))
+            l_Objects += l_Sums[(l_Row * MEMORY_TAG_COUNT + p_Tag) * 2 + 1];
+    return l_Objects;
+}
+
+void MemoryAccounting::report(ostream& p_Output)
+{
+    size_t l_Rows = countRows();
+    vector<int64_t> l_Sums(l_Rows * MEMORY_TAG_COUNT * 2);
+    vector<pair<int64_t, size_t> > l_Routers;
+    int64_t l_Total[MEMORY_TAG_COUNT][2] = {};
+
+    sum(l_Rows, l_Sums.data());
+    for (size_t l_Row = 0; l_Row < l_Rows; ++l_Row)
+        {
+            int64_t l_Bytes = 0;
+            for (int l_Tag = 0; l_Tag < MEMORY_TAG_COUNT; ++l_Tag)
+                {
+                    l_Total[l_Tag][0] += l_Sums[(l_Row * MEMORY_TAG_COUNT + l_Tag) * 2];
+                    l_Total[l_Tag][1] += l_Sums[(l_Row * MEMORY_TAG_COUNT + l_Tag) * 2 + 1];
+                    l_Bytes += l_Sums[(l_Row * MEMORY_TAG_COUNT + l_Tag) * 2];
+                }
+            if (l_Row > 0)
+                l_Routers.push_back(make_pair(l_Bytes, l_Row));
+        }
+
+    p_Output << "Memory by subsystem (bytes / objects):" << endl;
+    for (int l_Tag = 0; l_Tag < MEMORY_TAG_COUNT; ++l_Tag)
+        p_Output << "  " << getTagName(l_Tag) << ": " << l_Total[l_Tag][0] << " / " << l_Total[l_Tag][1] << endl;
+
+    //the largest routers first
+    size_t l_Listed = min(l_Routers.size(), (size_t)MEMORY_REPORT_ROUTERS);
+    partial_sort(l_Routers.begin(), l_Routers.begin() + l_Listed, l_Routers.end(), greater<pair<int64_t, size_t> >());
+    for (size_t i = 0; i < l_Listed; ++i)
+        {
+            size_t l_Row = l_Routers[i].second;
+            p_Output << "Router " << l_Row - 1 << ": " << l_Routers[i].first << " bytes";
+            for (int l_Tag = 0; l_Tag < MEMORY_TAG_COUNT; ++l_Tag)
+                p_Output << ", " << getTagName(l_Tag) << " " << l_Sums[(l_Row * MEMORY_TAG_COUNT + l_Tag) * 2];
+            p_Output << endl;
+        }
+}
+
+const char* MemoryAccounting::getTagName(int p_Tag)
+{
+    static const char* const s_Names[MEMORY_TAG_COUNT] = {"other", "modules", "FIFOs", "sessions", "RIB", "FIB", "packets"};
+
+    return p_Tag >= 0 && p_Tag < MEMORY_TAG_COUNT ? s_Names[p_Tag] : "unknown";
+}
+
+
+MemoryAccounting::ThreadCounters* MemoryAccounting::getCounters(size_t p_Row)
+{
+    if (t_Counters != NULL && p_Row < t_Counters->m_Rows)
+        return t_Counters;
+
+    //the tables are allocated with calloc, as operator new counts
+    //through this function
+    lock_guard<mutex> l_Lock(s_Mutex);
+
+    if (t_Counters == NULL)
+        {
+            ThreadCounters* l_Counters = (ThreadCounters*)calloc(1, sizeof(ThreadCounters));
+            if (l_Counters == NULL)
+                return NULL;
+            l_Counters->m_Next = s_Threads.load();
+            s_Threads.store(l_Counters);
+            t_Counters = l_Counters;
+        }
+
+    //grow to twice the rows so that the routers built in order
+    //grow the table rarely
+    size_t l_Rows = max(p_Row + 1, t_Counters->m_Rows * 2);
+    Counter* l_Table = (Counter*)calloc(l_Rows * MEMORY_TAG_COUNT, sizeof(Counter));
+    if (l_Table == NULL)
+        return t_Counters;
+    if (t_Counters->m_Counters != NULL)
+        memcpy((void*)l_Table, (void*)t_Counters->m_Counters, t_Counters->m_Rows * MEMORY_TAG_COUNT * sizeof(Counter));
+    free(t_Counters->m_Counters);
+    t_Counters->m_Counters = l_Table;
+    t_Counters->m_Rows = l_Rows;
+    return t_Counters;
+}
+
+void MemoryAccounting::sum(size_t p_Rows, int64_t* p_Sums)
+{
+    lock_guard<mutex> l_Lock(s_Mutex);
+
+    memset(p_Sums, 0, p_Rows * MEMORY_TAG_COUNT * 2 * sizeof(int64_t));
+    for (ThreadCounters* l_Thread = s_Threads.load(); l_Thread != NULL; l_Thread = l_Thread->m_Next)
+        for (size_t i = 0; i < min(p_Rows, l_Thread->m_Rows) * MEMORY_TAG_COUNT; ++i)
+            {
+                p_Sums[i * 2] += l_Thread->m_Counters[i].m_Bytes.load(memory_order_relaxed);
+                p_Sums[i * 2 + 1] += l_Thread->m_Counters[i].m_Objects.load(memory_order_relaxed);
+            }
+}
+
+size_t MemoryAccounting::countRows(void)
+{
+    lock_guard<mutex> l_Lock(s_Mutex);
+    size_t l_Rows = 0;
+
+    for (ThreadCounters* l_Thread = s_Threads.load(); l_Thread != NULL; l_Thread = l_Thread->m_Next)
+        l_Rows = max(l_Rows, l_Thread->m_Rows);
+    return l_Rows;
+}
+
+
+MemoryScope::MemoryScope(int p_Router, int p_Tag):m_Router(MemoryAccounting::t_Router), m_Tag(MemoryAccounting::t_Tag)
+{
+    MemoryAccounting::t_Router = p_Router;
+    MemoryAccounting::t_Tag = p_Tag;
+}
+
+MemoryScope::MemoryScope(int p_Tag):m_Router(MemoryAccounting::t_Router), m_Tag(MemoryAccounting::t_Tag)
+{
+    MemoryAccounting::t_Tag = p_Tag;
+}
+
+MemoryScope::~MemoryScope()
+{
+    MemoryAccounting::t_Router = m_Router;
+    MemoryAccounting::t_Tag = m_Tag;
+}
+
+
+#if MEMORY_ACCOUNTING
+
+/*! \brief The header in front of each accounted heap block
+ * \details Keeps the blocks aligned to 16 bytes
+ */
+struct MemoryHeader
+{
+    uint64_t m_Bytes;
+    int32_t m_Router;
+    int32_t m_Tag;
+};
+
+/*! \brief Fills the header in front of a block and counts the block
+ * \return <void*> The block
+ */
+static void* countBlock(MemoryHeader* p_Header, size_t p_Bytes)
+{
+    p_Header->m_Bytes = p_Bytes;
+    p_Header->m_Router = MemoryAccounting::getRouter();
+    p_Header->m_Tag = MemoryAccounting::getTag();
+    MemoryAccounting::add(p_Header->m_Router, p_Header->m_Tag, (int64_t)p_Bytes, 1);
+    return p_Header + 1;
+}
+
+/*! \brief Takes a block back from the counters
+ * \return <MemoryHeader*> The header of the block
+ */
+static MemoryHeader* uncountBlock(void* p_Block)
+{
+    MemoryHeader* l_Header = (MemoryHeader*)p_Block - 1;
+
+    MemoryAccounting::add(l_Header->m_Router, l_Header->m_Tag, -(int64_t)l_Header->m_Bytes, -1);
+    return l_Header;
+}
+
+/*! \brief The offset of an over-aligned block from the start of its
+ * allocation, which leaves room for the header and keeps the alignment
+ */
+static size_t alignedOffset(align_val_t p_Alignment)
+{
+    return max((size_t)p_Alignment, sizeof(MemoryHeader));
+}
+
+void* operator new(size_t p_Bytes)
+{
+    MemoryHeader* l_Header = (MemoryHeader*)malloc(sizeof(MemoryHeader) + p_Bytes);
+
+    if (l_Header == NULL)
+        throw bad_alloc();
+    return countBlock(l_Header, p_Bytes);
+}
+
+void* operator new(size_t p_Bytes, const nothrow_t&) noexcept
+{
+    try
+        {
+            return operator new(p_Bytes);
+        }
+    catch (...)
+        {
+            return NULL;
+        }
+}
+
+//the array forms of the library call the scalar forms
+
+void* operator new(size_t p_Bytes, align_val_t p_Alignment)
+{
+    //aligned_alloc wants a multiple of the alignment
+    size_t l_Offset = alignedOffset(p_Alignment);
+    size_t l_Size = (l_Offset + p_Bytes + l_Offset - 1) / l_Offset * l_Offset;
+    char* l_Start = (char*)aligned_alloc(l_Offset, l_Size);
+
+    if (l_Start == NULL)
+        throw bad_alloc();
+    return countBlock((MemoryHeader*)(l_Start + l_Offset) - 1, p_Bytes);
+}
+
+void* operator new(size_t p_Bytes, align_val_t p_Alignment, const nothrow_t&) noexcept
+{
+    try
+        {
+            return operator new(p_Bytes, p_Alignment);
+        }
+    catch (...)
+        {
+            return NULL;
+        }
+}
+
+void operator delete(void* p_Block) noexcept
+{
+    if (p_Block == NULL)
+        return;
+    free(uncountBlock(p_Block));
+}
+
+void operator delete(void* p_Block, const nothrow_t&) noexcept
+{
+    operator delete(p_Block);
+}
+
+void operator delete(void* p_Block, size_t) noexcept
+{
+    operator delete(p_Block);
+}
+
+void operator delete(void* p_Block, align_val_t p_Alignment) noexcept
+{
+    if (p_Block == NULL)
+        return;
+    uncountBlock(p_Block);
+    free((char*)p_Block - alignedOffset(p_Alignment));
+}
+
+void operator delete(void* p_Block, align_val_t p_Alignment, const nothrow_t&) noexcept
+{
+    operator delete(p_Block, p_Alignment);
+}
+
+void operator delete(void* p_Block, size_t, align_val_t p_Alignment) noexcept
+{
+    operator delete(p_Block, p_Alignment);
+}
+
+#endif
@@ -0,0 +1,270 @@
+/*! \file  MemoryAccounting.hpp
+ *  \brief     Accounting of the memory by subsystem and by router
+ *  \details   Defines the MemoryAccounting counters and the MemoryScope
+ *  that tags the allocations.
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 20:02:47 2026
+ */
+
+/*!
+ * \class MemoryAccounting
+ * \brief Counts the bytes and the objects allocated by each subsystem
+ * of each router
+ *  \details Every allocation is charged to the router and the
+ * subsystem (MemoryTag) of the MemoryScope that is open when it is
+ * made. With MEMORY_ACCOUNTING the global operator new and delete,
+ * with their aligned and sized forms, are replaced so that each heap
+ * block carries its router and tag, and
+ * delete takes it back from the same counters. The HugePageArena
+ * charges its mappings likewise.
+ *
+ * The counters are kept per thread, so the threads never share a
+ * counter on the allocation path. A report sums the threads, which
+ * is why the counters of a single thread can be negative: a block may
+ * be released by a thread other than the one that allocated it.
+ *
+ * A scope shall not be left open over a wait(), as the SystemC
+ * processes share the thread and the next process would inherit it.
+ */
+
+
+#include <ostream>
+#include <atomic>
+#include <mutex>
+#include <cstddef>
+#include <stdint.h>
+
+
+using namespace std;
+
+#ifndef _MEMORYACCOUNTING_H_
+#define _MEMORYACCOUNTING_H_
+
+
+/*! \def MEMORY_ACCOUNTING
+ *  \brief Defines whether the heap allocations are accounted, 0 or 1
+ */
+#ifndef MEMORY_ACCOUNTING
+#define MEMORY_ACCOUNTING 1
+#endif
+
+/*! \def MEMORY_NO_ROUTER
+ *  \brief Defines the router of the allocations made outside routers
+ */
+#define MEMORY_NO_ROUTER -1
+
+/*! \def MEMORY_ALL_ROUTERS
+ *  \brief Defines the router that stands for the sum of every router
+ */
+#define MEMORY_ALL_ROUTERS -2
+
+/*! \def MEMORY_REPORT_ROUTERS
+ *  \brief Defines the number of the largest routers listed in a report
+ */
+#define MEMORY_REPORT_ROUTERS 10
+
+
+/*! \brief The subsystems the memory is charged to
+ */
+enum MemoryTag
+{
+    MEMORY_OTHER,
+    MEMORY_MODULE,
+    MEMORY_FIFO,
+    MEMORY_SESSION,
+    MEMORY_RIB,
+    MEMORY_FIB,
+    MEMORY_PACKET,
+    MEMORY_TAG_COUNT
+};
+
+
+
+class MemoryAccounting
+{
+
+public:
+
+    /*! \brief Charges an allocation or, with negative counts, a release
+     * @param[in] int p_Router The router index or MEMORY_NO_ROUTER
+     * @param[in] int p_Tag The MemoryTag
+     * \public
+     */
+    static void add(int p_Router, int p_Tag, int64_t p_Bytes, int64_t p_Objects);
+
+    /*! \brief The router of the open scope
+     * \public
+     */
+    static int getRouter(void);
+
+    /*! \brief The tag of the open scope
+     * \public
+     */
+    static int getTag(void);
+
+    /*! \brief Number of bytes held by a subsystem of a router
+     * @param[in] int p_Router The router index, MEMORY_NO_ROUTER or
+     * MEMORY_ALL_ROUTERS
+     * \public
+     */
+    static int64_t getBytes(int p_Router, int p_Tag);
+
+    static int64_t getObjects(int p_Router, int p_Tag);
+
+    /*! \brief Prints the totals of the subsystems and the subsystems
+     * of the MEMORY_REPORT_ROUTERS largest routers
+     * \public
+     */
+    static void report(ostream& p_Output);
+
+    /*! \brief Name of a MemoryTag
+     * \public
+     */
+    static const char* getTagName(int p_Tag);
+
+private:
+
+    friend class MemoryScope;
+
+    struct Counter
+    {
+        atomic<int64_t> m_Bytes;
+        atomic<int64_t> m_Objects;
+    };
+
+    /*! \brief The counters of a thread
+     * \details A row of MEMORY_TAG_COUNT counters for each router, the
+     * first row is MEMORY_NO_ROUTER. The tables are never freed, so a
+     * report still sees the counts of the threads that have exited.
+     * \private
+     */
+    struct ThreadCounters
+    {
+        ThreadCounters* m_Next;
+
+        size_t m_Rows;
+
+        Counter* m_Counters;
+    };
+
+    /*! \brief Returns the thread's counters with a row for the router
+     * \private
+     */
+    static ThreadCounters* getCounters(size_t p_Row);
+
+    /*! \brief Sums the counters of every thread into p_Sums
+     * \details p_Sums holds the bytes and the objects of each counter
+     * of the first p_Rows rows
+     * \private
+     */
+    static void sum(size_t p_Rows, int64_t* p_Sums);
+
+    static size_t countRows(void);
+
+    static thread_local ThreadCounters* t_Counters;
+
+    static thread_local int t_Router;
+
+    static thread_local int t_Tag;
+
+    static atomic<ThreadCounters*> s_Threads;
+
+    /*! \brief Held while a table grows and while the tables are read
+     * \private
+     */
+    static mutex s_Mutex;
+};
+
+
+/*!
+ * \class MemoryScope
+ * \brief Charges the allocations of a block of code to a router and a
+ * subsystem
+ *  \details The scopes nest, the previous one is restored when the
+ * scope ends
+ */
+class MemoryScope
+{
+
+public:
+
+    MemoryScope(int p_Router, int p_Tag);
+
+    /*! \brief Changes the subsystem and keeps the router
+     * \public
+     */
+    explicit MemoryScope(int p_Tag);
+
+    ~MemoryScope();
+
+private:
+
+    int m_Router;
+
+    int m_Tag;
+};
+
+
+/*!
+ * \class TaggedAllocator
+ * \brief Standard allocator that charges a container to a subsystem
+ *  \details The router is the one of the scope open when the container
+ * is built, so the container keeps being charged to it when it grows
+ * later in the simulation
+ */
+template <class T, int TAG>
+class TaggedAllocator
+{
+
+public:
+
+    typedef T value_type;
+
+    template <class U>
+    struct rebind
+    {
+        typedef TaggedAllocator<U, TAG> other;
+    };
+
+    TaggedAllocator(void):m_Router(MemoryAccounting::getRouter()){};
+
+    template <class U>
+    TaggedAllocator(const TaggedAllocator<U, TAG>& p_Other):m_Router(p_Other.getRouter()){};
+
+    T* allocate(size_t p_Count)
+    {
+        MemoryScope l_Scope(m_Router, TAG);
+
+        return static_cast<T*>(::operator new(p_Count * sizeof(T)));
+    }
+
+    void deallocate(T* p_Block, size_t)
+    {
+        ::operator delete(p_Block);
+    }
+
+    int getRouter(void) const
+    {
+        return m_Router;
+    }
+
+private:
+
+    int m_Router;
+};
+
+template <class T, class U, int TAG>
+bool operator==(const TaggedAllocator<T, TAG>&, const TaggedAllocator<U, TAG>&)
+{
+    return true;
+}
+
+template <class T, class U, int TAG>
+bool operator!=(const TaggedAllocator<T, TAG>&, const TaggedAllocator<U, TAG>&)
+{
+    return false;
+}
+
+
+#endif /* _MEMORYACCOUNTING_H_ */
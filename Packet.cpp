@@ -8,41 +8,45 @@
 
 
 #include "Packet.hpp"
+#include "MemoryAccounting.hpp"
 
 
 
 
 
-Packet::Packet(void)
+Packet::Packet(void):m_Trace(NULL)
 {
 
     m_ProtocolType = 0;
-    m_IPPayload = 0;
+    m_DestinationAddress = 0;
 
 }
 
 Packet::~Packet(void)
 {
+    delete m_Trace;
 }
 
-Packet::Packet(const Packet& p_Packet)
+Packet::Packet(const Packet& p_Packet):m_Trace(NULL)
 {
     *this = p_Packet;
 }
 
 
-Packet::Packet(BGPMessage& p_BGPPayload, int p_ProtocolType)
+Packet::Packet(BGPMessage& p_BGPPayload, int p_ProtocolType):m_Trace(NULL)
 {
-    m_BGPPayload = p_BGPPayload;
+    writablePayload().m_BGPPayload = p_BGPPayload;
     m_ProtocolType = p_ProtocolType;
+    m_DestinationAddress = 0;
 
 
 }
 
-Packet::Packet(sc_bv<MTU> p_IPPayload, int p_ProtocolType)
+Packet::Packet(const unsigned char* p_IPPayload, int p_Length, int p_ProtocolType):m_Trace(NULL)
 {
     m_ProtocolType = p_ProtocolType;
-    m_IPPayload = p_IPPayload;
+    setIPPayload(p_IPPayload, p_Length);
+    m_DestinationAddress = 0;
 
 }
 
@@ -54,27 +58,41 @@ bool Packet::setProtocolType(int p_ProtocolType)
 
 void Packet::setBGPPayload(BGPMessage& p_BGPPayload)
 {
-    m_BGPPayload = p_BGPPayload;
+    writablePayload().m_BGPPayload = p_BGPPayload;
+    updateTrace();
 }
 
-void Packet::setIPPayload(sc_bv<MTU> p_IPPayload)
+void Packet::setIPPayload(const unsigned char* p_IPPayload, int p_Length)
 {
-    m_IPPayload = p_IPPayload;
+    PacketPayload& l_Payload = writablePayload();
+
+    if (p_Length > IP_PAYLOAD_BYTES)
+        p_Length = IP_PAYLOAD_BYTES;
+    if (p_Length < 0)
+        p_Length = 0;
+    memcpy(l_Payload.m_IPPayload, p_IPPayload, p_Length);
+    memset(l_Payload.m_IPPayload + p_Length, 0, IP_PAYLOAD_BYTES - p_Length);
+    updateTrace();
 }
 
+void Packet::setDestination(uint32_t p_DestinationAddress)
+{
+    m_DestinationAddress = p_DestinationAddress;
+}
 
 
 
-sc_bv<MTU> Packet::getIPPayload(void)
+
+const unsigned char* Packet::getIPPayload(void) const
 {
 
-    return m_IPPayload;
+    return payload().m_IPPayload;
 }
 
-BGPMessage& Packet::getBGPPayload(void)
+const BGPMessage& Packet::getBGPPayload(void) const
 {
 
-    return m_BGPPayload;
+    return payload().m_BGPPayload;
 }
 
 int Packet::getProtocolType(void)
@@ -82,21 +100,61 @@ int Packet::getProtocolType(void)
     return m_ProtocolType;
 }
 
+uint32_t Packet::getDestination(void)
+{
+    return m_DestinationAddress;
+}
+
 
 bool Packet::operator == (const Packet& p_Packet) const {
-    return (p_Packet.m_IPPayload == m_IPPayload && p_Packet.m_BGPPayload == m_BGPPayload && p_Packet.m_ProtocolType == m_ProtocolType );
+    if (p_Packet.m_ProtocolType != m_ProtocolType || p_Packet.m_DestinationAddress != m_DestinationAddress)
+        return false;
+    //replicas share the payload
+    if (p_Packet.m_Payload == m_Payload)
+        return true;
+    return (memcmp(p_Packet.payload().m_IPPayload, payload().m_IPPayload, IP_PAYLOAD_BYTES) == 0 && p_Packet.payload().m_BGPPayload == payload().m_BGPPayload);
 }
 
 Packet& Packet::operator = (const Packet& p_Packet) {
-    m_BGPPayload = p_Packet.m_BGPPayload;
-    m_IPPayload = p_Packet.m_IPPayload;
+    m_Payload = p_Packet.m_Payload;
     m_ProtocolType = p_Packet.m_ProtocolType;
+    m_DestinationAddress = p_Packet.m_DestinationAddress;
+    updateTrace();
     return *this;
 }
 
 
+const PacketPayload& Packet::payload(void) const
+{
+    static const PacketPayload s_Empty;
 
+    return m_Payload ? *m_Payload : s_Empty;
+}
 
+PacketPayload& Packet::writablePayload(void)
+{
+    MemoryScope l_Scope(MEMORY_PACKET);
 
+    if (!m_Payload)
+        m_Payload = std::make_shared<PacketPayload>();
+    else if (m_Payload.use_count() > 1)
+        m_Payload = std::make_shared<PacketPayload>(*m_Payload);
+    return *m_Payload;
+}
 
+sc_bv<MTU> Packet::toBitVector(const unsigned char* p_IPPayload)
+{
+    sc_bv<MTU> l_Bits;
 
+    for (int i = 0; i < MTU; ++i)
+        l_Bits[i] = ((p_IPPayload[i / 8] >> (i % 8)) & 1) != 0;
+    return l_Bits;
+}
+
+void Packet::updateTrace(void) const
+{
+    if (m_Trace == NULL)
+        return;
+    m_Trace->m_IPPayload = toBitVector(payload().m_IPPayload);
+    m_Trace->m_BGPPayload = payload().m_BGPPayload;
+}
@@ -8,10 +8,17 @@
 
 /*! \class Packet
  *  \brief     
- *  \details   
+ *  \details   The payload of the packet is held in a reference
+ *  counted PacketPayload object. Copying a packet copies only the
+ *  header fields and the payload reference, so the replicas of a
+ *  multicast or flooded packet share one payload. The payload is
+ *  copied only when a replica modifies it.
  */
 
 #include <systemc>
+#include <memory>
+#include <cstring>
+#include <stdint.h>
 #include "BGPMessage.hpp"
 
 
@@ -22,6 +29,7 @@ using std::string;
 using sc_core::sc_trace_file;
 using sc_core::sc_trace;
 using sc_dt::sc_bv;
+using std::shared_ptr;
 
 
 #ifndef PACKET_H
@@ -29,6 +37,62 @@ using sc_dt::sc_bv;
 
 #define MTU 192
 
+/*! \def IP_PAYLOAD_BYTES
+ *  \brief Length of the IP packet fragment in bytes
+ */
+#define IP_PAYLOAD_BYTES (MTU / 8)
+
+/*! \def IP_PROTOCOL
+ *  \brief Protocol type of a packet that carries an IP payload
+ */
+#define IP_PROTOCOL 0
+
+/*! \def BGP_PROTOCOL
+ *  \brief Protocol type of a packet that carries a BGP message
+ */
+#define BGP_PROTOCOL 1
+
+
+/*! \class PacketPayload
+ *  \brief     The payload shared by the replicas of a packet
+ */
+class PacketPayload
+{
+
+public:
+
+    PacketPayload(){ memset(m_IPPayload, 0, sizeof(m_IPPayload)); };
+
+    /*! \brief Holds the BGP message object
+     */
+    BGPMessage m_BGPPayload;
+
+    /*! \brief Holds the IP packet as raw bytes
+     * \details The MTU defines the length of the packet fragment in
+     * bits
+     */
+    unsigned char m_IPPayload[IP_PAYLOAD_BYTES];
+};
+
+
+/*! \class PacketTrace
+ *  \brief     The payload of a traced packet in SystemC datatypes
+ *  \details   The trace file reads the traced fields at their
+ *  addresses during the whole simulation, so a traced packet keeps its
+ *  own copy of the payload, which is refreshed whenever the packet's
+ *  payload changes.
+ */
+struct PacketTrace
+{
+    /*! \brief The IP payload as bit string, the bit 0 is the lowest
+     * bit of the first byte
+     */
+    sc_bv<MTU> m_IPPayload;
+
+    BGPMessage m_BGPPayload;
+};
+
+
 class Packet
 {
  
@@ -70,11 +134,12 @@ public:
     /*!
      * \brief Constructor with member data.
      * \details Initiates the packet data and all the id fields to given values.
-     * @param[in] sc_bv<MTU> p_IPPayload The IP packet as bit string
+     * @param[in] const unsigned char* p_IPPayload The IP packet bytes
+     * @param[in] int p_Length The number of bytes in p_IPPayload
      * @param[in] int p_ProtocolType The upper layer protocol type carried in the payload
      * \public
      */
-    Packet(sc_bv<MTU> p_IPPayload, int p_ProtocolType);
+    Packet(const unsigned char* p_IPPayload, int p_Length, int p_ProtocolType);
 
 
     /*!
@@ -88,10 +153,13 @@ public:
 
     /*!
      * \brief Set IP packet as payload
-     * @param[in] sc_bv<MTU> p_IPPayload IP packet as bit string
+     * \details At most IP_PAYLOAD_BYTES are copied and the rest of
+     * the payload is zeroed
+     * @param[in] const unsigned char* p_IPPayload The IP packet bytes
+     * @param[in] int p_Length The number of bytes in p_IPPayload
      * \public
      */
-    void setIPPayload(sc_bv<MTU> p_IPPayload);
+    void setIPPayload(const unsigned char* p_IPPayload, int p_Length);
 
 
     /*!
@@ -102,12 +170,20 @@ public:
      */
     bool setProtocolType(int p_ProtocolType);
 
+    /*!
+     * \brief Set the destination address of the IP packet
+     * @param[in] uint32_t p_DestinationAddress The destination address
+     * \public
+     */
+    void setDestination(uint32_t p_DestinationAddress);
+
     /*!
      * \brief Get IP packet
-     * \return \b <sc_bv<int>> The IP packet as bit string
+     * \return \b <const unsigned char*> The IP_PAYLOAD_BYTES long
+     * IP packet
      * \public
      */
-    sc_bv<MTU> getIPPayload(void);
+    const unsigned char* getIPPayload(void) const;
 
 
     /*!
@@ -115,7 +191,7 @@ public:
      * \return \b BGPMessage& Reference to BGP message object
      * \public
      */
-    BGPMessage& getBGPPayload(void);
+    const BGPMessage& getBGPPayload(void) const;
 
 
     /*!
@@ -125,6 +201,14 @@ public:
      */
     int getProtocolType(void);
 
+    /*!
+     * \brief Get the destination address of the IP packet
+     * \return \b uint32_t The destination address used in the
+     * route resolution
+     * \public
+     */
+    uint32_t getDestination(void);
+
     /*!
      * \brief Overload of compare operator
      * \details Compare the data fields of this Packet-object to the onces in the given Packet-object.
@@ -154,13 +238,13 @@ public:
     inline friend ostream& operator << (ostream& os,  Packet const & p_Packet )
     {   
 
-        os  << "BGP_Payload: " << p_Packet.m_BGPPayload << ", IP_Payload: " << p_Packet.m_IPPayload << ", Protocol type: " << p_Packet.m_ProtocolType;
+        os  << "BGP_Payload: " << p_Packet.payload().m_BGPPayload << ", IP_Payload: " << toBitVector(p_Packet.payload().m_IPPayload) << ", Destination: " << p_Packet.m_DestinationAddress << ", Protocol type: " << p_Packet.m_ProtocolType;
         return os;
     }
 
     /*! \relates sc_trace_file
      * \brief Set trace file for this packet
-     * \details All the member fields shall be traced. Allow systemC library to access the private members of this class by declaring the function as friend
+     * \details All the member fields shall be traced. The payload is traced from the packet's PacketTrace, in which the IP payload is converted to sc_bv<MTU>. Allow systemC library to access the private members of this class by declaring the function as friend
      * @param[out] p_TraceFilePointer Pointer to sc_trace_file-object
      * @param[in] p_Packet Reference to Packet-object to be traced
      * @param[in] p_TraceObjectName Name of the Packet-object
@@ -169,9 +253,14 @@ public:
     inline friend void sc_trace(sc_trace_file *p_TraceFilePointer, const Packet& p_Packet, const string & p_TraceObjectName )
     {
   
+        if (p_Packet.m_Trace == NULL)
+            p_Packet.m_Trace = new PacketTrace;
+        p_Packet.updateTrace();
+
         sc_trace(p_TraceFilePointer, p_Packet.m_ProtocolType, p_TraceObjectName + ".Protocol_Type");
-        sc_trace(p_TraceFilePointer, p_Packet.m_IPPayload, p_TraceObjectName + ".IP_Payload");
-        sc_trace(p_TraceFilePointer, p_Packet.m_BGPPayload, p_TraceObjectName + ".BGP_Payload");
+        sc_trace(p_TraceFilePointer, p_Packet.m_DestinationAddress, p_TraceObjectName + ".Destination");
+        sc_trace(p_TraceFilePointer, p_Packet.m_Trace->m_IPPayload, p_TraceObjectName + ".IP_Payload");
+        sc_trace(p_TraceFilePointer, p_Packet.m_Trace->m_BGPPayload, p_TraceObjectName + ".BGP_Payload");
     }
   
 
@@ -179,17 +268,33 @@ private:
 
 
 
-    /*! \brief Holds the BGP message object
-     * \details 
+    /*! \brief Returns the payload for reading
+     * \details A packet without a payload reads as an empty payload
      * \private
      */
-    BGPMessage m_BGPPayload;
+    const PacketPayload& payload(void) const;
 
-    /*! \brief Holds the IP packet as bit string
-     * \details The MTU defines the length of the packet fragment
+    /*! \brief Returns the payload for writing
+     * \details Allocates the payload or detaches a shared one
      * \private
      */
-    sc_bv<MTU> m_IPPayload;
+    PacketPayload& writablePayload(void);
+
+    /*! \brief Converts the IP payload bytes to a bit string
+     * \private
+     */
+    static sc_bv<MTU> toBitVector(const unsigned char* p_IPPayload);
+
+    /*! \brief Copies the payload into m_Trace, if the packet is traced
+     * \private
+     */
+    void updateTrace(void) const;
+
+    /*! \brief Holds the payload shared by the replicas
+     * \details
+     * \private
+     */
+    shared_ptr<PacketPayload> m_Payload;
 
     /*! \brief Holds the protocol type of the packet 
      * \details 
@@ -197,6 +302,19 @@ private:
      */
     int m_ProtocolType;
 
+    /*! \brief Holds the destination address of the IP packet
+     * \details
+     * \private
+     */
+    uint32_t m_DestinationAddress;
+
+    /*! \brief The payload read by the trace file
+     * \details NULL if the packet is not traced. A copy of the packet
+     * is not traced
+     * \private
+     */
+    mutable PacketTrace* m_Trace;
+
 };
 
 #endif
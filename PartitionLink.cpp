@@ -0,0 +1,163 @@
+/*! \file PartitionLink.cpp
+ *  \brief     Implementation of PartitionLink.
+ *  \details
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 16:48:30 2026
+ */
+
+
+#include "PartitionLink.hpp"
+
+
+PartitionLink::PartitionLink(sc_module_name p_ModuleName, const string& p_OutboundRing, const string& p_InboundRing, sc_time p_Delay):sc_module(p_ModuleName), m_Delay(p_Delay.value()), m_LinkState(true)
+{
+    //the receiving end removes the ring when it is done with it
+    if (!m_Outbound.open(p_OutboundRing, false) || !m_Inbound.open(p_InboundRing, true))
+        cout << name() << " cannot open the shared memory rings " << p_OutboundRing << ", " << p_InboundRing << endl;
+}
+
+PartitionLink::~PartitionLink()
+{
+}
+
+
+bool PartitionLink::forward(Packet p_Packet)
+{
+    WirePacket l_Wire;
+
+    if (!m_LinkState || !m_Outbound.isOpen())
+        return false;
+
+    toWire(p_Packet, sc_time_stamp().value() + m_Delay, l_Wire);
+    if (!m_Outbox.empty() || !m_Outbound.push(l_Wire))
+        m_Outbox.push_back(l_Wire);
+    return true;
+}
+
+void PartitionLink::interfaceDown(void)
+{
+    m_LinkState = false;
+}
+
+void PartitionLink::interfaceUp(void)
+{
+    m_LinkState = true;
+}
+
+
+void PartitionLink::flush(void)
+{
+    while (!m_Outbox.empty() && m_Outbound.push(m_Outbox.front()))
+        m_Outbox.pop_front();
+}
+
+void PartitionLink::drain(void)
+{
+    WirePacket l_Wire;
+
+    if (!m_Inbound.isOpen())
+        return;
+    while (m_Inbound.pop(l_Wire))
+        m_Pending.push_back(l_Wire);
+}
+
+void PartitionLink::deliver(uint64_t p_Now)
+{
+    Packet l_Packet;
+
+    //the peer stamps with a constant delay, so the packets are in time order
+    while (!m_Pending.empty() && m_Pending.front().m_Time <= p_Now)
+        {
+            fromWire(m_Pending.front(), l_Packet);
+            m_Pending.pop_front();
+            if (port_Output.size() > 0)
+                port_Output->forward(l_Packet);
+        }
+}
+
+void PartitionLink::publishTime(uint64_t p_Now)
+{
+    if (!m_Outbound.isOpen())
+        return;
+    if (m_Outbox.empty())
+        m_Outbound.publishTime(p_Now);
+    else
+        m_Outbound.publishTime(min(p_Now, m_Outbox.front().m_Time - m_Delay));
+}
+
+uint64_t PartitionLink::getHorizon(void) const
+{
+    if (!m_Inbound.isOpen())
+        return UINT64_MAX;
+
+    uint64_t l_PeerTime = m_Inbound.getPeerTime();
+
+    if (l_PeerTime > UINT64_MAX - m_Delay)
+        return UINT64_MAX;
+    return l_PeerTime + m_Delay;
+}
+
+void PartitionLink::finish(void)
+{
+    flush();
+    m_Outbox.clear();
+    publishTime(UINT64_MAX / 2);
+}
+
+uint64_t PartitionLink::getNextDelivery(void) const
+{
+    return m_Pending.empty() ? UINT64_MAX : m_Pending.front().m_Time;
+}
+
+uint64_t PartitionLink::getDelay(void) const
+{
+    return m_Delay;
+}
+
+bool PartitionLink::isOpen(void) const
+{
+    return m_Outbound.isOpen() && m_Inbound.isOpen();
+}
+
+
+void PartitionLink::toWire(Packet& p_Packet, uint64_t p_Time, WirePacket& p_Wire)
+{
+    const BGPMessage& l_BGPMsg = p_Packet.getBGPPayload();
+
+    memset(&p_Wire, 0, sizeof(p_Wire));
+    p_Wire.m_Time = p_Time;
+    p_Wire.m_ProtocolType = p_Packet.getProtocolType();
+    p_Wire.m_Destination = p_Packet.getDestination();
+    p_Wire.m_BGPType = (int32_t)l_BGPMsg.m_Type;
+    p_Wire.m_BGPIdentifier = l_BGPMsg.m_BGPIdentifier;
+    p_Wire.m_BGPOutboundInterface = l_BGPMsg.m_OutboundInterface;
+    p_Wire.m_BGPPrefix = l_BGPMsg.m_Prefix;
+    p_Wire.m_BGPPrefixLength = l_BGPMsg.m_PrefixLength;
+    p_Wire.m_BGPWithdraw = l_BGPMsg.m_Withdraw;
+    p_Wire.m_BGPPathLength = l_BGPMsg.m_PathLength;
+    p_Wire.m_BGPOrigin = l_BGPMsg.m_Origin;
+    p_Wire.m_BGPAggregatorAS = l_BGPMsg.m_AggregatorAS;
+    p_Wire.m_BGPAggregatorIdentifier = l_BGPMsg.m_AggregatorIdentifier;
+    memcpy(p_Wire.m_IPPayload, p_Packet.getIPPayload(), IP_PAYLOAD_BYTES);
+}
+
+void PartitionLink::fromWire(const WirePacket& p_Wire, Packet& p_Packet)
+{
+    BGPMessage l_BGPMsg;
+
+    l_BGPMsg.setType((BGPMessageType)p_Wire.m_BGPType);
+    l_BGPMsg.m_BGPIdentifier = p_Wire.m_BGPIdentifier;
+    l_BGPMsg.m_OutboundInterface = p_Wire.m_BGPOutboundInterface;
+    l_BGPMsg.m_Prefix = p_Wire.m_BGPPrefix;
+    l_BGPMsg.m_PrefixLength = p_Wire.m_BGPPrefixLength;
+    l_BGPMsg.m_Withdraw = p_Wire.m_BGPWithdraw != 0;
+    l_BGPMsg.m_PathLength = p_Wire.m_BGPPathLength;
+    l_BGPMsg.m_Origin = p_Wire.m_BGPOrigin;
+    l_BGPMsg.m_AggregatorAS = p_Wire.m_BGPAggregatorAS;
+    l_BGPMsg.m_AggregatorIdentifier = p_Wire.m_BGPAggregatorIdentifier;
+
+    p_Packet = Packet(l_BGPMsg, p_Wire.m_ProtocolType);
+    p_Packet.setIPPayload(p_Wire.m_IPPayload, IP_PAYLOAD_BYTES);
+    p_Packet.setDestination(p_Wire.m_Destination);
+}
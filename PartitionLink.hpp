@@ -0,0 +1,197 @@
+/*! \file  PartitionLink.hpp
+ *  \brief     Header file of PartitionLink module
+ *  \details
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 16:48:30 2026
+ */
+
+/*!
+ * \class PartitionLink
+ * \brief The local end of a link to a router simulated in another process
+ *  \details When a simulation is split across processes, each link
+ * between routers of different partitions is replaced at both ends by
+ * a PartitionLink. The local router forwards to the link as it would
+ * forward to the peer router's interface. The link stamps the packet
+ * with the time it is due at the peer, which is the current time plus
+ * the link delay, and passes it through a shared memory ring to the
+ * peer process. The packets coming from the peer are held until their
+ * time and then forwarded to the local router's interface through
+ * port_Output.
+ *
+ * The link does not run a process of its own. The PartitionSync
+ * module of the process moves the packets and keeps the simulation
+ * time of the process behind the time the peers allow.
+ */
+
+
+#include "systemc"
+#include <deque>
+#include <stdint.h>
+#include "Packet.hpp"
+#include "Interface_If.hpp"
+#include "ShmRing.hpp"
+
+
+using namespace std;
+using namespace sc_core;
+using namespace sc_dt;
+
+#ifndef _PARTITIONLINK_H_
+#define _PARTITIONLINK_H_
+
+
+/*!
+ * \class WirePacket
+ * \brief The plain data form of a Packet passed between processes
+ */
+struct WirePacket
+{
+    /*! \brief The time the packet is due at the peer in sc_time
+     * resolution units
+     */
+    uint64_t m_Time;
+
+    int32_t m_ProtocolType;
+
+    uint32_t m_Destination;
+
+    int32_t m_BGPType;
+
+    uint32_t m_BGPIdentifier;
+
+    int32_t m_BGPOutboundInterface;
+
+    uint32_t m_BGPPrefix;
+
+    int32_t m_BGPPrefixLength;
+
+    uint8_t m_BGPWithdraw;
+
+    int32_t m_BGPPathLength;
+
+    int32_t m_BGPOrigin;
+
+    uint32_t m_BGPAggregatorAS;
+
+    uint32_t m_BGPAggregatorIdentifier;
+
+    unsigned char m_IPPayload[IP_PAYLOAD_BYTES];
+};
+
+
+
+class PartitionLink: public sc_module, public Interface_If
+{
+
+public:
+
+    /*! \brief Delivers the packets of the peer
+     * \details Shall be bound to the local router's receiving interface
+     * \public
+     */
+    sc_port<Interface_If,1, SC_ZERO_OR_MORE_BOUND> port_Output;
+
+
+    /*!
+     * \brief Constructor
+     * \details Opens the shared memory rings of both directions
+     * @param[in] sc_module_name p_ModuleName The name of the module
+     * @param[in] string p_OutboundRing The name of the ring towards the peer
+     * @param[in] string p_InboundRing The name of the ring from the peer
+     * @param[in] sc_time p_Delay The link delay, shall be larger than
+     * the time resolution
+     * \public
+     */
+    PartitionLink(sc_module_name p_ModuleName, const string& p_OutboundRing, const string& p_InboundRing, sc_time p_Delay);
+
+    ~PartitionLink();
+
+    /*! \brief Sends a packet to the peer
+     * \details Never blocks, the packets that do not fit into the ring
+     * wait in the link until the next flush()
+     * \public
+     */
+    virtual bool forward(Packet p_Packet);
+
+    virtual void interfaceDown(void);
+
+    virtual void interfaceUp(void);
+
+
+    /*! \brief Passes the waiting packets into the outbound ring
+     * \public
+     */
+    void flush(void);
+
+    /*! \brief Moves the packets of the inbound ring into the link
+     * \public
+     */
+    void drain(void);
+
+    /*! \brief Forwards the packets due at or before p_Now
+     * @param[in] uint64_t p_Now The current time in resolution units
+     * \public
+     */
+    void deliver(uint64_t p_Now);
+
+    /*! \brief Publishes the time of this process to the peer
+     * \details The published time is held back by the packets still
+     * waiting for the outbound ring
+     * \public
+     */
+    void publishTime(uint64_t p_Now);
+
+    /*! \brief The time before which the peer sends nothing more
+     * \return <uint64_t> The peer's time plus the link delay
+     * \public
+     */
+    uint64_t getHorizon(void) const;
+
+    /*! \brief Releases the peer at the end of the simulation
+     * \details Drops the packets still waiting for the outbound ring
+     * and publishes an unbounded time
+     * \public
+     */
+    void finish(void);
+
+    /*! \brief The time of the earliest packet held for delivery
+     * \return <uint64_t> UINT64_MAX if no packet is held
+     * \public
+     */
+    uint64_t getNextDelivery(void) const;
+
+    /*! \brief The link delay in resolution units
+     * \public
+     */
+    uint64_t getDelay(void) const;
+
+    bool isOpen(void) const;
+
+private:
+
+    static void toWire(Packet& p_Packet, uint64_t p_Time, WirePacket& p_Wire);
+
+    static void fromWire(const WirePacket& p_Wire, Packet& p_Packet);
+
+    ShmRing<WirePacket> m_Outbound;
+
+    ShmRing<WirePacket> m_Inbound;
+
+    /*! \brief Packets waiting for room in the outbound ring
+     * \private
+     */
+    deque<WirePacket> m_Outbox;
+
+    /*! \brief Packets of the peer waiting for their time
+     * \private
+     */
+    deque<WirePacket> m_Pending;
+
+    uint64_t m_Delay;
+
+    bool m_LinkState;
+};
+
+
+#endif /* _PARTITIONLINK_H_ */
@@ -0,0 +1,70 @@
+/*! \file PartitionSync.cpp
+ *  \brief     Implementation of PartitionSync.
+ *  \details
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 16:48:30 2026
+ */
+
+
+#include "PartitionSync.hpp"
+#include <thread>
+
+
+PartitionSync::PartitionSync(sc_module_name p_ModuleName):sc_module(p_ModuleName), m_Quantum(UINT64_MAX)
+{
+    SC_THREAD(syncMain);
+}
+
+PartitionSync::~PartitionSync()
+{
+}
+
+
+void PartitionSync::addLink(PartitionLink* p_Link)
+{
+    m_Links.push_back(p_Link);
+    m_Quantum = min(m_Quantum, p_Link->getDelay());
+}
+
+void PartitionSync::syncMain(void)
+{
+    cout << name() << " synchronising " << m_Links.size() << " links" << endl;
+
+    if (m_Links.empty())
+        return;
+
+    while (true)
+        {
+            uint64_t l_Now = sc_time_stamp().value();
+            uint64_t l_Horizon = UINT64_MAX;
+            uint64_t l_Next = UINT64_MAX;
+
+            for (size_t i = 0; i < m_Links.size(); ++i)
+                {
+                    m_Links[i]->flush();
+                    m_Links[i]->drain();
+                    m_Links[i]->deliver(l_Now);
+                    m_Links[i]->publishTime(l_Now);
+                    l_Horizon = min(l_Horizon, m_Links[i]->getHorizon());
+                    l_Next = min(l_Next, m_Links[i]->getNextDelivery());
+                }
+
+            //the times before the horizon are safe, the horizon itself is not
+            uint64_t l_Target = min(l_Horizon - 1, l_Next);
+            if (l_Now <= UINT64_MAX - m_Quantum)
+                l_Target = min(l_Target, l_Now + m_Quantum);
+
+            if (l_Target > l_Now)
+                wait(sc_get_time_resolution() * (double)(l_Target - l_Now));
+            else
+                //hold the kernel until a peer moves its horizon
+                std::this_thread::yield();
+        }
+}
+
+void PartitionSync::end_of_simulation()
+{
+    for (size_t i = 0; i < m_Links.size(); ++i)
+        m_Links[i]->finish();
+}
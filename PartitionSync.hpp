@@ -0,0 +1,84 @@
+/*! \file  PartitionSync.hpp
+ *  \brief     Header file of PartitionSync module
+ *  \details
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 16:48:30 2026
+ */
+
+/*!
+ * \class PartitionSync
+ * \brief Synchronises the simulation time of a process with its peers
+ *  \details Every process of a partitioned simulation runs its own
+ * SystemC kernel and has one PartitionSync that serves all the
+ * PartitionLinks of the process. The synchronisation is conservative
+ * and uses the link delays as lookahead: a peer that has published
+ * time T sends nothing that is due before T plus the link delay, so
+ * the process may simulate up to, but not including, the smallest of
+ * these horizons. syncMain() waits until the next horizon or the next
+ * packet delivery, and while a horizon is not ahead of the current
+ * time it holds the kernel until the peers have advanced. The delay of
+ * every link shall be larger than the time resolution.
+ *
+ * At the end of the simulation the process publishes an unbounded
+ * time so that the peers still running are not held back by it.
+ */
+
+
+#include "systemc"
+#include <vector>
+#include "PartitionLink.hpp"
+
+
+using namespace std;
+using namespace sc_core;
+using namespace sc_dt;
+
+#ifndef _PARTITIONSYNC_H_
+#define _PARTITIONSYNC_H_
+
+
+
+
+class PartitionSync: public sc_module
+{
+
+public:
+
+    /*!
+     * \brief Constructor
+     * @param[in] sc_module_name p_ModuleName The name of the module
+     * \public
+     */
+    PartitionSync(sc_module_name p_ModuleName);
+
+    ~PartitionSync();
+
+    /*! \brief Adds a link to be served
+     * \details Shall be called during the elaboration
+     * \public
+     */
+    void addLink(PartitionLink* p_Link);
+
+    /*! \brief Moves the packets of the links and advances the time
+     * \public
+     */
+    void syncMain(void);
+
+    void end_of_simulation();
+
+    SC_HAS_PROCESS(PartitionSync);
+
+private:
+
+    vector<PartitionLink*> m_Links;
+
+    /*! \brief The longest step taken without publishing the time
+     * \details The smallest link delay
+     * \private
+     */
+    uint64_t m_Quantum;
+};
+
+
+#endif /* _PARTITIONSYNC_H_ */
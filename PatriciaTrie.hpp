@@ -0,0 +1,447 @@
+/*! \file  PatriciaTrie.hpp
+ *  \brief     Path-compressed binary trie of IPv4 prefixes
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 21:37:12 2026
+ */
+
+/*!
+ * \class PatriciaTrie
+ * \brief Map from IPv4 prefixes to values in prefix order
+ *  \details A binary trie in which the chains of single-child nodes are
+ * compressed: a node either holds a value or branches to two children,
+ * so the trie has less than two nodes per prefix and is at most 33
+ * nodes deep. The exact, the longest match and the subtree lookups
+ * thus visit O(prefix length) nodes.
+ *
+ * The walks visit the prefixes in the pre-order of the trie, which is
+ * the order of the masked prefix and then of the length (routeLess).
+ * walkCovered() visits the more specific prefixes of a prefix and
+ * walkCovering() the less specific ones, shortest first. The visitor
+ * is called as p_Visit(uint32_t p_Prefix, int p_Length, const T&
+ * p_Value) and shall not change the trie.
+ *
+ * The nodes are allocated from a SlabPool charged to the subsystem
+ * TAG. The prefixes are masked to their length; the lengths shall be
+ * 0 - 32.
+ */
+
+
+#include <stdint.h>
+#include <cstddef>
+#include <algorithm>
+#include "SlabPool.hpp"
+
+
+using namespace std;
+
+#ifndef _PATRICIATRIE_H_
+#define _PATRICIATRIE_H_
+
+
+
+template <class T, int TAG>
+class PatriciaTrie
+{
+
+public:
+
+    PatriciaTrie(void):m_Root(NULL), m_Size(0){};
+
+    PatriciaTrie(const PatriciaTrie&) = delete;
+
+    PatriciaTrie& operator=(const PatriciaTrie&) = delete;
+
+    ~PatriciaTrie()
+    {
+        clear();
+    }
+
+    /*! \brief Finds the value of a prefix
+     * \return <T*> The value or NULL
+     * \public
+     */
+    T* find(uint32_t p_Prefix, int p_Length)
+    {
+        Node* l_Node = m_Root;
+
+        p_Prefix = mask(p_Prefix, p_Length);
+        while (l_Node != NULL && l_Node->m_Length <= p_Length && mask(p_Prefix, l_Node->m_Length) == l_Node->m_Prefix)
+            {
+                if (l_Node->m_Length == p_Length)
+                    return l_Node->m_HasValue ? &l_Node->m_Value : NULL;
+                l_Node = l_Node->m_Child[bit(p_Prefix, l_Node->m_Length)];
+            }
+        return NULL;
+    }
+
+    const T* find(uint32_t p_Prefix, int p_Length) const
+    {
+        return const_cast<PatriciaTrie*>(this)->find(p_Prefix, p_Length);
+    }
+
+    /*! \brief Finds the value of the longest prefix that covers a prefix
+     * @param[in] uint32_t p_Prefix The prefix or, with the length 32, an
+     * address
+     * @param[out] int p_MatchLength The length of the matching prefix
+     * \return <T*> The value or NULL
+     * \public
+     */
+    T* findLongestMatch(uint32_t p_Prefix, int p_Length, int& p_MatchLength)
+    {
+        Node* l_Node = m_Root;
+        Node* l_Match = NULL;
+
+        p_Prefix = mask(p_Prefix, p_Length);
+        while (l_Node != NULL && l_Node->m_Length <= p_Length && mask(p_Prefix, l_Node->m_Length) == l_Node->m_Prefix)
+            {
+                if (l_Node->m_HasValue)
+                    l_Match = l_Node;
+                if (l_Node->m_Length == p_Length)
+                    break;
+                l_Node = l_Node->m_Child[bit(p_Prefix, l_Node->m_Length)];
+            }
+        if (l_Match == NULL)
+            return NULL;
+        p_MatchLength = l_Match->m_Length;
+        return &l_Match->m_Value;
+    }
+
+    /*! \brief Finds or adds a prefix
+     * \return <T&> The value, default constructed if the prefix was added
+     * \public
+     */
+    T& insert(uint32_t p_Prefix, int p_Length)
+    {
+        Node** l_Link = &m_Root;
+
+        p_Prefix = mask(p_Prefix, p_Length);
+        while (*l_Link != NULL)
+            {
+                Node* l_Node = *l_Link;
+                int l_Common = commonLength(p_Prefix, p_Length, l_Node->m_Prefix, l_Node->m_Length);
+
+                if (l_Common == l_Node->m_Length)
+                    {
+                        if (l_Node->m_Length == p_Length)
+                            return setValue(l_Node);
+                        l_Link = &l_Node->m_Child[bit(p_Prefix, l_Node->m_Length)];
+                        continue;
+                    }
+
+                //the node branches off inside the new prefix
+                Node* l_New = createNode(p_Prefix, p_Length);
+
+                if (l_Common == p_Length)
+                    {
+                        l_New->m_Child[bit(l_Node->m_Prefix, p_Length)] = l_Node;
+                        *l_Link = l_New;
+                        return setValue(l_New);
+                    }
+
+                //the prefixes differ after the common bits
+                Node* l_Branch = createNode(p_Prefix, l_Common);
+
+                l_Branch->m_Child[bit(p_Prefix, l_Common)] = l_New;
+                l_Branch->m_Child[bit(l_Node->m_Prefix, l_Common)] = l_Node;
+                *l_Link = l_Branch;
+                return setValue(l_New);
+            }
+
+        *l_Link = createNode(p_Prefix, p_Length);
+        return setValue(*l_Link);
+    }
+
+    /*! \brief Removes a prefix
+     * \return <bool> False: if the prefix was not in the trie
+     * \public
+     */
+    bool erase(uint32_t p_Prefix, int p_Length)
+    {
+        Node** l_Parent = NULL;
+        Node** l_Link = &m_Root;
+
+        p_Prefix = mask(p_Prefix, p_Length);
+        while (*l_Link != NULL && (*l_Link)->m_Length < p_Length && mask(p_Prefix, (*l_Link)->m_Length) == (*l_Link)->m_Prefix)
+            {
+                l_Parent = l_Link;
+                l_Link = &(*l_Link)->m_Child[bit(p_Prefix, (*l_Link)->m_Length)];
+            }
+
+        Node* l_Node = *l_Link;
+
+        if (l_Node == NULL || l_Node->m_Length != p_Length || l_Node->m_Prefix != p_Prefix || !l_Node->m_HasValue)
+            return false;
+        m_Size--;
+
+        //a node that branches stays without the value
+        if (l_Node->m_Child[0] != NULL && l_Node->m_Child[1] != NULL)
+            {
+                l_Node->m_HasValue = false;
+                l_Node->m_Value = T();
+                return true;
+            }
+
+        *l_Link = l_Node->m_Child[0] != NULL ? l_Node->m_Child[0] : l_Node->m_Child[1];
+        m_Pool.destroy(l_Node);
+
+        //a branch without a value is not needed for a single child
+        if (l_Parent != NULL && *l_Link == NULL && !(*l_Parent)->m_HasValue)
+            {
+                Node* l_Branch = *l_Parent;
+
+                *l_Parent = l_Branch->m_Child[0] != NULL ? l_Branch->m_Child[0] : l_Branch->m_Child[1];
+                m_Pool.destroy(l_Branch);
+            }
+        return true;
+    }
+
+    /*! \brief Replaces the content of the trie
+     * \details For loading a full table. The items have the m_Prefix
+     * and m_Length of a RouteEntry and shall be sorted by routeLess(),
+     * which is the pre-order of the trie: the trie is then built in
+     * one pass, keeping the path to the previous prefix in a stack
+     * instead of descending from the root for each prefix. Of two
+     * equal prefixes the later one is kept.
+     * @param[in] I p_Begin The first item
+     * @param[in] I p_End Past the last item
+     * @param[in] F p_Value Gives the value of an item, called as
+     * p_Value(const Item& p_Item)
+     * \return <bool> False: if the items are not sorted or a length is
+     * not valid, in which case the trie is not changed
+     * \public
+     */
+    template <class I, class F>
+    bool replaceAll(I p_Begin, I p_End, F p_Value)
+    {
+        uint64_t l_Previous = 0;
+
+        for (I it = p_Begin; it != p_End; ++it)
+            {
+                if (it->m_Length < 0 || it->m_Length > 32)
+                    return false;
+
+                uint64_t l_Key = ((uint64_t)mask(it->m_Prefix, it->m_Length) << 8) | (uint64_t)it->m_Length;
+
+                if (it != p_Begin && l_Key < l_Previous)
+                    return false;
+                l_Previous = l_Key;
+            }
+
+        clear();
+
+        //the path from the root to the previous prefix; a path has at
+        //most a branch and a prefix node for each length
+        Node* l_Path[66];
+        int l_Depth = 0;
+
+        for (I it = p_Begin; it != p_End; ++it)
+            {
+                uint32_t l_Prefix = mask(it->m_Prefix, it->m_Length);
+                int l_Length = it->m_Length;
+                Node* l_Last = NULL;
+
+                //leave the nodes that do not cover the prefix
+                while (l_Depth > 0 && !covers(l_Path[l_Depth - 1], l_Prefix, l_Length))
+                    l_Last = l_Path[--l_Depth];
+
+                if (l_Last == NULL && l_Depth > 0 && l_Path[l_Depth - 1]->m_Length == l_Length)
+                    {
+                        setValue(l_Path[l_Depth - 1]) = p_Value(*it);
+                        continue;
+                    }
+
+                Node* l_New = createNode(l_Prefix, l_Length);
+                Node** l_Link = l_Depth == 0 ? &m_Root : &l_Path[l_Depth - 1]->m_Child[bit(l_Prefix, l_Path[l_Depth - 1]->m_Length)];
+
+                //the prefix branches off the subtree left, which in
+                //pre-order neither covers it nor is covered by it
+                if (l_Last != NULL)
+                    {
+                        int l_Common = commonLength(l_Prefix, l_Length, l_Last->m_Prefix, l_Last->m_Length);
+                        int l_Parent = l_Depth == 0 ? -1 : l_Path[l_Depth - 1]->m_Length;
+
+                        if (l_Common > l_Parent)
+                            {
+                                Node* l_Branch = createNode(l_Prefix, l_Common);
+
+                                l_Branch->m_Child[bit(l_Last->m_Prefix, l_Common)] = l_Last;
+                                *l_Link = l_Branch;
+                                l_Path[l_Depth++] = l_Branch;
+                                l_Link = &l_Branch->m_Child[bit(l_Prefix, l_Common)];
+                            }
+                    }
+
+                *l_Link = l_New;
+                setValue(l_New) = p_Value(*it);
+                l_Path[l_Depth++] = l_New;
+            }
+        return true;
+    }
+
+    /*! \brief Visits every prefix in order
+     * \public
+     */
+    template <class F>
+    void walk(F p_Visit) const
+    {
+        walkNode(m_Root, p_Visit);
+    }
+
+    /*! \brief Visits in order the prefix and the prefixes it covers
+     * \public
+     */
+    template <class F>
+    void walkCovered(uint32_t p_Prefix, int p_Length, F p_Visit) const
+    {
+        const Node* l_Node = m_Root;
+
+        p_Prefix = mask(p_Prefix, p_Length);
+        while (l_Node != NULL && l_Node->m_Length < p_Length && mask(p_Prefix, l_Node->m_Length) == l_Node->m_Prefix)
+            l_Node = l_Node->m_Child[bit(p_Prefix, l_Node->m_Length)];
+
+        //the first node at least as long is the root of the covered ones
+        if (l_Node != NULL && l_Node->m_Length >= p_Length && mask(l_Node->m_Prefix, p_Length) == p_Prefix)
+            walkNode(l_Node, p_Visit);
+    }
+
+    /*! \brief Visits the prefixes that cover the prefix, shortest first,
+     * and the prefix itself
+     * \public
+     */
+    template <class F>
+    void walkCovering(uint32_t p_Prefix, int p_Length, F p_Visit) const
+    {
+        const Node* l_Node = m_Root;
+
+        p_Prefix = mask(p_Prefix, p_Length);
+        while (l_Node != NULL && l_Node->m_Length <= p_Length && mask(p_Prefix, l_Node->m_Length) == l_Node->m_Prefix)
+            {
+                if (l_Node->m_HasValue)
+                    p_Visit(l_Node->m_Prefix, (int)l_Node->m_Length, l_Node->m_Value);
+                if (l_Node->m_Length == p_Length)
+                    break;
+                l_Node = l_Node->m_Child[bit(p_Prefix, l_Node->m_Length)];
+            }
+    }
+
+    /*! \brief Number of prefixes
+     * \public
+     */
+    size_t size(void) const
+    {
+        return m_Size;
+    }
+
+    /*! \brief Number of nodes, with the branches without a value
+     * \public
+     */
+    size_t countNodes(void) const
+    {
+        return m_Pool.size();
+    }
+
+    void clear(void)
+    {
+        clearNode(m_Root);
+        m_Root = NULL;
+        m_Size = 0;
+    }
+
+private:
+
+    struct Node
+    {
+        Node(void):m_Prefix(0), m_Length(0), m_HasValue(false), m_Child{NULL, NULL}, m_Value(){};
+
+        uint32_t m_Prefix;
+
+        int m_Length;
+
+        bool m_HasValue;
+
+        Node* m_Child[2];
+
+        T m_Value;
+    };
+
+    static uint32_t mask(uint32_t p_Prefix, int p_Length)
+    {
+        return p_Length <= 0 ? 0 : p_Length >= 32 ? p_Prefix : p_Prefix & ~(0xFFFFFFFFu >> p_Length);
+    }
+
+    /*! \brief The bit after the first p_Index bits of the prefix
+     * \private
+     */
+    static int bit(uint32_t p_Prefix, int p_Index)
+    {
+        return (p_Prefix >> (31 - p_Index)) & 1;
+    }
+
+    /*! \brief Number of leading bits the two prefixes share
+     * \private
+     */
+    static int commonLength(uint32_t p_A, int p_LengthA, uint32_t p_B, int p_LengthB)
+    {
+        uint32_t l_Diff = p_A ^ p_B;
+        int l_Common = l_Diff == 0 ? 32 : __builtin_clz(l_Diff);
+
+        return min(l_Common, min(p_LengthA, p_LengthB));
+    }
+
+    /*! \brief True: the prefix of the node is the prefix or covers it
+     * \private
+     */
+    static bool covers(const Node* p_Node, uint32_t p_Prefix, int p_Length)
+    {
+        return p_Node->m_Length <= p_Length && mask(p_Prefix, p_Node->m_Length) == p_Node->m_Prefix;
+    }
+
+    Node* createNode(uint32_t p_Prefix, int p_Length)
+    {
+        Node* l_Node = m_Pool.create();
+
+        l_Node->m_Prefix = mask(p_Prefix, p_Length);
+        l_Node->m_Length = p_Length;
+        return l_Node;
+    }
+
+    T& setValue(Node* p_Node)
+    {
+        if (!p_Node->m_HasValue)
+            {
+                p_Node->m_HasValue = true;
+                m_Size++;
+            }
+        return p_Node->m_Value;
+    }
+
+    template <class F>
+    static void walkNode(const Node* p_Node, F& p_Visit)
+    {
+        if (p_Node == NULL)
+            return;
+        if (p_Node->m_HasValue)
+            p_Visit(p_Node->m_Prefix, (int)p_Node->m_Length, p_Node->m_Value);
+        walkNode(p_Node->m_Child[0], p_Visit);
+        walkNode(p_Node->m_Child[1], p_Visit);
+    }
+
+    void clearNode(Node* p_Node)
+    {
+        if (p_Node == NULL)
+            return;
+        clearNode(p_Node->m_Child[0]);
+        clearNode(p_Node->m_Child[1]);
+        m_Pool.destroy(p_Node);
+    }
+
+    SlabPool<Node, TAG> m_Pool;
+
+    Node* m_Root;
+
+    size_t m_Size;
+};
+
+
+#endif /* _PATRICIATRIE_H_ */
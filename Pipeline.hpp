@@ -0,0 +1,631 @@
+/*! \file  Pipeline.hpp
+ *  \brief     Programmable parser and match-action pipeline
+ *  \details   Defines the building blocks of the forwarding pipeline
+ *  of the DataPlane: the packet context, parser states, match keys,
+ *  actions, match-action tables and the Pipeline template that chains
+ *  them.
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 13:48:26 2026
+ */
+
+/*!
+ * \class Pipeline
+ * \brief Compile-time composed match-action pipeline
+ *  \details A pipeline is declared as a type:
+ *
+ *  \code
+ *  typedef Pipeline<Parser<ParseProtocol, ParseIPv4>,
+ *                   TernaryMatchTable<DestinationKey, DropAction>,
+ *                   ExactMatchTable<IngressKey, SetEgressAction>,
+ *                   FIBLookup> MyPipeline;
+ *  \endcode
+ *
+ * Every stage is a class with an apply(PacketContext&) member. The
+ * stages are stored by value in the pipeline and applied in the
+ * declared order by a template recursion, so the compiler sees the
+ * whole chain of calls and inlines it. There is no per-packet
+ * interpretation of the pipeline description. The tables keep their
+ * entries at run time and are managed through getStage<I>().
+ *
+ * A stage stops the rest of the pipeline by setting m_Drop or
+ * m_ToControlPlane of the context.
+ */
+
+
+#include "systemc"
+#include <map>
+#include <vector>
+#include <tuple>
+#include <algorithm>
+#include "Packet.hpp"
+#include "RoutingTable_Manage_If.hpp"
+#include "ReplicationTable.hpp"
+
+
+using namespace std;
+using namespace sc_core;
+using namespace sc_dt;
+
+#ifndef _PIPELINE_H_
+#define _PIPELINE_H_
+
+
+
+
+/*!
+ * \class PacketContext
+ * \brief The parsed header fields and the metadata of a packet
+ * \details The parser fills the header fields, the tables read them as
+ * match keys and the actions write the forwarding decision.
+ */
+class PacketContext
+{
+
+public:
+
+    PacketContext(Packet& p_Packet, int p_IngressInterface):m_Packet(p_Packet), m_IngressInterface(p_IngressInterface), m_ProtocolType(0), m_Destination(0), m_Multicast(false), m_Egress(NO_ROUTE), m_Egresses(NULL), m_Drop(false), m_ToControlPlane(false){};
+
+    /*! \brief The packet being processed
+     */
+    Packet& m_Packet;
+
+    /*! \brief Router level index of the receiving interface
+     */
+    int m_IngressInterface;
+
+    /*! \brief Parsed protocol type
+     */
+    int m_ProtocolType;
+
+    /*! \brief Parsed destination address
+     */
+    unsigned m_Destination;
+
+    /*! \brief The destination is a multicast address
+     */
+    bool m_Multicast;
+
+    /*! \brief Unicast egress interface, NO_ROUTE if not resolved
+     */
+    int m_Egress;
+
+    /*! \brief Egress list of a replicated packet, NULL if none
+     */
+    const vector<int> *m_Egresses;
+
+    /*! \brief The packet shall be dropped
+     */
+    bool m_Drop;
+
+    /*! \brief The packet shall be passed to the Control Plane
+     */
+    bool m_ToControlPlane;
+
+    /*! \brief Checks whether a stage has finished the processing
+     */
+    bool isDone(void) const
+    {
+        return m_Drop || m_ToControlPlane;
+    }
+};
+
+
+
+/************************Parser states**************************/
+
+/*!
+ * \class ParseProtocol
+ * \brief Extracts the protocol type
+ * \details Transitions to accept with m_ToControlPlane set for BGP
+ * packets, otherwise to the next state
+ */
+struct ParseProtocol
+{
+    static bool parse(PacketContext& p_Context)
+    {
+        p_Context.m_ProtocolType = p_Context.m_Packet.getProtocolType();
+        if (p_Context.m_ProtocolType == BGP_PROTOCOL)
+            {
+                p_Context.m_ToControlPlane = true;
+                return false;
+            }
+        return true;
+    }
+};
+
+/*!
+ * \class ParseIPv4
+ * \brief Extracts the destination address of an IP packet
+ */
+struct ParseIPv4
+{
+    static bool parse(PacketContext& p_Context)
+    {
+        p_Context.m_Destination = p_Context.m_Packet.getDestination();
+        p_Context.m_Multicast = (p_Context.m_Destination >> 28) == 0xE;
+        return true;
+    }
+};
+
+
+/*!
+ * \class Parser
+ * \brief Chains the parser states
+ * \details The states are run in the declared order until one of them
+ * transitions to accept by returning false.
+ */
+template <class... STATES>
+struct Parser;
+
+template <>
+struct Parser<>
+{
+    void apply(PacketContext& p_Context)
+    {
+    }
+
+    static bool parse(PacketContext& p_Context)
+    {
+        return true;
+    }
+};
+
+template <class STATE, class... STATES>
+struct Parser<STATE, STATES...>
+{
+    void apply(PacketContext& p_Context)
+    {
+        parse(p_Context);
+    }
+
+    static bool parse(PacketContext& p_Context)
+    {
+        if (!STATE::parse(p_Context))
+            return false;
+        return Parser<STATES...>::parse(p_Context);
+    }
+};
+
+
+
+/**************************Match keys***************************/
+
+/*!
+ * \class DestinationKey
+ * \brief Matches on the destination address
+ */
+struct DestinationKey
+{
+    typedef unsigned Type;
+    static const int WIDTH = 32;
+
+    static Type get(const PacketContext& p_Context)
+    {
+        return p_Context.m_Destination;
+    }
+};
+
+/*!
+ * \class IngressKey
+ * \brief Matches on the receiving interface
+ */
+struct IngressKey
+{
+    typedef unsigned Type;
+    static const int WIDTH = 32;
+
+    static Type get(const PacketContext& p_Context)
+    {
+        return (unsigned)p_Context.m_IngressInterface;
+    }
+};
+
+/*!
+ * \class ProtocolKey
+ * \brief Matches on the protocol type
+ */
+struct ProtocolKey
+{
+    typedef unsigned Type;
+    static const int WIDTH = 32;
+
+    static Type get(const PacketContext& p_Context)
+    {
+        return (unsigned)p_Context.m_ProtocolType;
+    }
+};
+
+
+
+/****************************Actions****************************/
+
+/*!
+ * \class SetEgressAction
+ * \brief Forwards the packet to the interface given as action data
+ */
+struct SetEgressAction
+{
+    typedef int Data;
+
+    static void hit(PacketContext& p_Context, const Data& p_Egress)
+    {
+        p_Context.m_Egress = p_Egress;
+    }
+
+    static void miss(PacketContext& p_Context)
+    {
+    }
+};
+
+/*!
+ * \class DropAction
+ * \brief Drops the matching packets
+ * \details The action data tells whether a matching packet is dropped
+ * (true) or permitted (false)
+ */
+struct DropAction
+{
+    typedef bool Data;
+
+    static void hit(PacketContext& p_Context, const Data& p_Drop)
+    {
+        p_Context.m_Drop = p_Drop;
+    }
+
+    static void miss(PacketContext& p_Context)
+    {
+    }
+};
+
+/*!
+ * \class ToControlPlaneAction
+ * \brief Punts the matching packets to the Control Plane
+ */
+struct ToControlPlaneAction
+{
+    typedef bool Data;
+
+    static void hit(PacketContext& p_Context, const Data& p_Punt)
+    {
+        p_Context.m_ToControlPlane = p_Punt;
+    }
+
+    static void miss(PacketContext& p_Context)
+    {
+    }
+};
+
+
+
+/*********************Match-action tables***********************/
+
+/*!
+ * \class ExactMatchTable
+ * \brief Exact match on the key
+ */
+template <class KEY, class ACTION>
+class ExactMatchTable
+{
+
+public:
+
+    typedef typename KEY::Type Key;
+    typedef typename ACTION::Data Data;
+
+    bool addEntry(Key p_Key, const Data& p_Data)
+    {
+        m_Entries[p_Key] = p_Data;
+        return true;
+    }
+
+    bool removeEntry(Key p_Key)
+    {
+        return m_Entries.erase(p_Key) > 0;
+    }
+
+    void apply(PacketContext& p_Context)
+    {
+        if (m_Entries.empty())
+            {
+                ACTION::miss(p_Context);
+                return;
+            }
+
+        typename map<Key, Data>::const_iterator l_Entry = m_Entries.find(KEY::get(p_Context));
+        if (l_Entry != m_Entries.end())
+            ACTION::hit(p_Context, l_Entry->second);
+        else
+            ACTION::miss(p_Context);
+    }
+
+private:
+
+    map<Key, Data> m_Entries;
+};
+
+
+/*!
+ * \class LpmMatchTable
+ * \brief Longest prefix match on the key
+ * \details A binary trie with index-linked nodes. The action data is
+ * stored in a separate vector, a node refers to it by index.
+ */
+template <class KEY, class ACTION>
+class LpmMatchTable
+{
+
+public:
+
+    typedef typename KEY::Type Key;
+    typedef typename ACTION::Data Data;
+
+    LpmMatchTable(void)
+    {
+        Node l_Root = {{0, 0}, -1};
+        m_Nodes.push_back(l_Root);
+    }
+
+    bool addEntry(Key p_Prefix, int p_Length, const Data& p_Data)
+    {
+        if (p_Length < 0 || p_Length > KEY::WIDTH)
+            return false;
+
+        int l_Node = 0;
+        for (int i = 0; i < p_Length; ++i)
+            {
+                int l_Bit = bit(p_Prefix, i);
+                if (m_Nodes[l_Node].m_Child[l_Bit] == 0)
+                    {
+                        Node l_New = {{0, 0}, -1};
+                        m_Nodes.push_back(l_New);
+                        m_Nodes[l_Node].m_Child[l_Bit] = (int)m_Nodes.size() - 1;
+                    }
+                l_Node = m_Nodes[l_Node].m_Child[l_Bit];
+            }
+
+        if (m_Nodes[l_Node].m_Data == -1)
+            {
+                m_Nodes[l_Node].m_Data = (int)m_Data.size();
+                m_Data.push_back(p_Data);
+            }
+        else
+            m_Data[m_Nodes[l_Node].m_Data] = p_Data;
+        return true;
+    }
+
+    void apply(PacketContext& p_Context)
+    {
+        Key l_Key = KEY::get(p_Context);
+        int l_Node = 0;
+        int l_Best = m_Nodes[0].m_Data;
+
+        for (int i = 0; i < KEY::WIDTH; ++i)
+            {
+                l_Node = m_Nodes[l_Node].m_Child[bit(l_Key, i)];
+                if (l_Node == 0)
+                    break;
+                if (m_Nodes[l_Node].m_Data != -1)
+                    l_Best = m_Nodes[l_Node].m_Data;
+            }
+
+        if (l_Best != -1)
+            ACTION::hit(p_Context, m_Data[l_Best]);
+        else
+            ACTION::miss(p_Context);
+    }
+
+private:
+
+    struct Node
+    {
+        int m_Child[2];
+        int m_Data;
+    };
+
+    static int bit(Key p_Key, int p_Index)
+    {
+        return (int)((p_Key >> (KEY::WIDTH - 1 - p_Index)) & 1);
+    }
+
+    vector<Node> m_Nodes;
+
+    vector<Data> m_Data;
+};
+
+
+/*!
+ * \class TernaryMatchTable
+ * \brief Value/mask match with priorities
+ * \details The entries are kept sorted by descending priority and the
+ * first matching entry wins.
+ */
+template <class KEY, class ACTION>
+class TernaryMatchTable
+{
+
+public:
+
+    typedef typename KEY::Type Key;
+    typedef typename ACTION::Data Data;
+
+    bool addEntry(Key p_Value, Key p_Mask, int p_Priority, const Data& p_Data)
+    {
+        Entry l_Entry;
+        l_Entry.m_Value = p_Value & p_Mask;
+        l_Entry.m_Mask = p_Mask;
+        l_Entry.m_Priority = p_Priority;
+        l_Entry.m_Data = p_Data;
+
+        typename vector<Entry>::iterator l_Position = m_Entries.begin();
+        while (l_Position != m_Entries.end() && l_Position->m_Priority >= p_Priority)
+            ++l_Position;
+        m_Entries.insert(l_Position, l_Entry);
+        return true;
+    }
+
+    void clear(void)
+    {
+        m_Entries.clear();
+    }
+
+    void apply(PacketContext& p_Context)
+    {
+        Key l_Key = KEY::get(p_Context);
+
+        for (size_t i = 0; i < m_Entries.size(); ++i)
+            if ((l_Key & m_Entries[i].m_Mask) == m_Entries[i].m_Value)
+                {
+                    ACTION::hit(p_Context, m_Entries[i].m_Data);
+                    return;
+                }
+        ACTION::miss(p_Context);
+    }
+
+private:
+
+    struct Entry
+    {
+        Key m_Value;
+        Key m_Mask;
+        int m_Priority;
+        Data m_Data;
+    };
+
+    vector<Entry> m_Entries;
+};
+
+
+
+/***************************Externs*****************************/
+
+/*!
+ * \class FIBLookup
+ * \brief Resolves the unicast egress from the line card's FIB
+ * \details Skipped for the multicast packets and for the packets whose
+ * egress an earlier stage already set. A resolved packet is counted to
+ * the traffic of the matched FIB entry, or of the entry it matches in
+ * the table set by setTrafficTable().
+ */
+class FIBLookup
+{
+
+public:
+
+    FIBLookup(void):m_FIB(NULL), m_TrafficTable(NULL){};
+
+    void setFIB(RoutingTable_Manage_If *p_FIB)
+    {
+        m_FIB = p_FIB;
+    }
+
+    /*! \brief Sets the table the traffic is counted to
+     * \details For a FIB whose entries are not the routes to report,
+     * such as a compressed one. NULL counts to the FIB
+     */
+    void setTrafficTable(RoutingTable_Manage_If *p_Table)
+    {
+        m_TrafficTable = p_Table;
+    }
+
+    void apply(PacketContext& p_Context)
+    {
+        if (!m_FIB || p_Context.m_Multicast || p_Context.m_Egress != NO_ROUTE)
+            return;
+
+        int l_Entry;
+
+        p_Context.m_Egress = m_FIB->resolveRoute(p_Context.m_Destination, l_Entry);
+        if (p_Context.m_Egress == NO_ROUTE)
+            return;
+        if (m_TrafficTable)
+            {
+                m_TrafficTable->resolveRoute(p_Context.m_Destination, l_Entry);
+                m_TrafficTable->countTraffic(l_Entry, IP_PAYLOAD_BYTES);
+            }
+        else
+            m_FIB->countTraffic(l_Entry, IP_PAYLOAD_BYTES);
+    }
+
+private:
+
+    RoutingTable_Manage_If *m_FIB;
+
+    RoutingTable_Manage_If *m_TrafficTable;
+};
+
+/*!
+ * \class MulticastLookup
+ * \brief Resolves the egress list of a multicast packet
+ */
+class MulticastLookup
+{
+
+public:
+
+    MulticastLookup(void):m_Replication(NULL){};
+
+    void setReplicationTable(const ReplicationTable *p_Replication)
+    {
+        m_Replication = p_Replication;
+    }
+
+    void apply(PacketContext& p_Context)
+    {
+        if (m_Replication && p_Context.m_Multicast)
+            p_Context.m_Egresses = m_Replication->getGroup(p_Context.m_Destination);
+    }
+
+private:
+
+    const ReplicationTable *m_Replication;
+};
+
+
+
+/***************************Pipeline****************************/
+
+template <class... STAGES>
+class Pipeline
+{
+
+public:
+
+    /*! \brief Runs the packet through every stage
+     * \public
+     */
+    void apply(PacketContext& p_Context)
+    {
+        applyFrom<0>(p_Context);
+    }
+
+    /*! \brief Access to a stage for managing its entries
+     * \public
+     */
+    template <size_t I>
+    typename tuple_element<I, tuple<STAGES...> >::type& getStage(void)
+    {
+        return std::get<I>(m_Stages);
+    }
+
+private:
+
+    template <size_t I>
+    typename enable_if<(I < sizeof...(STAGES))>::type applyFrom(PacketContext& p_Context)
+    {
+        if (p_Context.isDone())
+            return;
+        std::get<I>(m_Stages).apply(p_Context);
+        applyFrom<I + 1>(p_Context);
+    }
+
+    template <size_t I>
+    typename enable_if<(I >= sizeof...(STAGES))>::type applyFrom(PacketContext& p_Context)
+    {
+    }
+
+    tuple<STAGES...> m_Stages;
+};
+
+
+#endif /* _PIPELINE_H_ */
@@ -0,0 +1,60 @@
+/*! \file ReplicationTable.cpp
+ *  \brief     Implementation of the packet replication table.
+ *  \details
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 13:05:33 2026
+ */
+
+
+#include "ReplicationTable.hpp"
+
+
+ReplicationTable::ReplicationTable(void)
+{
+}
+
+ReplicationTable::~ReplicationTable()
+{
+}
+
+
+bool ReplicationTable::setGroup(uint32_t p_Group, const vector<int>& p_Egresses)
+{
+    if (!isMulticast(p_Group))
+        return false;
+    m_Groups[p_Group] = p_Egresses;
+    return true;
+}
+
+bool ReplicationTable::removeGroup(uint32_t p_Group)
+{
+    return m_Groups.erase(p_Group) > 0;
+}
+
+const vector<int>* ReplicationTable::getGroup(uint32_t p_Group) const
+{
+    map<unsigned, vector<int> >::const_iterator l_Group = m_Groups.find(p_Group);
+
+    if (l_Group == m_Groups.end())
+        return NULL;
+    return &l_Group->second;
+}
+
+void ReplicationTable::setFloodCount(int p_InterfaceCount)
+{
+    m_FloodList.resize(p_InterfaceCount);
+    for (int i = 0; i < p_InterfaceCount; ++i)
+        m_FloodList[i] = i;
+}
+
+const vector<int>& ReplicationTable::getFloodList(void) const
+{
+    return m_FloodList;
+}
+
+bool ReplicationTable::isMulticast(uint32_t p_Address)
+{
+    //224.0.0.0/4
+    return (p_Address >> 28) == 0xE;
+}
@@ -0,0 +1,93 @@
+/*! \file  ReplicationTable.hpp
+ *  \brief     Header file of the packet replication table
+ *  \details
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 13:05:33 2026
+ */
+
+/*!
+ * \class ReplicationTable
+ * \brief Maps multicast groups to their egress interface lists
+ *  \details The forwarding engine looks up the group of a multicast
+ * destination and queues one replica of the packet to each interface
+ * of the list. The replicas share the payload of the original packet,
+ * so each of them costs only a packet descriptor. The flood list
+ * holds every interface of the router and is used for the packets
+ * that have no route.
+ */
+
+
+#include "systemc"
+#include <map>
+#include <vector>
+#include <stdint.h>
+
+
+using namespace std;
+using namespace sc_core;
+using namespace sc_dt;
+
+#ifndef _REPLICATIONTABLE_H_
+#define _REPLICATIONTABLE_H_
+
+
+
+
+class ReplicationTable
+{
+
+public:
+
+    ReplicationTable(void);
+
+    ~ReplicationTable();
+
+    /*! \brief Sets the egress interface list of a multicast group
+     * @param[in] uint32_t p_Group The multicast group address
+     * @param[in] vector<int>& p_Egresses The egress interface indices
+     * \return <bool> True: if p_Group is a multicast address
+     * \public
+     */
+    bool setGroup(uint32_t p_Group, const vector<int>& p_Egresses);
+
+    /*! \brief Removes a multicast group
+     * \return <bool> True: if the group existed
+     * \public
+     */
+    bool removeGroup(uint32_t p_Group);
+
+    /*! \brief Returns the egress list of the group
+     * \return <const vector<int>*> The egress list or NULL if the
+     * group is not configured
+     * \public
+     */
+    const vector<int>* getGroup(uint32_t p_Group) const;
+
+    /*! \brief Sets the number of interfaces in the flood list
+     * \public
+     */
+    void setFloodCount(int p_InterfaceCount);
+
+    /*! \brief Returns the list of every interface of the router
+     * \public
+     */
+    const vector<int>& getFloodList(void) const;
+
+    /*! \brief Checks whether the address is an IPv4 multicast address
+     * \public
+     */
+    static bool isMulticast(uint32_t p_Address);
+
+private:
+
+    /*! \brief The egress lists keyed by the group address
+     * \private
+     */
+    map<unsigned, vector<int> > m_Groups;
+
+    vector<int> m_FloodList;
+};
+
+
+#endif /* _REPLICATIONTABLE_H_ */
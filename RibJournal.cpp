@@ -0,0 +1,219 @@
+/*! \file RibJournal.cpp
+ *  \brief     Implementation of the routing change journal.
+ *  \details
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 16:10:52 2026
+ */
+
+
+#include "RibJournal.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+
+/*! \brief Orders the records by table, prefix and length
+ */
+static bool recordLess(const JournalRecord& p_Left, const JournalRecord& p_Right)
+{
+    if (p_Left.m_Table != p_Right.m_Table)
+        return p_Left.m_Table < p_Right.m_Table;
+    return packPrefix(p_Left.m_Prefix, p_Left.m_Length) < packPrefix(p_Right.m_Prefix, p_Right.m_Length);
+}
+
+
+
+RibJournal::RibJournal(const RibJournalSource* p_Source, size_t p_BaseInterval):m_Source(p_Source), m_BaseInterval(max(p_BaseInterval, (size_t)1)), m_SinceBase(0), m_HistoryStart(0), m_File(NULL), m_OutputWritten(0)
+{
+}
+
+RibJournal::~RibJournal()
+{
+}
+
+
+void RibJournal::append(uint64_t p_Time, uint8_t p_Table, uint8_t p_Operation, uint32_t p_Prefix, int p_Length, int p_OutboundInterface, uint32_t p_PeerIdentifier)
+{
+    JournalRecord l_Record;
+
+    l_Record.m_Time = p_Time;
+    l_Record.m_Prefix = maskPrefix(p_Prefix, p_Length);
+    l_Record.m_Length = (uint8_t)p_Length;
+    l_Record.m_Table = p_Table;
+    l_Record.m_Operation = p_Operation;
+    l_Record.m_Reserved = 0;
+    l_Record.m_OutboundInterface = p_OutboundInterface;
+    l_Record.m_PeerIdentifier = p_PeerIdentifier;
+
+    m_Records.push_back(l_Record);
+    queue(l_Record);
+
+    if (++m_SinceBase >= m_BaseInterval && m_Source != NULL)
+        takeBase(p_Time);
+}
+
+void RibJournal::takeBase(uint64_t p_Time)
+{
+    if (m_Source == NULL)
+        return;
+
+    //the earlier records and bases are only needed for the file, and
+    //can be dropped once they are queued to it
+    if (m_File != NULL)
+        {
+            m_Records.clear();
+            m_Bases.clear();
+            m_HistoryStart = p_Time;
+        }
+
+    Base l_Base;
+
+    l_Base.m_Time = p_Time;
+    l_Base.m_Record = m_Records.size();
+
+    //the tables are walked in order, so the image is sorted by table,
+    //prefix and length
+    m_Source->getJournalRoutes(JOURNAL_LOC_RIB, l_Base.m_Image);
+    m_Source->getJournalRoutes(JOURNAL_FIB, l_Base.m_Image);
+    for (size_t i = 0; i < l_Base.m_Image.size(); ++i)
+        {
+            l_Base.m_Image[i].m_Time = p_Time;
+            l_Base.m_Image[i].m_Operation = JOURNAL_SET;
+        }
+
+    if (m_File != NULL)
+        {
+            JournalRecord l_Header;
+            memset(&l_Header, 0, sizeof(l_Header));
+            l_Header.m_Time = p_Time;
+            l_Header.m_Operation = JOURNAL_BASE;
+            l_Header.m_Prefix = (uint32_t)l_Base.m_Image.size();
+            queue(l_Header);
+            for (size_t i = 0; i < l_Base.m_Image.size(); ++i)
+                queue(l_Base.m_Image[i]);
+        }
+
+    m_Bases.push_back(l_Base);
+    m_SinceBase = 0;
+}
+
+int RibJournal::replay(uint64_t p_Time, uint8_t p_Table, vector<JournalRecord>& p_Routes) const
+{
+    unordered_map<uint64_t, JournalRecord> l_State;
+    size_t l_Record = 0;
+
+    p_Routes.clear();
+    if (p_Time < m_HistoryStart)
+        return -1;
+
+    //the latest base taken at or before p_Time
+    for (size_t i = m_Bases.size(); i > 0; --i)
+        if (m_Bases[i - 1].m_Time <= p_Time)
+            {
+                const Base& l_Base = m_Bases[i - 1];
+                for (size_t j = 0; j < l_Base.m_Image.size(); ++j)
+                    apply(l_State, l_Base.m_Image[j]);
+                l_Record = l_Base.m_Record;
+                break;
+            }
+
+    for (; l_Record < m_Records.size() && m_Records[l_Record].m_Time <= p_Time; ++l_Record)
+        apply(l_State, m_Records[l_Record]);
+
+    for (unordered_map<uint64_t, JournalRecord>::const_iterator it = l_State.begin(); it != l_State.end(); ++it)
+        if (it->second.m_Table == p_Table)
+            p_Routes.push_back(it->second);
+    sort(p_Routes.begin(), p_Routes.end(), recordLess);
+    return (int)p_Routes.size();
+}
+
+size_t RibJournal::getRecordCount(void) const
+{
+    return m_Records.size();
+}
+
+size_t RibJournal::getBaseCount(void) const
+{
+    return m_Bases.size();
+}
+
+void RibJournal::attachFile(AsyncFileWriter* p_File)
+{
+    m_File = p_File;
+    m_Output.clear();
+    m_OutputWritten = 0;
+}
+
+bool RibJournal::flush(void)
+{
+    if (m_File == NULL)
+        return true;
+    if (m_OutputWritten < m_Output.size())
+        m_OutputWritten += m_File->nb_write(&m_Output[m_OutputWritten], m_Output.size() - m_OutputWritten);
+    if (m_OutputWritten < m_Output.size())
+        return false;
+    m_Output.clear();
+    m_OutputWritten = 0;
+    return true;
+}
+
+bool RibJournal::load(const string& p_Path)
+{
+    ifstream l_File(p_Path.c_str(), ios::binary);
+    JournalRecord l_Record;
+
+    if (!l_File)
+        return false;
+
+    m_Records.clear();
+    m_Bases.clear();
+    m_HistoryStart = 0;
+    m_SinceBase = 0;
+
+    while (l_File.read((char*)&l_Record, sizeof(l_Record)))
+        {
+            if (l_Record.m_Operation != JOURNAL_BASE)
+                {
+                    m_Records.push_back(l_Record);
+                    m_SinceBase++;
+                    continue;
+                }
+
+            Base l_Base;
+            l_Base.m_Time = l_Record.m_Time;
+            l_Base.m_Record = m_Records.size();
+            l_Base.m_Image.resize(l_Record.m_Prefix);
+            if (!l_Base.m_Image.empty() && !l_File.read((char*)&l_Base.m_Image[0], l_Base.m_Image.size() * sizeof(JournalRecord)))
+                return false;
+
+            m_Bases.push_back(l_Base);
+            m_SinceBase = 0;
+        }
+    //a partial record at the end means the file was cut
+    return l_File.gcount() == 0;
+}
+
+
+uint64_t RibJournal::key(const JournalRecord& p_Record)
+{
+    return packPrefix(p_Record.m_Prefix, p_Record.m_Length) | ((uint64_t)p_Record.m_Table << 40);
+}
+
+void RibJournal::apply(unordered_map<uint64_t, JournalRecord>& p_State, const JournalRecord& p_Record)
+{
+    if (p_Record.m_Operation == JOURNAL_SET)
+        p_State[key(p_Record)] = p_Record;
+    else if (p_Record.m_Operation == JOURNAL_REMOVE)
+        p_State.erase(key(p_Record));
+}
+
+void RibJournal::queue(const JournalRecord& p_Record)
+{
+    if (m_File == NULL)
+        return;
+
+    size_t l_Size = m_Output.size();
+    m_Output.resize(l_Size + sizeof(p_Record));
+    memcpy(&m_Output[l_Size], &p_Record, sizeof(p_Record));
+}
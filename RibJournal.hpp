@@ -0,0 +1,257 @@
+/*! \file  RibJournal.hpp
+ *  \brief     Header file of the routing change journal
+ *  \details
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 16:10:52 2026
+ */
+
+/*!
+ * \class RibJournal
+ * \brief Append-only log of the Loc-RIB and FIB changes of a router
+ *  \details The Control Plane appends one fixed size record for each
+ * route it sets or removes in the Loc-RIB or in the FIB. Every
+ * p_BaseInterval records the journal takes a base: an image of every
+ * route held at that point, which it reads from the tables themselves
+ * through a RibJournalSource. A snapshot of the routing state is thus
+ * the latest base and the records after it, and the state at any
+ * earlier time is rebuilt by replay() from the nearest base before
+ * that time. The prefixes are journalled masked to their length.
+ *
+ * When a file is attached the records and the bases are also queued
+ * for the file and written by flush() through an AsyncFileWriter,
+ * without blocking the simulation. The file holds the JournalRecord
+ * structures in host byte order. A base is written as a JOURNAL_BASE
+ * record followed by the SET records of its image. load() reads such
+ * a file back.
+ *
+ * With a file attached the journal keeps in memory only the latest
+ * base and the records after it: when a base is taken the earlier
+ * records and bases are dropped, as they are already queued for the
+ * file. The earlier states are replayed from a journal load()ed from
+ * the file. Without a file the whole history is kept in memory.
+ */
+
+
+#include "systemc"
+#include <vector>
+#include <unordered_map>
+#include <stdint.h>
+#include "AsyncFile.hpp"
+#include "RoutingTable_Manage_If.hpp"
+
+
+using namespace std;
+using namespace sc_core;
+using namespace sc_dt;
+
+#ifndef _RIBJOURNAL_H_
+#define _RIBJOURNAL_H_
+
+
+/*! \def JOURNAL_LOC_RIB
+ *  \brief The record changes the Loc-RIB
+ */
+#define JOURNAL_LOC_RIB 0
+
+/*! \def JOURNAL_FIB
+ *  \brief The record changes the FIB
+ */
+#define JOURNAL_FIB 1
+
+/*! \def JOURNAL_SET
+ *  \brief The route is added or replaced
+ */
+#define JOURNAL_SET 0
+
+/*! \def JOURNAL_REMOVE
+ *  \brief The route is removed
+ */
+#define JOURNAL_REMOVE 1
+
+/*! \def JOURNAL_BASE
+ *  \brief A base image follows. m_Prefix holds its number of records
+ */
+#define JOURNAL_BASE 2
+
+/*! \def JOURNAL_BASE_INTERVAL
+ *  \brief Defines the default number of records between two bases
+ */
+#define JOURNAL_BASE_INTERVAL (1 << 20)
+
+
+/*!
+ * \class JournalRecord
+ * \brief One change of a route
+ */
+struct JournalRecord
+{
+    /*! \brief The simulation time of the change in sc_time units
+     */
+    uint64_t m_Time;
+
+    uint32_t m_Prefix;
+
+    uint8_t m_Length;
+
+    /*! \brief JOURNAL_LOC_RIB or JOURNAL_FIB
+     */
+    uint8_t m_Table;
+
+    /*! \brief JOURNAL_SET, JOURNAL_REMOVE or JOURNAL_BASE
+     */
+    uint8_t m_Operation;
+
+    uint8_t m_Reserved;
+
+    int32_t m_OutboundInterface;
+
+    /*! \brief The BGP identifier of the peer the route was learned from
+     */
+    uint32_t m_PeerIdentifier;
+};
+
+
+/*!
+ * \class RibJournalSource
+ * \brief The tables whose changes a journal records
+ * \details Implemented by the owner of the tables, which gives the
+ * journal the routes of its bases
+ */
+class RibJournalSource
+{
+
+public:
+
+    virtual ~RibJournalSource(){};
+
+    /*! \brief Gives the routes a table holds
+     * \details The journal sets the time and the operation of the
+     * records
+     * @param[in] uint8_t p_Table JOURNAL_LOC_RIB or JOURNAL_FIB
+     * @param[out] vector<JournalRecord>& p_Image The routes are appended
+     * ordered by prefix and length
+     * \public
+     */
+    virtual void getJournalRoutes(uint8_t p_Table, vector<JournalRecord>& p_Image) const = 0;
+};
+
+
+class RibJournal
+{
+
+public:
+
+    /*!
+     * \brief Constructor
+     * @param[in] RibJournalSource* p_Source The tables of the bases,
+     * NULL: no base is taken
+     * @param[in] size_t p_BaseInterval The number of records between
+     * two bases
+     * \public
+     */
+    explicit RibJournal(const RibJournalSource* p_Source = NULL, size_t p_BaseInterval = JOURNAL_BASE_INTERVAL);
+
+    ~RibJournal();
+
+    /*! \brief Appends a change
+     * \details Takes a base when p_BaseInterval records have been
+     * appended since the previous one
+     * \public
+     */
+    void append(uint64_t p_Time, uint8_t p_Table, uint8_t p_Operation, uint32_t p_Prefix, int p_Length, int p_OutboundInterface, uint32_t p_PeerIdentifier);
+
+    /*! \brief Takes a base image of the current routes
+     * \details The routes are read from the source in the order of the
+     * tables. The earlier records and bases are dropped if they are
+     * queued for a file
+     * \public
+     */
+    void takeBase(uint64_t p_Time);
+
+    /*! \brief Rebuilds the routes of a table at the given time
+     * @param[in] uint64_t p_Time The simulation time in sc_time units
+     * @param[in] uint8_t p_Table JOURNAL_LOC_RIB or JOURNAL_FIB
+     * @param[out] vector<JournalRecord>& p_Routes The routes held at
+     * p_Time ordered by prefix and length
+     * \return <int> The number of routes, -1 if p_Time is before the
+     * records kept in memory
+     * \public
+     */
+    int replay(uint64_t p_Time, uint8_t p_Table, vector<JournalRecord>& p_Routes) const;
+
+    size_t getRecordCount(void) const;
+
+    size_t getBaseCount(void) const;
+
+    /*! \brief Queues the following records and bases for the file
+     * \details The writer shall be open. NULL detaches the file
+     * \public
+     */
+    void attachFile(AsyncFileWriter* p_File);
+
+    /*! \brief Passes the queued bytes to the attached file
+     * \details Never blocks, the bytes the writer does not accept are
+     * kept for the next call
+     * \return <bool> True: if nothing is left in the queue
+     * \public
+     */
+    bool flush(void);
+
+    /*! \brief Replaces the journal with the content of a journal file
+     * \return <bool> False: if the file cannot be read or is truncated
+     * \public
+     */
+    bool load(const string& p_Path);
+
+private:
+
+    struct Base
+    {
+        uint64_t m_Time;
+
+        /*! \brief The index of the first record after the base
+         */
+        size_t m_Record;
+
+        vector<JournalRecord> m_Image;
+    };
+
+    static uint64_t key(const JournalRecord& p_Record);
+
+    static void apply(unordered_map<uint64_t, JournalRecord>& p_State, const JournalRecord& p_Record);
+
+    void queue(const JournalRecord& p_Record);
+
+    vector<JournalRecord> m_Records;
+
+    /*! \brief The bases in time order
+     * \private
+     */
+    vector<Base> m_Bases;
+
+    const RibJournalSource* m_Source;
+
+    size_t m_BaseInterval;
+
+    size_t m_SinceBase;
+
+    /*! \brief The time of the earliest state replay() can rebuild
+     * \details The time of the latest base once the earlier records
+     * have been dropped
+     * \private
+     */
+    uint64_t m_HistoryStart;
+
+    AsyncFileWriter* m_File;
+
+    /*! \brief Bytes waiting for the file
+     * \private
+     */
+    vector<unsigned char> m_Output;
+
+    size_t m_OutputWritten;
+};
+
+
+#endif /* _RIBJOURNAL_H_ */
@@ -0,0 +1,504 @@
+/*! \file  RingChannel.hpp
+ *  \brief     Lock-free ring buffer channels
+ *  \details   Defines the SpscRing and MpscRing ring buffers and the
+ *  RingChannel primitive channel that wraps them behind the
+ *  sc_fifo_in_if/sc_fifo_out_if interfaces.
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 10:12:40 2026
+ */
+
+/*!
+ * \class RingChannel
+ * \brief A drop-in replacement for sc_fifo built on a lock-free ring
+ *  \details The channel implements the same sc_fifo_in_if and
+ * sc_fifo_out_if interfaces as sc_fifo so that it can be bound to the
+ * same ports and exports. Unlike sc_fifo the capacity is rounded up
+ * to a power of two and the written items are visible to the reader
+ * immediately. The data_written and data_read events are coalesced:
+ * any number of writes during one delta cycle cause a single
+ * notification in the update phase.
+ *
+ * The channel may be used from SystemC processes and from plain OS
+ * threads. An OS thread that uses the channel shall call
+ * RingChannel_Thread::markForeign() once before its first access. The
+ * notifications of foreign threads are passed to the kernel with
+ * async_request_update and their blocking calls spin instead of
+ * waiting for the events.
+ *
+ * The producer and the consumer side are defined by the ring type:
+ * SpscRing allows one writer and one reader, MpscRing allows many
+ * concurrent writers and one reader.
+ */
+
+
+#include "systemc"
+#include <atomic>
+#include <thread>
+#include <cstddef>
+#include "MemoryAccounting.hpp"
+
+
+using namespace std;
+using namespace sc_core;
+using namespace sc_dt;
+
+#ifndef _RINGCHANNEL_H_
+#define _RINGCHANNEL_H_
+
+
+/*! \def CACHE_LINE_SIZE
+ *  \brief Defines the alignment used to separate the producer and
+ *  consumer indices
+ */
+#define CACHE_LINE_SIZE 64
+
+/*! \def RING_DEFAULT_CAPACITY
+ *  \brief Defines the default capacity of a RingChannel. Matches the
+ *  default depth of sc_fifo
+ */
+#define RING_DEFAULT_CAPACITY 16
+
+
+/*! \brief Rounds the given capacity up to the next power of two
+ * \details
+ * @param[in] size_t p_Capacity The requested capacity
+ * \return <size_t> The smallest power of two not smaller than p_Capacity
+ */
+inline size_t ringCapacity(size_t p_Capacity)
+{
+    size_t l_Capacity = 1;
+    while (l_Capacity < p_Capacity)
+        l_Capacity <<= 1;
+    return l_Capacity;
+}
+
+
+
+/*!
+ * \class SpscRing
+ * \brief Single producer, single consumer ring buffer
+ * \details The head index is owned by the consumer and the tail index
+ * by the producer. Both sides keep a private copy of the other side's
+ * index so that the shared cache line is only touched when the cached
+ * value says that the ring is full or empty.
+ */
+template <class T>
+class SpscRing
+{
+
+public:
+
+    explicit SpscRing(size_t p_Capacity):m_Head(0), m_TailCache(0), m_Tail(0), m_HeadCache(0)
+    {
+        m_Capacity = ringCapacity(p_Capacity);
+        m_Mask = m_Capacity - 1;
+
+        MemoryScope l_Scope(MEMORY_FIFO);
+        m_Slots = new T[m_Capacity];
+    }
+
+    ~SpscRing()
+    {
+        delete[] m_Slots;
+    }
+
+    /*! \brief Appends an item to the ring
+     * \details Called by the producer only
+     * \return <bool> True: if the item was stored, False: if the ring is full
+     * \public
+     */
+    bool push(const T& p_Item)
+    {
+        size_t l_Tail = m_Tail.load(std::memory_order_relaxed);
+        if (l_Tail - m_HeadCache == m_Capacity)
+            {
+                m_HeadCache = m_Head.load(std::memory_order_acquire);
+                if (l_Tail - m_HeadCache == m_Capacity)
+                    return false;
+            }
+        m_Slots[l_Tail & m_Mask] = p_Item;
+        m_Tail.store(l_Tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /*! \brief Removes the oldest item from the ring
+     * \details Called by the consumer only
+     * \return <bool> True: if an item was read, False: if the ring is empty
+     * \public
+     */
+    bool pop(T& p_Item)
+    {
+        size_t l_Head = m_Head.load(std::memory_order_relaxed);
+        if (l_Head == m_TailCache)
+            {
+                m_TailCache = m_Tail.load(std::memory_order_acquire);
+                if (l_Head == m_TailCache)
+                    return false;
+            }
+        p_Item = m_Slots[l_Head & m_Mask];
+        m_Head.store(l_Head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /*! \brief Number of items in the ring
+     * \details The value is exact only when called by the producer or
+     * the consumer while the other side is idle
+     * \public
+     */
+    size_t size() const
+    {
+        return m_Tail.load(std::memory_order_acquire) - m_Head.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const
+    {
+        return m_Capacity;
+    }
+
+private:
+
+    SpscRing(const SpscRing&);
+    SpscRing& operator = (const SpscRing&);
+
+    /*! \brief Consumer side: read index and cached write index
+     * \private
+     */
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_Head;
+    size_t m_TailCache;
+
+    /*! \brief Producer side: write index and cached read index
+     * \private
+     */
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_Tail;
+    size_t m_HeadCache;
+
+    /*! \brief Read-only after construction
+     * \private
+     */
+    alignas(CACHE_LINE_SIZE) size_t m_Capacity;
+    size_t m_Mask;
+    T *m_Slots;
+};
+
+
+
+/*!
+ * \class MpscRing
+ * \brief Multiple producer, single consumer ring buffer
+ * \details Bounded queue where each slot carries a sequence number.
+ * Producers claim a slot by advancing the tail with compare-and-swap
+ * and publish it by bumping the slot's sequence number, so a slow
+ * producer never blocks the others from claiming slots.
+ */
+template <class T>
+class MpscRing
+{
+
+public:
+
+    explicit MpscRing(size_t p_Capacity):m_Head(0), m_Tail(0)
+    {
+        m_Capacity = ringCapacity(p_Capacity);
+        m_Mask = m_Capacity - 1;
+
+        MemoryScope l_Scope(MEMORY_FIFO);
+        m_Slots = new Slot[m_Capacity];
+        for (size_t i = 0; i < m_Capacity; ++i)
+            m_Slots[i].m_Sequence.store(i, std::memory_order_relaxed);
+    }
+
+    ~MpscRing()
+    {
+        delete[] m_Slots;
+    }
+
+    /*! \brief Appends an item to the ring
+     * \details May be called by any number of producers concurrently
+     * \return <bool> True: if the item was stored, False: if the ring is full
+     * \public
+     */
+    bool push(const T& p_Item)
+    {
+        Slot *l_Slot;
+        size_t l_Tail = m_Tail.load(std::memory_order_relaxed);
+        while (true)
+            {
+                l_Slot = &m_Slots[l_Tail & m_Mask];
+                size_t l_Sequence = l_Slot->m_Sequence.load(std::memory_order_acquire);
+                ptrdiff_t l_Diff = (ptrdiff_t)l_Sequence - (ptrdiff_t)l_Tail;
+                if (l_Diff == 0)
+                    {
+                        if (m_Tail.compare_exchange_weak(l_Tail, l_Tail + 1, std::memory_order_relaxed))
+                            break;
+                    }
+                else if (l_Diff < 0)
+                    return false;
+                else
+                    l_Tail = m_Tail.load(std::memory_order_relaxed);
+            }
+        l_Slot->m_Item = p_Item;
+        l_Slot->m_Sequence.store(l_Tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /*! \brief Removes the oldest item from the ring
+     * \details Called by the consumer only
+     * \return <bool> True: if an item was read, False: if the ring is
+     * empty or the oldest slot is not published yet
+     * \public
+     */
+    bool pop(T& p_Item)
+    {
+        size_t l_Head = m_Head.load(std::memory_order_relaxed);
+        Slot *l_Slot = &m_Slots[l_Head & m_Mask];
+        if (l_Slot->m_Sequence.load(std::memory_order_acquire) != l_Head + 1)
+            return false;
+        p_Item = l_Slot->m_Item;
+        l_Slot->m_Sequence.store(l_Head + m_Capacity, std::memory_order_release);
+        m_Head.store(l_Head + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t size() const
+    {
+        size_t l_Tail = m_Tail.load(std::memory_order_acquire);
+        size_t l_Head = m_Head.load(std::memory_order_acquire);
+        return l_Tail > l_Head ? l_Tail - l_Head : 0;
+    }
+
+    size_t capacity() const
+    {
+        return m_Capacity;
+    }
+
+private:
+
+    MpscRing(const MpscRing&);
+    MpscRing& operator = (const MpscRing&);
+
+    struct Slot
+    {
+        std::atomic<size_t> m_Sequence;
+        T m_Item;
+    };
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_Head;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_Tail;
+
+    alignas(CACHE_LINE_SIZE) size_t m_Capacity;
+    size_t m_Mask;
+    Slot *m_Slots;
+};
+
+
+
+/*!
+ * \class RingChannel_Thread
+ * \brief Tells the ring channels whether the caller runs inside the
+ * SystemC kernel
+ * \details SystemC processes are the default. Worker threads mark
+ * themselves as foreign before touching any RingChannel.
+ */
+class RingChannel_Thread
+{
+
+public:
+
+    static void markForeign(void)
+    {
+        foreign() = true;
+    }
+
+    static bool isForeign(void)
+    {
+        return foreign();
+    }
+
+private:
+
+    static bool& foreign(void)
+    {
+        static thread_local bool s_Foreign = false;
+        return s_Foreign;
+    }
+};
+
+
+
+template <class T, class RING = SpscRing<T> >
+class RingChannel: public sc_fifo_in_if<T>, public sc_fifo_out_if<T>, public sc_prim_channel
+{
+
+public:
+
+    /*! \brief Elaborates the channel with a generated name
+     * @param[in] size_t p_Capacity The requested depth, rounded up to
+     * a power of two
+     * \public
+     */
+    explicit RingChannel(size_t p_Capacity = RING_DEFAULT_CAPACITY):sc_prim_channel(sc_gen_unique_name("ring_channel")), m_Ring(p_Capacity), m_PendingEvents(0)
+    {
+    }
+
+    /*! \brief Elaborates the channel
+     * @param[in] const char* p_Name The name of the channel
+     * @param[in] size_t p_Capacity The requested depth, rounded up to
+     * a power of two
+     * \public
+     */
+    RingChannel(const char* p_Name, size_t p_Capacity = RING_DEFAULT_CAPACITY):sc_prim_channel(p_Name), m_Ring(p_Capacity), m_PendingEvents(0)
+    {
+    }
+
+    ~RingChannel()
+    {
+    }
+
+
+    /************************sc_fifo_in_if*************************/
+
+    virtual bool nb_read(T& p_Item)
+    {
+        if (!m_Ring.pop(p_Item))
+            return false;
+        requestNotify(DATA_READ);
+        return true;
+    }
+
+    virtual void read(T& p_Item)
+    {
+        while (!nb_read(p_Item))
+            {
+                if (RingChannel_Thread::isForeign())
+                    std::this_thread::yield();
+                else
+                    sc_core::wait(m_DataWrittenEvent);
+            }
+    }
+
+    virtual T read(void)
+    {
+        T l_Item;
+        read(l_Item);
+        return l_Item;
+    }
+
+    virtual int num_available(void) const
+    {
+        return (int)m_Ring.size();
+    }
+
+    virtual const sc_event& data_written_event(void) const
+    {
+        return m_DataWrittenEvent;
+    }
+
+
+    /************************sc_fifo_out_if************************/
+
+    virtual bool nb_write(const T& p_Item)
+    {
+        if (!m_Ring.push(p_Item))
+            return false;
+        requestNotify(DATA_WRITTEN);
+        return true;
+    }
+
+    virtual void write(const T& p_Item)
+    {
+        while (!nb_write(p_Item))
+            {
+                if (RingChannel_Thread::isForeign())
+                    std::this_thread::yield();
+                else
+                    sc_core::wait(m_DataReadEvent);
+            }
+    }
+
+    virtual int num_free(void) const
+    {
+        return (int)(m_Ring.capacity() - m_Ring.size());
+    }
+
+    virtual const sc_event& data_read_event(void) const
+    {
+        return m_DataReadEvent;
+    }
+
+
+    /*! \brief The rounded capacity of the channel
+     * \public
+     */
+    size_t capacity(void) const
+    {
+        return m_Ring.capacity();
+    }
+
+    virtual const char* kind(void) const
+    {
+        return "RingChannel";
+    }
+
+
+protected:
+
+    /*! \brief Delivers the coalesced notifications
+     * \details Runs in the update phase of the kernel after one or more
+     * calls of request_update or async_request_update
+     * \protected
+     */
+    virtual void update(void)
+    {
+        unsigned l_Pending = m_PendingEvents.exchange(0, std::memory_order_acq_rel);
+        if (l_Pending & DATA_WRITTEN)
+            m_DataWrittenEvent.notify(SC_ZERO_TIME);
+        if (l_Pending & DATA_READ)
+            m_DataReadEvent.notify(SC_ZERO_TIME);
+    }
+
+
+private:
+
+    enum
+        {
+            DATA_WRITTEN = 1,
+            DATA_READ = 2
+        };
+
+    RingChannel(const RingChannel&);
+    RingChannel& operator = (const RingChannel&);
+
+    /*! \brief Schedules an update phase for the given event
+     * \details Only the first access during a delta cycle requests the
+     * update, the following ones find the bit already set.
+     * \private
+     */
+    void requestNotify(unsigned p_Event)
+    {
+        if (m_PendingEvents.fetch_or(p_Event, std::memory_order_acq_rel) & p_Event)
+            return;
+        if (RingChannel_Thread::isForeign())
+            async_request_update();
+        else
+            request_update();
+    }
+
+    /*! \brief The ring holding the items
+     * \private
+     */
+    RING m_Ring;
+
+    /*! \brief Events waiting for the next update phase
+     * \private
+     */
+    std::atomic<unsigned> m_PendingEvents;
+
+    sc_event m_DataWrittenEvent;
+
+    sc_event m_DataReadEvent;
+};
+
+
+#endif /* _RINGCHANNEL_H_ */
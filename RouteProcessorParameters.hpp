@@ -0,0 +1,115 @@
+/*! \file  RouteProcessorParameters.hpp
+ *  \brief    Holds the capacity parameters of a route processor
+ *  \details
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 20:41:18 2026
+ */
+
+/*!
+ * \class RouteProcessorParameters
+ * \brief Holds the capacity parameters of a router's Control Plane
+ *  \details The route processor takes the received BGP messages in
+ * batches of at most m_BatchSize from a work queue of m_QueueCapacity
+ * messages and spends the processing cost of each message's type in
+ * simulated time. The routes
+ * it selects are programmed into the FIB replicas at most
+ * m_FIBRoutesPerSecond routes per second.
+ */
+
+
+#include "systemc"
+
+
+using namespace std;
+using namespace sc_core;
+
+#ifndef _ROUTEPROCESSORPARAMETERS_H_
+#define _ROUTEPROCESSORPARAMETERS_H_
+
+
+/*! \def RP_OPEN_COST_US
+ *  \brief Defines the default processing cost of an OPEN in microseconds
+ */
+#define RP_OPEN_COST_US 1000
+
+/*! \def RP_UPDATE_COST_US
+ *  \brief Defines the default processing cost of an UPDATE in
+ *  microseconds
+ */
+#define RP_UPDATE_COST_US 100
+
+/*! \def RP_NOTIFICATION_COST_US
+ *  \brief Defines the default processing cost of a NOTIFICATION in
+ *  microseconds
+ */
+#define RP_NOTIFICATION_COST_US 100
+
+/*! \def RP_KEEPALIVE_COST_US
+ *  \brief Defines the default processing cost of a KEEPALIVE in
+ *  microseconds
+ */
+#define RP_KEEPALIVE_COST_US 10
+
+/*! \def RP_QUEUE_CAPACITY
+ *  \brief Defines the default number of messages waiting in the work
+ *  queue
+ */
+#define RP_QUEUE_CAPACITY 4096
+
+/*! \def RP_BATCH_SIZE
+ *  \brief Defines the default number of messages the route processor
+ *  takes from the work queue at a time
+ */
+#define RP_BATCH_SIZE 64
+
+/*! \def RP_FIB_ROUTES_PER_SECOND
+ *  \brief Defines the default FIB programming rate, 0 is unlimited
+ */
+#define RP_FIB_ROUTES_PER_SECOND 5000
+
+
+
+class RouteProcessorParameters
+{
+
+public:
+
+    RouteProcessorParameters(void):m_OpenCost(RP_OPEN_COST_US, SC_US), m_UpdateCost(RP_UPDATE_COST_US, SC_US), m_NotificationCost(RP_NOTIFICATION_COST_US, SC_US), m_KeepaliveCost(RP_KEEPALIVE_COST_US, SC_US), m_QueueCapacity(RP_QUEUE_CAPACITY), m_BatchSize(RP_BATCH_SIZE), m_FIBRoutesPerSecond(RP_FIB_ROUTES_PER_SECOND){};
+
+    /*! \brief Processing time of an OPEN
+     */
+    sc_time m_OpenCost;
+
+    /*! \brief Processing time of an UPDATE
+     */
+    sc_time m_UpdateCost;
+
+    /*! \brief Processing time of a NOTIFICATION
+     */
+    sc_time m_NotificationCost;
+
+    /*! \brief Processing time of a KEEPALIVE
+     */
+    sc_time m_KeepaliveCost;
+
+    /*! \brief Number of messages that may wait for the processor
+     * \details The messages that arrive to a full queue are dropped
+     */
+    int m_QueueCapacity;
+
+    /*! \brief Number of messages taken from the queue at a time
+     * \details A batch is handled by type, the messages of one type
+     * together
+     */
+    int m_BatchSize;
+
+    /*! \brief Number of routes programmed into the FIB per second
+     * \details 0: the routes are programmed as soon as they are
+     * selected
+     */
+    double m_FIBRoutesPerSecond;
+};
+
+
+#endif /* _ROUTEPROCESSORPARAMETERS_H_ */
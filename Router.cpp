@@ -9,69 +9,21 @@
 
 #include "Router.hpp"
 
-Router::Router(sc_module_name p_ModuleName, int p_InterfaceCount, BGPSessionParameters p_BGPSessionParam):sc_module(p_ModuleName), m_InterfaceCount(p_InterfaceCount), m_Bgp("BGP", p_InterfaceCount, p_BGPSessionParam), m_IP("IP", p_InterfaceCount)
+Router::Router(sc_module_name p_ModuleName, int p_InterfaceCount, BGPSessionParameters p_BGPSessionParam, int p_InterfacesPerLineCard, RouteProcessorParameters p_RPParam):RouterBase(p_ModuleName, p_InterfaceCount, p_BGPSessionParam, p_InterfacesPerLineCard, p_RPParam)
 {
-
-  
-  /// \li define clock period for Router
-      m_ClkPeriod = new const sc_time(1, SC_SEC);
-
-  /// \li Allocate clock for the Routers using the previously allocated period
-    m_ClkRouter = new sc_clock("CLK", *m_ClkPeriod);
-
-    cout << name() << " binding clocks..." << endl;
-      
- 
-  //set the clock for the planes
-    m_Bgp.port_Clk(*m_ClkRouter);
-    m_IP.port_Clk(*m_ClkRouter);
-
-    cout << name() << " binding planes..." << endl;
-    //bind the planes
-    m_IP.port_ToControlPlane(m_Bgp.export_ToControlPlane);
-    m_Bgp.port_ToDataPlane(m_IP);
-    m_Bgp.export_ToDataPlane(m_IP);
-
-    cout << name() << " binding planes finished." << endl;
-  
-  m_Name = "Interface_";
-
-  //allocate reference array for network interface modules
-  m_NetworkInterface = new Interface*[m_InterfaceCount];
-
   //allocate reference array for receiving exports
   export_ReceivingInterface = new sc_export<Interface_If>*[m_InterfaceCount];
 
   //allocate reference array for fowarding ports
   port_ForwardingInterface = new sc_port<Interface_If, 1, SC_ZERO_OR_MORE_BOUND>*[m_InterfaceCount];
 
-  //instantiate the network interface modules
+  //bind the network interfaces
   for(int i = 0; i < m_InterfaceCount; i++)
     {
-      
-      //instantiate an interface
-      m_NetworkInterface[i] = new Interface(appendName(m_Name, i));
-
-      //instantiate hierarchial forwarding port
+      //instantiate hierarchial forwarding port and receiving export
       port_ForwardingInterface[i] = new sc_port<Interface_If, 1, SC_ZERO_OR_MORE_BOUND>;
-      
-      //bind network interface port to router's hierarchial port
-      m_NetworkInterface[i]->port_Output.bind(*port_ForwardingInterface[i]);
-      
-      //make the hierarchial binding for receiving exports
       export_ReceivingInterface[i] = new sc_export<Interface_If>;
-      export_ReceivingInterface[i]->bind(*m_NetworkInterface[i]);
-
-      //bind the clock to the network interface
-      m_NetworkInterface[i]->port_Clk(*m_ClkRouter);      
-
-
-
-
-
-      m_IP.port_FromInterface(m_NetworkInterface[i]->export_ToDataPlane);//bind the receiving buffer's output to the protcol engine's output
-      m_IP.port_ToInterface(m_NetworkInterface[i]->export_FromDataPlane);//bind the protocol engine's output to the forwarding buffer's input
-
+      bindInterface(i, *export_ReceivingInterface[i], *port_ForwardingInterface[i]);
     }
 
 }
@@ -83,30 +35,18 @@ Router::~Router()
     {
       delete export_ReceivingInterface[i];
       delete port_ForwardingInterface[i];
-      delete m_NetworkInterface[i];
     }
 
-  
-  delete export_ReceivingInterface;
-  delete port_ForwardingInterface;
-  delete m_NetworkInterface;
-
-
-  delete m_ClkPeriod;
-  delete m_ClkRouter;
+  delete[] export_ReceivingInterface;
+  delete[] port_ForwardingInterface;
 }
 
-void Router::interfaceUp(int p_InterfaceId)
+sc_export<Interface_If>& Router::getReceivingInterface(int p_InterfaceId)
 {
-  m_NetworkInterface[p_InterfaceId]->interfaceUp();
-  cout << m_NetworkInterface[p_InterfaceId]->name() << " set up." << endl;
+  return *export_ReceivingInterface[p_InterfaceId];
 }
 
-
-const char* Router::appendName(string p_Name, int p)
+sc_port<Interface_If, 1, SC_ZERO_OR_MORE_BOUND>& Router::getForwardingInterface(int p_InterfaceId)
 {
-  stringstream ss;
-  ss << p;
-  p_Name += ss.str();
-  return p_Name.c_str();
+  return *port_ForwardingInterface[p_InterfaceId];
 }
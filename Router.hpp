@@ -9,17 +9,17 @@
 
 /*!
  * \class Router
- * \brief Router module
- *  \details
+ * \brief Router module of any number of interfaces
+ *  \details The interface count is given at run time, and the
+ * receiving exports and the forwarding ports of the interfaces are
+ * allocated for it. See RouterBase for the planes and the line cards,
+ * and FixedRouter for a router of a compile-time interface count.
  */
 
 
 
 #include "systemc"
-#include "Interface.hpp"
-#include "DataPlane.hpp"
-#include "ControlPlane.hpp"
-#include "BGPSessionParameters.hpp"
+#include "RouterBase.hpp"
 
 using namespace std;
 using namespace sc_core;
@@ -32,7 +32,7 @@ using namespace sc_dt;
 
  
 
-class Router: public sc_module
+class Router: public RouterBase
 {
 
 public:
@@ -46,64 +46,22 @@ public:
      * \brief Constructor
      * \details Builds the router
      * @param[in] p_Name The name of the module
+     * @param[in] int p_InterfaceCount The number of interfaces
+     * @param[in] BGPSessionParameters p_BGPSessionParam The default
+     * session parameters
+     * @param[in] int p_InterfacesPerLineCard The number of interfaces
+     * served by one line card
+     * @param[in] RouteProcessorParameters p_RPParam The capacity of the
+     * Control Plane
      * \public
      */
-    Router(sc_module_name p_ModuleName, int p_InterfaceCount, BGPSessionParameters p_BGPSessionParam);
+    Router(sc_module_name p_ModuleName, int p_InterfaceCount, BGPSessionParameters p_BGPSessionParam, int p_InterfacesPerLineCard = 1, RouteProcessorParameters p_RPParam = RouteProcessorParameters());
 
     ~Router();
 
-    void interfaceUp(int p_InterfaceId);  
+    virtual sc_export<Interface_If>& getReceivingInterface(int p_InterfaceId);
 
-private:
-
-
-
-    /*!
-     * \property   const sc_time *clk_Periods
-     * \brief 
-     * \details 
-     * \private
-     */
-    const sc_time *m_ClkPeriod;
-
-
-    /*!
-     * \property sc_clock *clk_Router
-     * \brief Pointer to sc_clock
-     * \details  
-     * \private
-     */
-    sc_clock *m_ClkRouter;
-
-
-
-    ControlPlane m_Bgp;
-
-    DataPlane m_IP;
-
-    Interface **m_NetworkInterface;
-
-    int m_InterfaceCount;
-
-    /*!
-     * \property  string m_Name
-     * \brief Name string
-     * \details  Used in dynamic module naming.
-     * \private
-     */
-    string m_Name;
-
-
-    /*!
-     * \fn   const char *appendName(string p_Name, int p)
-     * \brief Append integer to a string and return const pointer to char string
-     * \details  Used to append module id into the module base name
-     * @param[in] p_Name string  Name string to be appended
-     * @param[in] p int Interger value to be appended into the p_Name
-     * \return const char pointer to the appended string
-     * \private
-     */
-    const char *appendName(string p_Name, int p);
+    virtual sc_port<Interface_If, 1, SC_ZERO_OR_MORE_BOUND>& getForwardingInterface(int p_InterfaceId);
 };
 
 #endif
@@ -0,0 +1,163 @@
+/*! \file RouterBase.cpp
+ *  \brief     Implementation of the common part of the Router modules
+ *  \details
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Mon Oct 19 09:12:44 2026
+ */
+
+
+#include "RouterBase.hpp"
+
+RouterBase::RouterBase(sc_module_name p_ModuleName, int p_InterfaceCount, BGPSessionParameters p_BGPSessionParam, int p_InterfacesPerLineCard, RouteProcessorParameters p_RPParam):sc_module(p_ModuleName), m_InterfaceCount(p_InterfaceCount), m_Bgp("BGP", p_InterfaceCount, p_BGPSessionParam, p_RPParam), m_InterfacesPerLineCard(p_InterfacesPerLineCard)
+{
+
+  
+  /// \li define clock period for Router
+      m_ClkPeriod = new const sc_time(1, SC_SEC);
+
+  /// \li Allocate clock for the Routers using the previously allocated period
+    m_ClkRouter = new sc_clock("CLK", *m_ClkPeriod);
+
+    cout << name() << " binding clocks..." << endl;
+      
+ 
+  //set the clock for the control plane
+    m_Bgp.port_Clk(*m_ClkRouter);
+
+    cout << name() << " binding planes..." << endl;
+    //the sessions' messages are passed to the line cards through the router
+    m_Bgp.port_ToDataPlane(*this);
+    m_Bgp.export_ToDataPlane(*this);
+    export_ToControlPlane(m_Bgp.export_ToControlPlane);
+
+  m_Name = "LineCard_";
+
+  /// \li Group the interfaces onto line cards
+  if(m_InterfacesPerLineCard < 1)
+    m_InterfacesPerLineCard = 1;
+  m_LineCardCount = (m_InterfaceCount + m_InterfacesPerLineCard - 1) / m_InterfacesPerLineCard;
+  m_LineCards = new LineCard*[m_LineCardCount];
+
+  /// \li Build the fabric between the line cards and the interfaces
+  m_Fabric = new SwitchFabric("Fabric", m_LineCardCount, m_InterfaceCount);
+  m_Fabric->port_Clk(*m_ClkRouter);
+
+  for(int i = 0; i < m_LineCardCount; i++)
+    {
+      int l_First = i * m_InterfacesPerLineCard;
+      int l_Count = min(m_InterfacesPerLineCard, m_InterfaceCount - l_First);
+
+      m_LineCards[i] = new LineCard(appendName(m_Name, i).c_str(), i, l_First, l_Count);
+      m_LineCards[i]->port_Clk(*m_ClkRouter);
+      m_LineCards[i]->port_ToFabric(*m_Fabric);
+
+      //every line card delivers to the control plane
+      m_LineCards[i]->port_ToControlPlane(m_Bgp.export_ToControlPlane);
+
+      //one broadcast FIB update stream feeds all the replicas
+      m_Bgp.port_RTManage(m_LineCards[i]->export_FIB);
+    }
+
+    cout << name() << " binding planes finished." << endl;
+}
+
+RouterBase::~RouterBase()
+{
+  for(int i = 0; i < m_LineCardCount; i++)
+    delete m_LineCards[i];
+  delete m_Fabric;
+  delete[] m_LineCards;
+
+  delete m_ClkPeriod;
+  delete m_ClkRouter;
+}
+
+void RouterBase::bindInterface(int p_InterfaceId, sc_export<Interface_If>& p_Receiving, sc_port<Interface_If, 1, SC_ZERO_OR_MORE_BOUND>& p_Forwarding)
+{
+  Interface *l_Interface = getLineCard(p_InterfaceId)->getInterface(p_InterfaceId);
+
+  //bind network interface port to router's hierarchial port
+  l_Interface->port_Output.bind(p_Forwarding);
+
+  //make the hierarchial binding for receiving exports
+  p_Receiving.bind(*l_Interface);
+
+  //the fabric delivers to every interface
+  m_Fabric->port_ToInterface(l_Interface->export_FromDataPlane);
+}
+
+int RouterBase::getInterfaceCount(void) const
+{
+  return m_InterfaceCount;
+}
+
+void RouterBase::interfaceUp(int p_InterfaceId)
+{
+  Interface *l_Interface = getLineCard(p_InterfaceId)->getInterface(p_InterfaceId);
+  l_Interface->interfaceUp();
+  cout << l_Interface->name() << " set up." << endl;
+}
+
+bool RouterBase::setMulticastGroup(uint32_t p_Group, const vector<int>& p_Egresses)
+{
+  bool l_Success = true;
+
+  for(int i = 0; i < m_LineCardCount; i++)
+    l_Success &= m_LineCards[i]->setMulticastGroup(p_Group, p_Egresses);
+  return l_Success;
+}
+
+bool RouterBase::write(BGPMessage p_BGPMsg)
+{
+  if(p_BGPMsg.m_OutboundInterface < 0 || p_BGPMsg.m_OutboundInterface >= m_InterfaceCount)
+    return false;
+  return getLineCard(p_BGPMsg.m_OutboundInterface)->export_FromControlPlane->write(p_BGPMsg);
+}
+
+void RouterBase::getTrafficReport(vector<RouteTraffic>& p_Traffic) const
+{
+  map<uint64_t, RouteTraffic> l_Sum;
+  vector<RouteTraffic> l_Card;
+
+  for(int i = 0; i < m_LineCardCount; i++)
+    {
+      l_Card.clear();
+      m_LineCards[i]->getTraffic(l_Card);
+      for(size_t j = 0; j < l_Card.size(); j++)
+        {
+          uint64_t l_Key = packPrefix(l_Card[j].m_Prefix, l_Card[j].m_Length);
+          map<uint64_t, RouteTraffic>::iterator l_Route = l_Sum.find(l_Key);
+          if(l_Route == l_Sum.end())
+            l_Sum[l_Key] = l_Card[j];
+          else
+            {
+              l_Route->second.m_Packets += l_Card[j].m_Packets;
+              l_Route->second.m_Bytes += l_Card[j].m_Bytes;
+            }
+        }
+    }
+
+  p_Traffic.clear();
+  for(map<uint64_t, RouteTraffic>::const_iterator l_Route = l_Sum.begin(); l_Route != l_Sum.end(); ++l_Route)
+    p_Traffic.push_back(l_Route->second);
+}
+
+ControlPlane& RouterBase::getControlPlane(void)
+{
+  return m_Bgp;
+}
+
+LineCard* RouterBase::getLineCard(int p_InterfaceId)
+{
+  return m_LineCards[p_InterfaceId / m_InterfacesPerLineCard];
+}
+
+
+string RouterBase::appendName(string p_Name, int p)
+{
+  stringstream ss;
+  ss << p;
+  p_Name += ss.str();
+  return p_Name;
+}
@@ -0,0 +1,200 @@
+/*! \file RouterBase.hpp
+ *  \brief     Header file of the common part of the Router modules
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Mon Oct 19 09:12:44 2026
+ */
+
+
+
+/*!
+ * \class RouterBase
+ * \brief The part of a router that does not depend on how its
+ * interface ports are held
+ *  \details The interfaces of the router are grouped onto line cards
+ * of p_InterfacesPerLineCard interfaces. Each line card has its own
+ * forwarding engine and FIB replica, and the Control Plane broadcasts
+ * every FIB change to all the replicas. The router passes the BGP
+ * messages of the sessions to the line card that holds the session's
+ * interface. The line cards are connected to the interfaces' forwarding
+ * buffers through a crossbar switch fabric with virtual output queues.
+ *
+ * The receiving exports and forwarding ports of the interfaces are
+ * members of the derived routers: Router allocates them for any count
+ * at run time and FixedRouter holds them in arrays of a compile-time
+ * size. The derived router binds each pair with bindInterface().
+ */
+
+
+
+#include "systemc"
+#include "Interface.hpp"
+#include "LineCard.hpp"
+#include "SwitchFabric.hpp"
+#include "ControlPlane.hpp"
+#include "BGPSessionParameters.hpp"
+#include <map>
+
+using namespace std;
+using namespace sc_core;
+using namespace sc_dt;
+
+
+
+#ifndef ROUTERBASE_H
+#define ROUTERBASE_H
+
+
+
+class RouterBase: public sc_module, public DataPlane_In_If
+{
+
+public:
+
+    /*! \brief The Control Plane's receiving buffer
+     * \details For the sources that pass the BGP messages to the
+     * Control Plane without the data plane, the message's
+     * m_OutboundInterface is the session
+     * \public
+     */
+    sc_export<sc_fifo_out_if<BGPMessage> > export_ToControlPlane;
+
+
+    /*!
+     * \brief Constructor
+     * \details Builds the clock, the planes, the fabric and the line
+     * cards. The interfaces are bound by the derived router
+     * @param[in] p_Name The name of the module
+     * @param[in] int p_InterfaceCount The number of interfaces
+     * @param[in] BGPSessionParameters p_BGPSessionParam The default
+     * session parameters
+     * @param[in] int p_InterfacesPerLineCard The number of interfaces
+     * served by one line card
+     * @param[in] RouteProcessorParameters p_RPParam The capacity of the
+     * Control Plane
+     * \public
+     */
+    RouterBase(sc_module_name p_ModuleName, int p_InterfaceCount, BGPSessionParameters p_BGPSessionParam, int p_InterfacesPerLineCard, RouteProcessorParameters p_RPParam);
+
+    virtual ~RouterBase();
+
+    /*! \brief The receiving export of an interface
+     * \public
+     */
+    virtual sc_export<Interface_If>& getReceivingInterface(int p_InterfaceId) = 0;
+
+    /*! \brief The forwarding port of an interface
+     * \public
+     */
+    virtual sc_port<Interface_If, 1, SC_ZERO_OR_MORE_BOUND>& getForwardingInterface(int p_InterfaceId) = 0;
+
+    int getInterfaceCount(void) const;
+
+    void interfaceUp(int p_InterfaceId);
+
+    /*! \brief Sets the egress interfaces of a multicast group
+     * \details The group is configured on every line card
+     * @param[in] uint32_t p_Group The multicast group address
+     * @param[in] vector<int>& p_Egresses The egress interface indices
+     * \public
+     */
+    bool setMulticastGroup(uint32_t p_Group, const vector<int>& p_Egresses);
+
+    /*! \brief Passes a BGP message of a session to a line card
+     * \details The message is given to the line card which holds the
+     * message's outbound interface
+     * \public
+     */
+    virtual bool write(BGPMessage p_BGPMsg);
+
+    /*! \brief Gives the traffic the router has forwarded by each route
+     * \details Sums the counters of the line cards, by every route the
+     * Control Plane has set, the ones compressed out of the FIB included
+     * @param[out] vector<RouteTraffic>& p_Traffic The routes in
+     * routeLess() order
+     * \public
+     */
+    void getTrafficReport(vector<RouteTraffic>& p_Traffic) const;
+
+    /*! \brief Gives the router's Control Plane
+     * \details For the journal, the Loc-RIB and the session table of
+     * the router
+     * \public
+     */
+    ControlPlane& getControlPlane(void);
+
+protected:
+
+    /*! \brief Binds the export and the port of an interface
+     * \details The export receives for the interface and the interface
+     * forwards through the port. Called by the derived router once for
+     * each interface, in the order of the interfaces, which is the
+     * order of the fabric's egresses
+     * \protected
+     */
+    void bindInterface(int p_InterfaceId, sc_export<Interface_If>& p_Receiving, sc_port<Interface_If, 1, SC_ZERO_OR_MORE_BOUND>& p_Forwarding);
+
+    /*!
+     * \fn   string appendName(string p_Name, int p)
+     * \brief Append integer to a string
+     * \details  Used to append module id into the module base name
+     * @param[in] p_Name string  Name string to be appended
+     * @param[in] p int Interger value to be appended into the p_Name
+     * \return the appended string
+     * \protected
+     */
+    string appendName(string p_Name, int p);
+
+    int m_InterfaceCount;
+
+private:
+
+
+
+    /*!
+     * \property   const sc_time *clk_Periods
+     * \brief
+     * \details
+     * \private
+     */
+    const sc_time *m_ClkPeriod;
+
+
+    /*!
+     * \property sc_clock *clk_Router
+     * \brief Pointer to sc_clock
+     * \details
+     * \private
+     */
+    sc_clock *m_ClkRouter;
+
+
+
+    /*! \brief Returns the line card of the interface
+     * \private
+     */
+    LineCard* getLineCard(int p_InterfaceId);
+
+    ControlPlane m_Bgp;
+
+    LineCard **m_LineCards;
+
+    /*! \brief Crossbar between the line cards and the interfaces
+     * \private
+     */
+    SwitchFabric *m_Fabric;
+
+    int m_LineCardCount;
+
+    int m_InterfacesPerLineCard;
+
+    /*!
+     * \property  string m_Name
+     * \brief Name string
+     * \details  Used in dynamic module naming.
+     * \private
+     */
+    string m_Name;
+};
+
+#endif
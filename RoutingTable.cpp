@@ -0,0 +1,335 @@
+/*! \file RoutingTable.cpp
+ *  \brief     Implementation of the forwarding table.
+ *  \details
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 11:02:15 2026
+ */
+
+
+#include "RoutingTable.hpp"
+#include <algorithm>
+
+
+RoutingTable::RoutingTable(void):m_CountTraffic(false), m_RouteCount(0)
+{
+    //allocate the root node
+    allocateNode();
+}
+
+RoutingTable::~RoutingTable()
+{
+}
+
+
+bool RoutingTable::setRoute(uint32_t p_Prefix, int p_Length, int p_OutboundInterface)
+{
+    if (!isValidLength(p_Length))
+        return false;
+
+    int l_Node = findNode(p_Prefix, p_Length, true);
+
+    if (m_Nodes[l_Node].m_OutboundInterface == NO_ROUTE)
+        m_RouteCount++;
+    m_Nodes[l_Node].m_OutboundInterface = p_OutboundInterface;
+    return true;
+}
+
+bool RoutingTable::updateRoute(uint32_t p_Prefix, int p_Length, int p_OutboundInterface)
+{
+    if (!isValidLength(p_Length))
+        return false;
+
+    int l_Node = findNode(p_Prefix, p_Length, false);
+
+    if (l_Node == 0 && p_Length > 0)
+        return false;
+    if (m_Nodes[l_Node].m_OutboundInterface == NO_ROUTE)
+        return false;
+    m_Nodes[l_Node].m_OutboundInterface = p_OutboundInterface;
+    return true;
+}
+
+bool RoutingTable::removeRoute(uint32_t p_Prefix, int p_Length)
+{
+    if (!isValidLength(p_Length))
+        return false;
+
+    unsigned l_Prefix = p_Prefix;
+    int l_Path[33];
+    int l_Node = 0;
+
+    //walk down and remember the path for pruning
+    l_Path[0] = 0;
+    for (int i = 0; i < p_Length; ++i)
+        {
+            l_Node = m_Nodes[l_Node].m_Child[(l_Prefix >> (31 - i)) & 1];
+            if (l_Node == 0)
+                return false;
+            l_Path[i + 1] = l_Node;
+        }
+
+    if (m_Nodes[l_Node].m_OutboundInterface == NO_ROUTE)
+        return false;
+    m_Nodes[l_Node].m_OutboundInterface = NO_ROUTE;
+    m_RouteCount--;
+    if (m_CountTraffic)
+        m_Counters[l_Node].m_Packets = m_Counters[l_Node].m_Bytes = 0;
+
+    //release the nodes that do not lead to any route anymore
+    for (int i = p_Length; i > 0; --i)
+        {
+            Node& l_Current = m_Nodes[l_Path[i]];
+            if (l_Current.m_OutboundInterface != NO_ROUTE || l_Current.m_Child[0] || l_Current.m_Child[1])
+                break;
+            m_Nodes[l_Path[i - 1]].m_Child[(l_Prefix >> (32 - i)) & 1] = 0;
+            m_FreeNodes.push_back(l_Path[i]);
+        }
+    return true;
+}
+
+bool RoutingTable::setRoutes(const vector<RouteEntry>& p_Routes)
+{
+    for (size_t i = 0; i < p_Routes.size(); ++i)
+        if (!isValidLength(p_Routes[i].m_Length))
+            return false;
+    if (p_Routes.empty())
+        return true;
+
+    //the stable sort keeps the later of the equal prefixes last
+    vector<RouteEntry> l_Sorted(p_Routes);
+    stable_sort(l_Sorted.begin(), l_Sorted.end(), routeLess);
+    insertSorted(&l_Sorted[0], &l_Sorted[0] + l_Sorted.size());
+    return true;
+}
+
+bool RoutingTable::replaceAll(const RouteEntry* p_Begin, const RouteEntry* p_End)
+{
+    for (const RouteEntry* l_Route = p_Begin; l_Route != p_End; ++l_Route)
+        {
+            if (!isValidLength(l_Route->m_Length))
+                return false;
+            if (l_Route != p_Begin && routeLess(*l_Route, *(l_Route - 1)))
+                return false;
+        }
+
+    m_Nodes.clear();
+    m_FreeNodes.clear();
+    m_Counters.clear();
+    m_RouteCount = 0;
+    allocateNode();
+    insertSorted(p_Begin, p_End);
+    return true;
+}
+
+int RoutingTable::resolveRoute(uint32_t p_IPAddress)
+{
+    unsigned l_Address = p_IPAddress;
+    int l_Node = 0;
+    int l_Best = m_Nodes[0].m_OutboundInterface;
+
+    for (int i = 0; i < 32; ++i)
+        {
+            l_Node = m_Nodes[l_Node].m_Child[(l_Address >> (31 - i)) & 1];
+            if (l_Node == 0)
+                break;
+            if (m_Nodes[l_Node].m_OutboundInterface != NO_ROUTE)
+                l_Best = m_Nodes[l_Node].m_OutboundInterface;
+        }
+    return l_Best;
+}
+
+int RoutingTable::resolveRoute(uint32_t p_IPAddress, int& p_Entry)
+{
+    unsigned l_Address = p_IPAddress;
+    int l_Node = 0;
+
+    p_Entry = m_Nodes[0].m_OutboundInterface == NO_ROUTE ? NO_ROUTE : 0;
+    for (int i = 0; i < 32; ++i)
+        {
+            l_Node = m_Nodes[l_Node].m_Child[(l_Address >> (31 - i)) & 1];
+            if (l_Node == 0)
+                break;
+            if (m_Nodes[l_Node].m_OutboundInterface != NO_ROUTE)
+                p_Entry = l_Node;
+        }
+    return p_Entry == NO_ROUTE ? NO_ROUTE : m_Nodes[p_Entry].m_OutboundInterface;
+}
+
+int RoutingTable::resolveRoute(uint32_t p_IPAddress, int& p_Length, int& p_Entry)
+{
+    unsigned l_Address = p_IPAddress;
+    int l_Node = 0;
+
+    //no route lies below the first missing branch
+    p_Length = 32;
+    p_Entry = m_Nodes[0].m_OutboundInterface == NO_ROUTE ? NO_ROUTE : 0;
+    for (int i = 0; i < 32; ++i)
+        {
+            l_Node = m_Nodes[l_Node].m_Child[(l_Address >> (31 - i)) & 1];
+            if (l_Node == 0)
+                {
+                    p_Length = i + 1;
+                    break;
+                }
+            if (m_Nodes[l_Node].m_OutboundInterface != NO_ROUTE)
+                p_Entry = l_Node;
+        }
+    return p_Entry == NO_ROUTE ? NO_ROUTE : m_Nodes[p_Entry].m_OutboundInterface;
+}
+
+void RoutingTable::countTraffic(int p_Entry, uint32_t p_Bytes)
+{
+    if (!m_CountTraffic || p_Entry < 0)
+        return;
+    m_Counters[p_Entry].m_Packets++;
+    m_Counters[p_Entry].m_Bytes += p_Bytes;
+}
+
+int RoutingTable::getRouteCount(void) const
+{
+    return m_RouteCount;
+}
+
+void RoutingTable::enableTrafficCounters(bool p_Enable)
+{
+    Counter l_Zero = {0, 0};
+
+    m_CountTraffic = p_Enable;
+    m_Counters.clear();
+    if (p_Enable)
+        m_Counters.resize(m_Nodes.size(), l_Zero);
+}
+
+void RoutingTable::getTraffic(vector<RouteTraffic>& p_Traffic) const
+{
+    collectTraffic(0, 0, 0, p_Traffic);
+}
+
+void RoutingTable::getRoutes(vector<RouteEntry>& p_Routes) const
+{
+    collectRoutes(0, 0, 0, p_Routes);
+}
+
+
+int RoutingTable::findNode(unsigned p_Prefix, int p_Length, bool p_Create)
+{
+    int l_Node = 0;
+
+    for (int i = 0; i < p_Length; ++i)
+        {
+            int l_Bit = (p_Prefix >> (31 - i)) & 1;
+            int l_Next = m_Nodes[l_Node].m_Child[l_Bit];
+            if (l_Next == 0)
+                {
+                    if (!p_Create)
+                        return 0;
+                    l_Next = allocateNode();
+                    m_Nodes[l_Node].m_Child[l_Bit] = l_Next;
+                }
+            l_Node = l_Next;
+        }
+    return l_Node;
+}
+
+int RoutingTable::allocateNode(void)
+{
+    Node l_Empty;
+    l_Empty.m_Child[0] = 0;
+    l_Empty.m_Child[1] = 0;
+    l_Empty.m_OutboundInterface = NO_ROUTE;
+
+    Counter l_Zero = {0, 0};
+
+    if (!m_FreeNodes.empty())
+        {
+            int l_Index = m_FreeNodes.back();
+            m_FreeNodes.pop_back();
+            m_Nodes[l_Index] = l_Empty;
+            if (m_CountTraffic)
+                m_Counters[l_Index] = l_Zero;
+            return l_Index;
+        }
+    m_Nodes.push_back(l_Empty);
+    if (m_CountTraffic)
+        m_Counters.push_back(l_Zero);
+    return (int)m_Nodes.size() - 1;
+}
+
+void RoutingTable::insertSorted(const RouteEntry* p_Begin, const RouteEntry* p_End)
+{
+    int l_Path[33];
+    uint32_t l_Previous = 0;
+    int l_Depth = 0;
+
+    l_Path[0] = 0;
+    for (const RouteEntry* l_Route = p_Begin; l_Route != p_End; ++l_Route)
+        {
+            uint32_t l_Prefix = maskPrefix(l_Route->m_Prefix, l_Route->m_Length);
+            uint32_t l_Differ = l_Prefix ^ l_Previous;
+
+            //the previous path is valid down to the first differing bit
+            int l_Shared = l_Differ == 0 ? 32 : __builtin_clz(l_Differ);
+            int i = min(l_Depth, min(l_Shared, l_Route->m_Length));
+
+            for (; i < l_Route->m_Length; ++i)
+                {
+                    int l_Bit = (l_Prefix >> (31 - i)) & 1;
+                    int l_Next = m_Nodes[l_Path[i]].m_Child[l_Bit];
+                    if (l_Next == 0)
+                        {
+                            l_Next = allocateNode();
+                            m_Nodes[l_Path[i]].m_Child[l_Bit] = l_Next;
+                        }
+                    l_Path[i + 1] = l_Next;
+                }
+
+            Node& l_Node = m_Nodes[l_Path[l_Route->m_Length]];
+            if (l_Node.m_OutboundInterface == NO_ROUTE)
+                m_RouteCount++;
+            l_Node.m_OutboundInterface = l_Route->m_OutboundInterface;
+
+            l_Previous = l_Prefix;
+            l_Depth = l_Route->m_Length;
+        }
+}
+
+bool RoutingTable::isValidLength(int p_Length) const
+{
+    return p_Length >= 0 && p_Length <= 32;
+}
+
+void RoutingTable::collectTraffic(int p_Node, uint32_t p_Prefix, int p_Length, vector<RouteTraffic>& p_Traffic) const
+{
+    const Node& l_Node = m_Nodes[p_Node];
+
+    if (l_Node.m_OutboundInterface != NO_ROUTE)
+        {
+            RouteTraffic l_Traffic = {p_Prefix, p_Length, 0, 0};
+            if (m_CountTraffic)
+                {
+                    l_Traffic.m_Packets = m_Counters[p_Node].m_Packets;
+                    l_Traffic.m_Bytes = m_Counters[p_Node].m_Bytes;
+                }
+            p_Traffic.push_back(l_Traffic);
+        }
+
+    for (int l_Bit = 0; l_Bit < 2 && p_Length < 32; ++l_Bit)
+        if (l_Node.m_Child[l_Bit] != 0)
+            collectTraffic(l_Node.m_Child[l_Bit], p_Prefix | ((uint32_t)l_Bit << (31 - p_Length)), p_Length + 1, p_Traffic);
+}
+
+void RoutingTable::collectRoutes(int p_Node, uint32_t p_Prefix, int p_Length, vector<RouteEntry>& p_Routes) const
+{
+    const Node& l_Node = m_Nodes[p_Node];
+
+    if (l_Node.m_OutboundInterface != NO_ROUTE)
+        {
+            RouteEntry l_Route = {p_Prefix, p_Length, l_Node.m_OutboundInterface};
+            p_Routes.push_back(l_Route);
+        }
+
+    for (int l_Bit = 0; l_Bit < 2 && p_Length < 32; ++l_Bit)
+        if (l_Node.m_Child[l_Bit] != 0)
+            collectRoutes(l_Node.m_Child[l_Bit], p_Prefix | ((uint32_t)l_Bit << (31 - p_Length)), p_Length + 1, p_Routes);
+}
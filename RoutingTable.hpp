@@ -0,0 +1,162 @@
+/*! \file  RoutingTable.hpp
+ *  \brief     Header file of the forwarding table
+ *  \details
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 11:02:15 2026
+ */
+
+/*!
+ * \class RoutingTable
+ * \brief Forwarding Information Base (FIB) of a line card
+ *  \details The table is a binary trie over the destination address
+ * bits. The trie nodes are kept in one vector and refer to each other
+ * by index, removed nodes are recycled through a free list. A sorted
+ * bulk load walks the routes in trie pre-order and keeps the path of
+ * the previous route, so each node is reached once. The node array of
+ * a full table is kept on huge pages (HugePageArena).
+ *
+ * With the traffic counters enabled the table keeps a packet and a
+ * byte count for each node, in an array parallel to the nodes. The
+ * counters of a replica are only written by the engine of its own
+ * line card, so the replicas are the shards of the counters and the
+ * router sums them when they are read. Each line
+ * card holds its own replica of the table and the Control Plane keeps
+ * the replicas in sync through the RoutingTable_Manage_If interface.
+ */
+
+
+#include "systemc"
+#include <vector>
+#include "RoutingTable_Manage_If.hpp"
+#include "HugePageArena.hpp"
+
+
+using namespace std;
+using namespace sc_core;
+using namespace sc_dt;
+
+#ifndef _ROUTINGTABLE_H_
+#define _ROUTINGTABLE_H_
+
+
+
+class RoutingTable: public RoutingTable_Manage_If
+{
+
+public:
+
+    /*! \brief Builds an empty table
+     * \public
+     */
+    RoutingTable(void);
+
+    ~RoutingTable();
+
+    virtual bool setRoute(uint32_t p_Prefix, int p_Length, int p_OutboundInterface);
+
+    virtual bool updateRoute(uint32_t p_Prefix, int p_Length, int p_OutboundInterface);
+
+    virtual bool removeRoute(uint32_t p_Prefix, int p_Length);
+
+    virtual bool setRoutes(const vector<RouteEntry>& p_Routes);
+
+    virtual bool replaceAll(const RouteEntry* p_Begin, const RouteEntry* p_End);
+
+    virtual void getRoutes(vector<RouteEntry>& p_Routes) const;
+
+    virtual int resolveRoute(uint32_t p_IPAddress);
+
+    virtual int resolveRoute(uint32_t p_IPAddress, int& p_Entry);
+
+    virtual int resolveRoute(uint32_t p_IPAddress, int& p_Length, int& p_Entry);
+
+    virtual void countTraffic(int p_Entry, uint32_t p_Bytes);
+
+    /*! \brief Number of routes in the table
+     * \public
+     */
+    int getRouteCount(void) const;
+
+    /*! \brief Starts or stops counting the traffic of the routes
+     * \details Stopping drops the counts
+     * \public
+     */
+    void enableTrafficCounters(bool p_Enable);
+
+    /*! \brief Appends the traffic of every route of the table
+     * \details The routes are appended in routeLess() order
+     * \public
+     */
+    void getTraffic(vector<RouteTraffic>& p_Traffic) const;
+
+private:
+
+    /*! \brief A trie node
+     * \details m_Child holds the node indices of the 0- and 1-branch,
+     * zero meaning no branch because the root can not be a child.
+     * \private
+     */
+    struct Node
+    {
+        int m_Child[2];
+        int m_OutboundInterface;
+    };
+
+    /*! \brief Finds the node of the given prefix
+     * @param[in] bool p_Create Create the missing nodes on the way
+     * \return <int> The node index or zero if the node does not exist
+     * \private
+     */
+    int findNode(unsigned p_Prefix, int p_Length, bool p_Create);
+
+    /*! \brief Allocates a node from the free list or the vector
+     * \private
+     */
+    int allocateNode(void);
+
+    /*! \brief Sets the routes sorted by routeLess()
+     * \details Descends from the deepest node shared with the path of
+     * the previous route
+     * \private
+     */
+    void insertSorted(const RouteEntry* p_Begin, const RouteEntry* p_End);
+
+    /*! \brief Checks the prefix length
+     * \private
+     */
+    bool isValidLength(int p_Length) const;
+
+    void collectTraffic(int p_Node, uint32_t p_Prefix, int p_Length, vector<RouteTraffic>& p_Traffic) const;
+
+    void collectRoutes(int p_Node, uint32_t p_Prefix, int p_Length, vector<RouteEntry>& p_Routes) const;
+
+    struct Counter
+    {
+        uint64_t m_Packets;
+        uint64_t m_Bytes;
+    };
+
+    /*! \brief The traffic counters of the nodes
+     * \details Empty when the traffic is not counted
+     * \private
+     */
+    vector<Counter, HugePageAllocator<Counter, MEMORY_FIB> > m_Counters;
+
+    bool m_CountTraffic;
+
+    /*! \brief The trie nodes, index 0 is the root
+     * \private
+     */
+    vector<Node, HugePageAllocator<Node, MEMORY_FIB> > m_Nodes;
+
+    /*! \brief Indices of the released nodes
+     * \private
+     */
+    vector<int> m_FreeNodes;
+
+    int m_RouteCount;
+};
+
+
+#endif /* _ROUTINGTABLE_H_ */
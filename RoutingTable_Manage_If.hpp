@@ -14,6 +14,8 @@
 
 
 #include "systemc"
+#include <vector>
+#include <stdint.h>
 
 
 using namespace std;
@@ -25,32 +27,175 @@ using namespace sc_dt;
 #define _ROUTINGTABLE_MANAGE_IF_H_
 
 
+/*! \def NO_ROUTE
+ *  \brief Outbound interface value for a missing route
+ */
+#define NO_ROUTE -1
+
+
+/*! \brief Packs a prefix and its length into one key
+ * \details The prefix takes the upper 32 bits and the length the
+ * lowest byte, so the keys of equal prefixes sort by their length
+ */
+inline uint64_t packPrefix(uint32_t p_Prefix, int p_Length)
+{
+    return ((uint64_t)p_Prefix << 8) | (uint64_t)(p_Length & 0xFF);
+}
+
+/*! \brief Clears the bits of the prefix after its length
+ */
+inline uint32_t maskPrefix(uint32_t p_Prefix, int p_Length)
+{
+    return p_Length <= 0 ? 0 : p_Length >= 32 ? p_Prefix : p_Prefix & ~(0xFFFFFFFFu >> p_Length);
+}
+
+
+/*!
+ * \class RouteEntry
+ * \brief One route of a bulk load
+ */
+struct RouteEntry
+{
+    uint32_t m_Prefix;
+
+    int m_Length;
+
+    int m_OutboundInterface;
+};
+
+/*!
+ * \class RouteTraffic
+ * \brief The traffic forwarded by a route
+ */
+struct RouteTraffic
+{
+    uint32_t m_Prefix;
+
+    int m_Length;
+
+    uint64_t m_Packets;
+
+    uint64_t m_Bytes;
+};
+
+/*! \brief The order of a sorted bulk load
+ * \details By the masked prefix and then by the length, which is the
+ * pre-order of the routes in a binary trie
+ */
+inline bool routeLess(const RouteEntry& p_A, const RouteEntry& p_B)
+{
+    return packPrefix(maskPrefix(p_A.m_Prefix, p_A.m_Length), p_A.m_Length) < packPrefix(maskPrefix(p_B.m_Prefix, p_B.m_Length), p_B.m_Length);
+}
+
+
 class RoutingTable_Manage_If: virtual public sc_interface
 {
 
 public:
 
 
-    //TODO Find out what parameters we need for this function.
     /*! \brief Set new route to the Routing Table
-     * \details 
+     * \details Adds the route if the prefix is not in the table,
+     * otherwise the outbound interface of the route is replaced
+     * @param[in] uint32_t p_Prefix The destination prefix
+     * @param[in] int p_Length The prefix length in bits
+     * @param[in] int p_OutboundInterface The interface index
+     * towards the next hop
+     * \return <bool> True: if the route was set, False: if the
+     * prefix is not valid
+     * \public
+     */
+    virtual bool setRoute(uint32_t p_Prefix, int p_Length, int p_OutboundInterface) = 0;
+
+    /*! \brief Update an existing route in the Routing Table
+     * \details
+     * @param[in] uint32_t p_Prefix The destination prefix
+     * @param[in] int p_Length The prefix length in bits
+     * @param[in] int p_OutboundInterface The new interface index
+     * \return <bool> True: if the route existed and was updated,
+     * False: otherwise
      * \public
      */
-    virtual bool setRoute(void) = 0;
+    virtual bool updateRoute(uint32_t p_Prefix, int p_Length, int p_OutboundInterface) = 0;
 
-    //TODO 
-    /*! \brief Set new route to the Routing Table
-     * \details 
+    /*! \brief Remove a route from the Routing Table
+     * \details
+     * @param[in] uint32_t p_Prefix The destination prefix
+     * @param[in] int p_Length The prefix length in bits
+     * \return <bool> True: if the route existed, False: otherwise
+     * \public
+     */
+    virtual bool removeRoute(uint32_t p_Prefix, int p_Length) = 0;
+
+    /*! \brief Set a batch of routes to the Routing Table
+     * \details As setRoute() for each route, the routes may be in any
+     * order. The later of two routes of the same prefix wins
+     * @param[in] vector<RouteEntry>& p_Routes The routes
+     * \return <bool> True: if the routes were set, False: if a prefix
+     * is not valid, in which case no route is set
+     * \public
+     */
+    virtual bool setRoutes(const vector<RouteEntry>& p_Routes) = 0;
+
+    /*! \brief Replace the content of the Routing Table
+     * \details For loading a full table. The routes shall be sorted by
+     * routeLess(), which lets the table be built in one pass
+     * @param[in] RouteEntry* p_Begin The first route
+     * @param[in] RouteEntry* p_End Past the last route
+     * \return <bool> True: if the table was replaced, False: if the
+     * routes are not sorted or a prefix is not valid, in which case
+     * the table is not changed
      * \public
      */
-    virtual bool updateRoute(void) = 0;
+    virtual bool replaceAll(const RouteEntry* p_Begin, const RouteEntry* p_End) = 0;
 
-    //TODO 
-    /*! \brief Set new route to the Routing Table
-     * \details 
+    /*! \brief Gives the routes of the Routing Table
+     * \details The routes that were set, in routeLess() order
+     * @param[out] vector<RouteEntry>& p_Routes The routes are appended
+     * \public
+     */
+    virtual void getRoutes(vector<RouteEntry>& p_Routes) const = 0;
+
+    /*! \brief Resolve the outbound interface for an address
+     * \details Longest prefix match
+     * @param[in] uint32_t p_IPAddress The destination address
+     * \return <int> The outbound interface index or -1 if there is
+     * no matching route
+     * \public
+     */
+    virtual int resolveRoute(uint32_t p_IPAddress) = 0;
+
+    /*! \brief Resolve the outbound interface and the matched entry
+     * \details Longest prefix match
+     * @param[in] uint32_t p_IPAddress The destination address
+     * @param[out] int& p_Entry Identifies the matched entry of the
+     * table for countTraffic(), NO_ROUTE if there is none
+     * \return <int> The outbound interface index or -1 if there is
+     * no matching route
+     * \public
+     */
+    virtual int resolveRoute(uint32_t p_IPAddress, int& p_Entry) = 0;
+
+    /*! \brief Resolve the outbound interface and the range it holds for
+     * \details Longest prefix match that also tells how far the result
+     * can be reused: every address that shares the first p_Length
+     * bits with p_IPAddress resolves to the same interface and entry
+     * @param[in] uint32_t p_IPAddress The destination address
+     * @param[out] int& p_Length The length of that shared prefix
+     * @param[out] int& p_Entry The matched entry, as above
+     * \return <int> The outbound interface index or -1 if there is
+     * no matching route
+     * \public
+     */
+    virtual int resolveRoute(uint32_t p_IPAddress, int& p_Length, int& p_Entry) = 0;
+
+    /*! \brief Counts a forwarded packet to an entry
+     * \details No effect if the table does not count the traffic
+     * @param[in] int p_Entry The entry given by resolveRoute()
+     * @param[in] uint32_t p_Bytes The length of the packet
      * \public
      */
-    virtual int resolveRoute(sc_int<32> p_IPAddress) = 0;
+    virtual void countTraffic(int p_Entry, uint32_t p_Bytes) = 0;
 
 
 
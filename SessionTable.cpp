@@ -0,0 +1,208 @@
+/*! \file SessionTable.cpp
+ *  \brief     Implementation of the BGP session table.
+ *  \details
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 15:41:08 2026
+ */
+
+
+#include "SessionTable.hpp"
+#include <limits>
+
+
+SessionTable::SessionTable(int p_Sessions)
+{
+    MemoryScope l_Scope(MEMORY_SESSION);
+
+    for (int i = 0; i < p_Sessions; ++i)
+        addSession();
+}
+
+SessionTable::~SessionTable()
+{
+}
+
+
+int SessionTable::addSession(void)
+{
+    m_State.push_back(SESSION_IDLE);
+    m_PeerIdentifier.push_back(0);
+    m_HoldDownDeadline.push_back(0);
+    m_KeepaliveDeadline.push_back(0);
+    m_MessagesReceived.push_back(0);
+    m_KeepalivesSent.push_back(0);
+    m_Expirations.push_back(0);
+    m_TreatAsWithdraws.push_back(0);
+    m_AttributeDiscards.push_back(0);
+    return (int)m_State.size() - 1;
+}
+
+int SessionTable::size(void) const
+{
+    return (int)m_State.size();
+}
+
+
+void SessionTable::setState(int p_Session, uint8_t p_State)
+{
+    m_State[p_Session] = p_State;
+}
+
+uint8_t SessionTable::getState(int p_Session) const
+{
+    return m_State[p_Session];
+}
+
+void SessionTable::setPeerIdentifier(int p_Session, uint32_t p_BGPIdentifier)
+{
+    m_PeerIdentifier[p_Session] = p_BGPIdentifier;
+}
+
+uint32_t SessionTable::getPeerIdentifier(int p_Session) const
+{
+    return m_PeerIdentifier[p_Session];
+}
+
+void SessionTable::setHoldDownDeadline(int p_Session, double p_Deadline)
+{
+    m_HoldDownDeadline[p_Session] = p_Deadline;
+}
+
+double SessionTable::getHoldDownDeadline(int p_Session) const
+{
+    return m_HoldDownDeadline[p_Session];
+}
+
+void SessionTable::setKeepaliveDeadline(int p_Session, double p_Deadline)
+{
+    m_KeepaliveDeadline[p_Session] = p_Deadline;
+}
+
+double SessionTable::getKeepaliveDeadline(int p_Session) const
+{
+    return m_KeepaliveDeadline[p_Session];
+}
+
+void SessionTable::countMessageReceived(int p_Session)
+{
+    m_MessagesReceived[p_Session]++;
+}
+
+void SessionTable::countKeepaliveSent(int p_Session)
+{
+    m_KeepalivesSent[p_Session]++;
+}
+
+void SessionTable::countExpiration(int p_Session)
+{
+    m_Expirations[p_Session]++;
+}
+
+void SessionTable::countUpdateError(int p_Session, UpdateError p_Error)
+{
+    if (p_Error == UPDATE_TREAT_AS_WITHDRAW)
+        m_TreatAsWithdraws[p_Session]++;
+    else if (p_Error == UPDATE_ATTRIBUTE_DISCARD)
+        m_AttributeDiscards[p_Session]++;
+}
+
+uint32_t SessionTable::getMessagesReceived(int p_Session) const
+{
+    return m_MessagesReceived[p_Session];
+}
+
+uint32_t SessionTable::getKeepalivesSent(int p_Session) const
+{
+    return m_KeepalivesSent[p_Session];
+}
+
+uint32_t SessionTable::getExpirations(int p_Session) const
+{
+    return m_Expirations[p_Session];
+}
+
+uint32_t SessionTable::getTreatAsWithdraws(int p_Session) const
+{
+    return m_TreatAsWithdraws[p_Session];
+}
+
+uint32_t SessionTable::getAttributeDiscards(int p_Session) const
+{
+    return m_AttributeDiscards[p_Session];
+}
+
+
+int SessionTable::findSession(uint32_t p_BGPIdentifier) const
+{
+    const uint32_t* l_Peer = m_PeerIdentifier.data();
+    const uint8_t* l_State = m_State.data();
+    int l_Count = size();
+
+    for (int i = 0; i < l_Count; ++i)
+        if (l_Peer[i] == p_BGPIdentifier && l_State[i] != SESSION_IDLE)
+            return i;
+    return NO_SESSION;
+}
+
+int SessionTable::countInState(uint8_t p_State) const
+{
+    const uint8_t* l_State = m_State.data();
+    int l_Count = size();
+    int l_Found = 0;
+
+    for (int i = 0; i < l_Count; ++i)
+        l_Found += (l_State[i] == p_State);
+    return l_Found;
+}
+
+int SessionTable::expiringBefore(double p_Time, vector<int>& p_Sessions) const
+{
+    const uint8_t* l_State = m_State.data();
+    const double* l_Deadline = m_HoldDownDeadline.data();
+    int l_Count = size();
+
+    p_Sessions.clear();
+    for (int i = 0; i < l_Count; ++i)
+        if ((l_State[i] == SESSION_ESTABLISHED) & (l_Deadline[i] < p_Time))
+            p_Sessions.push_back(i);
+    return (int)p_Sessions.size();
+}
+
+SessionTableSnapshot SessionTable::snapshot(void) const
+{
+    SessionTableSnapshot l_Snapshot;
+    const uint8_t* l_State = m_State.data();
+    const double* l_Deadline = m_HoldDownDeadline.data();
+    int l_Count = size();
+    uint64_t l_Received = 0;
+    uint64_t l_Sent = 0;
+    uint64_t l_Expirations = 0;
+    uint64_t l_TreatAsWithdraws = 0;
+    uint64_t l_AttributeDiscards = 0;
+    double l_NextExpiry = numeric_limits<double>::infinity();
+
+    for (int i = 0; i < l_Count; ++i)
+        {
+            l_Received += m_MessagesReceived[i];
+            l_Sent += m_KeepalivesSent[i];
+            l_Expirations += m_Expirations[i];
+            l_TreatAsWithdraws += m_TreatAsWithdraws[i];
+            l_AttributeDiscards += m_AttributeDiscards[i];
+        }
+    for (int i = 0; i < l_Count; ++i)
+        {
+            double l_Candidate = l_State[i] == SESSION_ESTABLISHED ? l_Deadline[i] : numeric_limits<double>::infinity();
+            l_NextExpiry = l_Candidate < l_NextExpiry ? l_Candidate : l_NextExpiry;
+        }
+
+    l_Snapshot.m_Sessions = l_Count;
+    l_Snapshot.m_Established = countInState(SESSION_ESTABLISHED);
+    l_Snapshot.m_MessagesReceived = l_Received;
+    l_Snapshot.m_KeepalivesSent = l_Sent;
+    l_Snapshot.m_Expirations = l_Expirations;
+    l_Snapshot.m_TreatAsWithdraws = l_TreatAsWithdraws;
+    l_Snapshot.m_AttributeDiscards = l_AttributeDiscards;
+    l_Snapshot.m_NextExpiry = l_NextExpiry == numeric_limits<double>::infinity() ? -1 : l_NextExpiry;
+    return l_Snapshot;
+}
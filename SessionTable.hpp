@@ -0,0 +1,199 @@
+/*! \file  SessionTable.hpp
+ *  \brief     Header file of the BGP session table
+ *  \details
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 15:41:08 2026
+ */
+
+/*!
+ * \class SessionTable
+ * \brief Per-session state of the Control Plane in parallel arrays
+ *  \details Each field of the sessions is held in its own array and
+ * a session is identified by its index, which is the index of the
+ * BGPSession module and of the interface the peer connects to. The
+ * BGPSession modules keep their timers as events but write their
+ * state, deadlines and counters into the table. The bulk queries are
+ * linear scans over one or two arrays, so they touch only the memory
+ * they need and can be vectorised by the compiler.
+ */
+
+
+#include <vector>
+#include <stdint.h>
+#include "MemoryAccounting.hpp"
+#include "BGPMessage.hpp"
+
+
+using namespace std;
+
+#ifndef _SESSIONTABLE_H_
+#define _SESSIONTABLE_H_
+
+
+/*! \def SESSION_IDLE
+ *  \brief The session has no peer or its HoldDown timer has expired
+ */
+#define SESSION_IDLE 0
+
+/*! \def SESSION_ESTABLISHED
+ *  \brief The session has been started and its timers are running
+ */
+#define SESSION_ESTABLISHED 1
+
+/*! \def NO_SESSION
+ *  \brief Returned by findSession when no session has the peer
+ */
+#define NO_SESSION -1
+
+
+/*!
+ * \class SessionTableSnapshot
+ * \brief Totals of the session table at one point of time
+ */
+struct SessionTableSnapshot
+{
+    int m_Sessions;
+
+    int m_Established;
+
+    uint64_t m_MessagesReceived;
+
+    uint64_t m_KeepalivesSent;
+
+    uint64_t m_Expirations;
+
+    /*! \brief The UPDATEs treated as withdraws
+     */
+    uint64_t m_TreatAsWithdraws;
+
+    /*! \brief The UPDATEs whose malformed attributes were discarded
+     */
+    uint64_t m_AttributeDiscards;
+
+    /*! \brief The earliest HoldDown deadline of the established
+     * sessions in seconds, negative if none is established
+     */
+    double m_NextExpiry;
+};
+
+
+class SessionTable
+{
+
+public:
+
+    /*! \brief Builds a table of idle sessions
+     * @param[in] int p_Sessions The number of sessions
+     * \public
+     */
+    explicit SessionTable(int p_Sessions = 0);
+
+    ~SessionTable();
+
+    /*! \brief Appends an idle session
+     * \return <int> The index of the session
+     * \public
+     */
+    int addSession(void);
+
+    int size(void) const;
+
+
+    void setState(int p_Session, uint8_t p_State);
+
+    uint8_t getState(int p_Session) const;
+
+    void setPeerIdentifier(int p_Session, uint32_t p_BGPIdentifier);
+
+    uint32_t getPeerIdentifier(int p_Session) const;
+
+    /*! \brief Sets the time the HoldDown timer expires
+     * @param[in] double p_Deadline Simulation time in seconds
+     * \public
+     */
+    void setHoldDownDeadline(int p_Session, double p_Deadline);
+
+    double getHoldDownDeadline(int p_Session) const;
+
+    /*! \brief Sets the time the next keepalive is sent
+     * @param[in] double p_Deadline Simulation time in seconds
+     * \public
+     */
+    void setKeepaliveDeadline(int p_Session, double p_Deadline);
+
+    double getKeepaliveDeadline(int p_Session) const;
+
+    void countMessageReceived(int p_Session);
+
+    void countKeepaliveSent(int p_Session);
+
+    void countExpiration(int p_Session);
+
+    /*! \brief Counts an UPDATE error of the session's peer
+     * \details The error was handled without resetting the session
+     * @param[in] UpdateError p_Error UPDATE_ATTRIBUTE_DISCARD or
+     * UPDATE_TREAT_AS_WITHDRAW
+     * \public
+     */
+    void countUpdateError(int p_Session, UpdateError p_Error);
+
+    uint32_t getMessagesReceived(int p_Session) const;
+
+    uint32_t getKeepalivesSent(int p_Session) const;
+
+    uint32_t getExpirations(int p_Session) const;
+
+    uint32_t getTreatAsWithdraws(int p_Session) const;
+
+    uint32_t getAttributeDiscards(int p_Session) const;
+
+
+    /*! \brief Finds the session of a peer
+     * \return <int> The index of the session or NO_SESSION
+     * \public
+     */
+    int findSession(uint32_t p_BGPIdentifier) const;
+
+    /*! \brief Counts the sessions in the given state
+     * \public
+     */
+    int countInState(uint8_t p_State) const;
+
+    /*! \brief Lists the established sessions whose HoldDown timer
+     * expires before the given time
+     * @param[in] double p_Time Simulation time in seconds
+     * @param[out] vector<int>& p_Sessions The indices of the sessions
+     * \return <int> The number of sessions found
+     * \public
+     */
+    int expiringBefore(double p_Time, vector<int>& p_Sessions) const;
+
+    /*! \brief Sums the counters of every session
+     * \public
+     */
+    SessionTableSnapshot snapshot(void) const;
+
+private:
+
+    vector<uint8_t> m_State;
+
+    vector<uint32_t> m_PeerIdentifier;
+
+    vector<double> m_HoldDownDeadline;
+
+    vector<double> m_KeepaliveDeadline;
+
+    vector<uint32_t> m_MessagesReceived;
+
+    vector<uint32_t> m_KeepalivesSent;
+
+    vector<uint32_t> m_Expirations;
+
+    vector<uint32_t> m_TreatAsWithdraws;
+
+    vector<uint32_t> m_AttributeDiscards;
+};
+
+
+#endif /* _SESSIONTABLE_H_ */
@@ -0,0 +1,205 @@
+/*! \file  ShmRing.hpp
+ *  \brief     Ring buffer in POSIX shared memory
+ *  \details   Defines the ShmRing used to pass packets between the
+ *  processes of a partitioned simulation.
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 16:48:30 2026
+ */
+
+/*!
+ * \class ShmRing
+ * \brief Single producer, single consumer ring shared by two processes
+ *  \details The ring lives in a POSIX shared memory object that both
+ * processes open by name. A new object is filled with zeros, which is
+ * the empty ring, so neither side needs to initialise it and the
+ * processes may open it in any order. The items are copied in and out
+ * and shall be plain data without pointers.
+ *
+ * Besides the items the ring carries the simulation time of the
+ * producer. The producer publishes its time with publishTime() and
+ * promises that it sends nothing stamped earlier than that time plus
+ * the link delay. The consumer reads the time with getPeerTime() to
+ * know how far it may advance.
+ */
+
+
+#include <atomic>
+#include <string>
+#include <cstring>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "RingChannel.hpp"
+
+
+using namespace std;
+
+#ifndef _SHMRING_H_
+#define _SHMRING_H_
+
+
+/*! \def SHM_RING_CAPACITY
+ *  \brief Defines the number of items in a shared memory ring. Shall
+ *  be a power of two
+ */
+#define SHM_RING_CAPACITY 1024
+
+
+
+template <class T, size_t CAPACITY = SHM_RING_CAPACITY>
+class ShmRing
+{
+
+public:
+
+    ShmRing():m_Shared(NULL), m_Unlink(false), m_CachedHead(0), m_CachedTail(0)
+    {
+    }
+
+    ~ShmRing()
+    {
+        close();
+    }
+
+    /*! \brief Opens or creates the shared memory object
+     * @param[in] string p_Name The name of the object, starting with '/'
+     * @param[in] bool p_Unlink True: the object is removed on close
+     * \return <bool> False: if the object cannot be mapped
+     * \public
+     */
+    bool open(const string& p_Name, bool p_Unlink)
+    {
+        close();
+
+        int l_Fd = shm_open(p_Name.c_str(), O_CREAT | O_RDWR, 0600);
+        if (l_Fd < 0)
+            return false;
+        if (ftruncate(l_Fd, sizeof(Shared)) != 0)
+            {
+                ::close(l_Fd);
+                return false;
+            }
+        void* l_Memory = mmap(NULL, sizeof(Shared), PROT_READ | PROT_WRITE, MAP_SHARED, l_Fd, 0);
+        ::close(l_Fd);
+        if (l_Memory == MAP_FAILED)
+            return false;
+
+        m_Shared = (Shared*)l_Memory;
+        m_Name = p_Name;
+        m_Unlink = p_Unlink;
+        m_CachedHead = m_Shared->m_Head.load(std::memory_order_acquire);
+        m_CachedTail = m_Shared->m_Tail.load(std::memory_order_acquire);
+        return true;
+    }
+
+    void close(void)
+    {
+        if (m_Shared == NULL)
+            return;
+        munmap(m_Shared, sizeof(Shared));
+        if (m_Unlink)
+            shm_unlink(m_Name.c_str());
+        m_Shared = NULL;
+    }
+
+    bool isOpen(void) const
+    {
+        return m_Shared != NULL;
+    }
+
+    /*! \brief Copies the item into the ring
+     * \details Producer side only
+     * \return <bool> False: if the ring is full
+     * \public
+     */
+    bool push(const T& p_Item)
+    {
+        uint64_t l_Tail = m_Shared->m_Tail.load(std::memory_order_relaxed);
+
+        if (l_Tail - m_CachedHead == CAPACITY)
+            {
+                m_CachedHead = m_Shared->m_Head.load(std::memory_order_acquire);
+                if (l_Tail - m_CachedHead == CAPACITY)
+                    return false;
+            }
+        memcpy(&m_Shared->m_Slots[l_Tail & (CAPACITY - 1)], &p_Item, sizeof(T));
+        m_Shared->m_Tail.store(l_Tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /*! \brief Copies the oldest item out of the ring
+     * \details Consumer side only
+     * \return <bool> False: if the ring is empty
+     * \public
+     */
+    bool pop(T& p_Item)
+    {
+        uint64_t l_Head = m_Shared->m_Head.load(std::memory_order_relaxed);
+
+        if (l_Head == m_CachedTail)
+            {
+                m_CachedTail = m_Shared->m_Tail.load(std::memory_order_acquire);
+                if (l_Head == m_CachedTail)
+                    return false;
+            }
+        memcpy(&p_Item, &m_Shared->m_Slots[l_Head & (CAPACITY - 1)], sizeof(T));
+        m_Shared->m_Head.store(l_Head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /*! \brief Publishes the producer's simulation time
+     * \details The time is given in sc_time resolution units
+     * \public
+     */
+    void publishTime(uint64_t p_Time)
+    {
+        m_Shared->m_SenderTime.store(p_Time, std::memory_order_release);
+    }
+
+    /*! \brief The time last published by the producer
+     * \public
+     */
+    uint64_t getPeerTime(void) const
+    {
+        return m_Shared->m_SenderTime.load(std::memory_order_acquire);
+    }
+
+private:
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "the ring indices shall be lock-free to be shared between processes");
+
+    struct Shared
+    {
+        alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> m_Head;
+
+        alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> m_Tail;
+
+        alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> m_SenderTime;
+
+        alignas(CACHE_LINE_SIZE) T m_Slots[CAPACITY];
+    };
+
+    ShmRing(const ShmRing&);
+    ShmRing& operator = (const ShmRing&);
+
+    Shared* m_Shared;
+
+    string m_Name;
+
+    bool m_Unlink;
+
+    /*! \brief The consumer index last seen by the producer
+     * \private
+     */
+    uint64_t m_CachedHead;
+
+    /*! \brief The producer index last seen by the consumer
+     * \private
+     */
+    uint64_t m_CachedTail;
+};
+
+
+#endif /* _SHMRING_H_ */
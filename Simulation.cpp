@@ -10,7 +10,7 @@
 #include "Simulation.hpp"
 
 
-Simulation::Simulation(sc_module_name p_ModuleName):sc_module(p_ModuleName)
+Simulation::Simulation(sc_module_name p_ModuleName, int p_Partition, int p_PartitionCount, const string& p_RunName):sc_module(p_ModuleName), m_Partition(p_Partition), m_PartitionCount(p_PartitionCount), m_RunName(p_RunName), m_Sync(NULL), m_Churn(NULL)
 {
 ///Constructor briefly: 
 
@@ -20,33 +20,55 @@ Simulation::Simulation(sc_module_name p_ModuleName):sc_module(p_ModuleName)
 
 
   /// \li Allocate Router pointer array
-  m_Router = new Router*[ROUTER_COUNT];
+  m_Router = new RouterBase*[ROUTER_COUNT];
+  m_AbstractRouter = new AbstractRouter*[ROUTER_COUNT];
 
   /// \li Set the base name for the router modules
   m_Name = "Router_";
 
 
 
-  /// \li Initiate the Router modules as m_Router
+  /// \li Initiate the Router modules of this partition as m_Router
   for(int i = 0; i < ROUTER_COUNT; i++)
     {
+      m_Router[i] = NULL;
+      m_AbstractRouter[i] = NULL;
+      if(!isLocal(i))
+	continue;
       cout << "Building " << appendName(m_Name, i) << endl;
-      /// \li Generate the routers
-      m_Router[i] = new Router(appendName(m_Name, i), INTERFACE_COUNT, m_BGPSessionParam);
+      /// \li Charge the memory of the router to its index
+      MemoryScope l_Scope(i, MEMORY_MODULE);
+      /// \li Generate the routers, the ones after the detailed routers
+      /// originate a prefix of their own
+      if(i < DETAILED_ROUTER_COUNT)
+	{
+	  /// \li The detailed routers have the compile-time shape, but the
+	  /// churn router has an extra interface for the generator
+	  if(i == CHURN_ROUTER)
+	    m_Router[i] = new Router(appendName(m_Name, i).c_str(), INTERFACE_COUNT + 1, m_BGPSessionParam, INTERFACES_PER_LINECARD);
+	  else
+	    m_Router[i] = new FixedRouter<INTERFACE_COUNT, INTERFACES_PER_LINECARD>(appendName(m_Name, i).c_str(), m_BGPSessionParam);
+	  /// \li Journal the routing changes of the detailed routers
+	  if(JOURNAL_FILES && !m_Router[i]->getControlPlane().setJournalFile(appendName("Journal_", i) + ".bin"))
+	    cout << "Cannot open the journal of " << appendName(m_Name, i) << endl;
+	}
+      else
+	{
+	  m_AbstractRouter[i] = new AbstractRouter(appendName(m_Name, i).c_str(), INTERFACE_COUNT, i + 1);
+	  m_AbstractRouter[i]->originate((10u << 24) | (i << 8), 24);
+	}
       cout << appendName(m_Name, i) << " built." << endl;
     }
-  
-
-  ///Build the network TO-DO: clean up the binding process -> make a connection method in the router
 
-  ///connect the 0-interfaces of router 0 and router 1
-  m_Router[0]->port_ForwardingInterface[0]->bind(*(m_Router[1]->export_ReceivingInterface[0]));
+  /// \li Build the time synchronisation if the simulation is split
+  if(m_PartitionCount > 1)
+    m_Sync = new PartitionSync("Partition_Sync");
+  
 
-  m_Router[1]->port_ForwardingInterface[0]->bind(*(m_Router[0]->export_ReceivingInterface[0]));
+  ///Build the network
 
-  ///set the those interfaces up
-  m_Router[0]->interfaceUp(0);
-  m_Router[1]->interfaceUp(0);
+  ///connect the 0-interfaces of router 0 and router 1 and set them up
+  connect(0, 0, 1, 0);
 
 
  
@@ -57,24 +79,16 @@ Simulation::Simulation(sc_module_name p_ModuleName):sc_module(p_ModuleName)
 
       ///connect each router to the next one
       for(int i = 1; i < ROUTER_COUNT-1; i++)
-	{
-
-	  m_Router[i]->port_ForwardingInterface[1]->bind(*(m_Router[i+1]->export_ReceivingInterface[0]));
-	  m_Router[i+1]->port_ForwardingInterface[0]->bind(*(m_Router[i]->export_ReceivingInterface[1]));
-	  m_Router[i]->interfaceUp(1);
-	  m_Router[i+1]->interfaceUp(0);
-
-	}
+	connect(i, 1, i+1, 0);
 
       ///close the ring by connecting the last router to the first
-      m_Router[ROUTER_COUNT-1]->port_ForwardingInterface[1]->bind(*(m_Router[0]->export_ReceivingInterface[1]));
-      m_Router[0]->port_ForwardingInterface[1]->bind(*(m_Router[ROUTER_COUNT-1]->export_ReceivingInterface[1]));
-
-	  m_Router[0]->interfaceUp(1);
-	  m_Router[ROUTER_COUNT-1]->interfaceUp(1);
-
+      connect(ROUTER_COUNT-1, 1, 0, 1);
     }
 
+  ///attach the churn source
+  if(CHURN_ROUTER >= 0)
+    attachChurn(CHURN_ROUTER);
+
 
 
 
@@ -85,15 +99,115 @@ Simulation::~Simulation()
 
   /// \li Free all the memory
   for(int i = 0; i < ROUTER_COUNT; i++)
-    delete m_Router[i];
+    {
+      delete m_Router[i];
+      delete m_AbstractRouter[i];
+    }
+
+  delete[] m_Router;
+  delete[] m_AbstractRouter;
+
+  for(size_t i = 0; i < m_Links.size(); i++)
+    delete m_Links[i];
+  for(size_t i = 0; i < m_LocalLinks.size(); i++)
+    delete m_LocalLinks[i];
 
-  delete m_Router;
+  delete m_Sync;
+  delete m_Churn;
 }
 
-const char* Simulation::appendName(string p_Name, int p)
+string Simulation::appendName(string p_Name, int p)
 {
   stringstream ss;
   ss << p;
   p_Name += ss.str();
-  return p_Name.c_str();
+  return p_Name;
+}
+
+bool Simulation::isLocal(int p_Router) const
+{
+  //the partitions are contiguous blocks of routers
+  return p_Router * m_PartitionCount / ROUTER_COUNT == m_Partition;
+}
+
+sc_export<Interface_If>& Simulation::getReceivingInterface(int p_Router, int p_Interface)
+{
+  if(m_Router[p_Router] != NULL)
+    return m_Router[p_Router]->getReceivingInterface(p_Interface);
+  return *(m_AbstractRouter[p_Router]->export_ReceivingInterface[p_Interface]);
+}
+
+sc_port<Interface_If, 1, SC_ZERO_OR_MORE_BOUND>& Simulation::getForwardingInterface(int p_Router, int p_Interface)
+{
+  if(m_Router[p_Router] != NULL)
+    return m_Router[p_Router]->getForwardingInterface(p_Interface);
+  return *(m_AbstractRouter[p_Router]->port_ForwardingInterface[p_Interface]);
+}
+
+void Simulation::interfaceUp(int p_Router, int p_Interface)
+{
+  if(m_Router[p_Router] != NULL)
+    m_Router[p_Router]->interfaceUp(p_Interface);
+  else
+    m_AbstractRouter[p_Router]->interfaceUp(p_Interface);
+}
+
+void Simulation::connect(int p_RouterA, int p_InterfaceA, int p_RouterB, int p_InterfaceB)
+{
+  if(isLocal(p_RouterA) && isLocal(p_RouterB))
+    {
+      connectLocal(p_RouterA, p_InterfaceA, p_RouterB, p_InterfaceB);
+      connectLocal(p_RouterB, p_InterfaceB, p_RouterA, p_InterfaceA);
+      interfaceUp(p_RouterA, p_InterfaceA);
+      interfaceUp(p_RouterB, p_InterfaceB);
+    }
+  else if(isLocal(p_RouterA))
+    connectRemote(p_RouterA, p_InterfaceA, p_RouterB, p_InterfaceB);
+  else if(isLocal(p_RouterB))
+    connectRemote(p_RouterB, p_InterfaceB, p_RouterA, p_InterfaceA);
+}
+
+void Simulation::connectLocal(int p_From, int p_FromInterface, int p_To, int p_ToInterface)
+{
+  string l_Name = appendName(appendName(m_Name, p_From) + "_Link_", p_FromInterface);
+  LocalLink *l_Link = new LocalLink(l_Name.c_str(), sc_time(LINK_DELAY_MS, SC_MS));
+
+  getForwardingInterface(p_From, p_FromInterface).bind(*l_Link);
+  l_Link->port_Output.bind(getReceivingInterface(p_To, p_ToInterface));
+  m_LocalLinks.push_back(l_Link);
+}
+
+void Simulation::connectRemote(int p_Local, int p_LocalInterface, int p_Remote, int p_RemoteInterface)
+{
+  string l_Name = appendName(appendName(m_Name, p_Local) + "_Link_", p_LocalInterface);
+  PartitionLink *l_Link = new PartitionLink(l_Name.c_str(), ringName(p_Local, p_LocalInterface), ringName(p_Remote, p_RemoteInterface), sc_time(LINK_DELAY_MS, SC_MS));
+
+  getForwardingInterface(p_Local, p_LocalInterface).bind(*l_Link);
+  l_Link->port_Output.bind(getReceivingInterface(p_Local, p_LocalInterface));
+  interfaceUp(p_Local, p_LocalInterface);
+
+  m_Sync->addLink(l_Link);
+  m_Links.push_back(l_Link);
+}
+
+void Simulation::attachChurn(int p_Router)
+{
+  if(!isLocal(p_Router) || m_Router[p_Router] == NULL)
+    return;
+
+  ChurnParameters l_Parameters;
+
+  //the generator is the peer of the extra interface
+  l_Parameters.m_Interface = INTERFACE_COUNT;
+  m_Churn = new ChurnGenerator("Churn_Generator", l_Parameters);
+  getForwardingInterface(p_Router, INTERFACE_COUNT).bind(*m_Churn);
+  m_Churn->port_ToControlPlane.bind(m_Router[p_Router]->export_ToControlPlane);
+  interfaceUp(p_Router, INTERFACE_COUNT);
+}
+
+string Simulation::ringName(int p_Router, int p_Interface) const
+{
+  stringstream ss;
+  ss << "/bgpsim." << m_RunName << "." << p_Router << "." << p_Interface;
+  return ss.str();
 }
@@ -17,14 +17,25 @@
 /*!
  * \class Simulation
  * \brief Simulation top module
- *  \details
+ *  \details The simulation may be split across several processes.
+ * Each process builds a Simulation with its own partition index and
+ * elaborates only the routers of that partition, which are a
+ * contiguous block of the router indices. A link between routers of
+ * different partitions is built as a PartitionLink at both ends and a
+ * PartitionSync keeps the processes in time.
  */
 
 
 
 #include "systemc"
 #include "Router.hpp"
+#include "FixedRouter.hpp"
+#include "AbstractRouter.hpp"
 #include "BGPSessionParameters.hpp"
+#include "PartitionLink.hpp"
+#include "PartitionSync.hpp"
+#include "LocalLink.hpp"
+#include "ChurnGenerator.hpp"
 
 using namespace std;
 using namespace sc_core;
@@ -41,12 +52,48 @@ using namespace sc_dt;
 #define ROUTER_COUNT 3
 
 
+/*! \def DETAILED_ROUTER_COUNT
+ *  Defines the number of routers modelled in detail. The routers after
+ *  them are AbstractRouters that run only the BGP best-path selection
+ */
+#define DETAILED_ROUTER_COUNT ROUTER_COUNT
+
+
 /*! \def IF_COUNT
  *  Defines the number of interfaces in each router
  */
 #define INTERFACE_COUNT 2
 
 
+/*! \def INTERFACES_PER_LINECARD
+ *  Defines the number of interfaces served by one line card
+ */
+#define INTERFACES_PER_LINECARD 1
+
+
+/*! \def CHURN_ROUTER
+ *  Defines the detailed router a ChurnGenerator is attached to, -1 for
+ *  none. The router gets an extra interface for the generator
+ */
+#define CHURN_ROUTER -1
+
+
+/*! \def JOURNAL_FILES
+ *  Defines whether each detailed router writes its RIB journal into
+ *  the file Journal_<router index>.bin
+ */
+#define JOURNAL_FILES 0
+
+
+/*! \def LINK_DELAY_MS
+ *  Defines the delay of every link between two routers in
+ *  milliseconds, whether the routers are in the same partition or not.
+ *  Between partitions the delay is the lookahead of the partition
+ *  synchronisation, so it shall be larger than 0
+ */
+#define LINK_DELAY_MS 1
+
+
 class Simulation: public sc_module
 {
 
@@ -56,9 +103,13 @@ public:
      * \brief Constructor
      * \details Builds the simulation
      * @param[in] p_Name The name of the module
+     * @param[in] int p_Partition The partition built by this process
+     * @param[in] int p_PartitionCount The number of processes
+     * @param[in] string p_RunName Names the shared memory rings of
+     * the run, the same in every process
      * \public
      */
-    Simulation(sc_module_name p_Name);
+    Simulation(sc_module_name p_Name, int p_Partition = 0, int p_PartitionCount = 1, const string& p_RunName = "");
 
     ~Simulation();
     /*
@@ -97,26 +148,105 @@ private:
 
 
     /*!
-     * \property  Router **m_router
+     * \property  RouterBase **m_router
      * \brief Pointer to Router pointer
      * \details  Used in dynamic allocation of Router Modules
      * \private
      */
 
-    Router **m_Router;
+    RouterBase **m_Router;
+
+    /*! \brief The control plane only routers
+     * \details NULL at the indices of the detailed routers
+     * \private
+     */
+    AbstractRouter **m_AbstractRouter;
 
     BGPSessionParameters m_BGPSessionParam;
 
+    int m_Partition;
+
+    int m_PartitionCount;
+
+    string m_RunName;
+
+    /*! \brief Synchronises the time with the other partitions
+     * \details NULL when the simulation runs in one process
+     * \private
+     */
+    PartitionSync *m_Sync;
+
+    vector<PartitionLink*> m_Links;
+
+    /*! \brief The links between the routers of this partition, one for
+     * each direction
+     * \private
+     */
+    vector<LocalLink*> m_LocalLinks;
+
+    /*! \brief The churn source of CHURN_ROUTER
+     * \details NULL if there is none in this partition
+     * \private
+     */
+    ChurnGenerator *m_Churn;
+
+    /*! \brief Checks whether the router is built by this process
+     * \private
+     */
+    bool isLocal(int p_Router) const;
+
+    /*! \brief The receiving export of a router of either kind
+     * \private
+     */
+    sc_export<Interface_If>& getReceivingInterface(int p_Router, int p_Interface);
+
+    /*! \brief The forwarding port of a router of either kind
+     * \private
+     */
+    sc_port<Interface_If, 1, SC_ZERO_OR_MORE_BOUND>& getForwardingInterface(int p_Router, int p_Interface);
+
+    void interfaceUp(int p_Router, int p_Interface);
+
+    /*! \brief Connects two router interfaces and sets them up
+     * \details Connects the routers through a LocalLink in each
+     * direction when both are local and through a PartitionLink when
+     * only one of them is
+     * \private
+     */
+    void connect(int p_RouterA, int p_InterfaceA, int p_RouterB, int p_InterfaceB);
+
+    /*! \brief Builds the link from one local router interface to another
+     * \private
+     */
+    void connectLocal(int p_From, int p_FromInterface, int p_To, int p_ToInterface);
+
+    /*! \brief Builds the local end of a link to another partition
+     * \private
+     */
+    void connectRemote(int p_Local, int p_LocalInterface, int p_Remote, int p_RemoteInterface);
+
+    /*! \brief Attaches a ChurnGenerator to the extra interface of a
+     * local detailed router
+     * \private
+     */
+    void attachChurn(int p_Router);
+
+    /*! \brief The name of the ring carrying the packets sent from the
+     * interface
+     * \private
+     */
+    string ringName(int p_Router, int p_Interface) const;
+
 
     /*!
-     * \fn   const char *appendName(string p_Name, int p)
-     * \brief Append integer to a string and return const pointer to char string
+     * \fn   string appendName(string p_Name, int p)
+     * \brief Append integer to a string
      * \details  Used to append module id into the module base name
      * @param[in] p_Name string  Name string to be appended
      * @param[in] p int Interger value to be appended into the p_Name
-     * \return const char pointer to the appended string
+     * \return The appended string
      * \private
      */
-    const char *appendName(string p_Name, int p);
+    string appendName(string p_Name, int p);
 };
 
@@ -0,0 +1,161 @@
+/*! \file  SlabPool.hpp
+ *  \brief     Pool of fixed size objects allocated in slabs
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 21:37:12 2026
+ */
+
+/*!
+ * \class SlabPool
+ * \brief Allocates the objects of one type from large slabs
+ *  \details The slabs hold at least SLAB_POOL_BYTES of objects each,
+ * as many as fit in whole HUGE_PAGE_UNITs, and are carved out of the
+ * HugePageArena's huge pages, so the nodes of a large trie share few
+ * pages instead of being spread over the heap. The released objects are kept
+ * in a free list and reused before a new slab is allocated. The slabs
+ * are only released with the pool.
+ *
+ * The memory is charged to the subsystem TAG of the router of the
+ * scope open when the pool is built.
+ */
+
+
+#include <vector>
+#include <new>
+#include <cstddef>
+#include <type_traits>
+#include "HugePageArena.hpp"
+
+
+using namespace std;
+
+#ifndef _SLABPOOL_H_
+#define _SLABPOOL_H_
+
+
+/*! \def SLAB_POOL_BYTES
+ *  \brief Defines the least size of a slab in bytes, the smallest
+ *  block the HugePageArena keeps on huge pages
+ */
+#define SLAB_POOL_BYTES HUGE_PAGE_MIN_BYTES
+
+
+
+template <class T, int TAG>
+class SlabPool
+{
+
+public:
+
+    SlabPool(void):m_Free(NULL), m_Used(0){};
+
+    SlabPool(const SlabPool&) = delete;
+
+    SlabPool& operator=(const SlabPool&) = delete;
+
+    /*! \brief Releases the slabs
+     * \details The objects shall have been destroyed
+     * \public
+     */
+    ~SlabPool()
+    {
+        for (size_t i = 0; i < m_Slabs.size(); ++i)
+            m_Allocator.deallocate(m_Slabs[i], SLAB_OBJECTS);
+    }
+
+    /*! \brief Constructs an object in a free slot
+     * \return <T*> The object, std::bad_alloc is thrown if there is no
+     * memory
+     * \public
+     */
+    T* create(void)
+    {
+        if (m_Free == NULL)
+            grow();
+
+        Slot* l_Slot = m_Free;
+        m_Free = l_Slot->m_Next;
+        m_Used++;
+        return new (&l_Slot->m_Storage) T();
+    }
+
+    /*! \brief Destroys an object and returns its slot to the free list
+     * \public
+     */
+    void destroy(T* p_Object)
+    {
+        Slot* l_Slot = reinterpret_cast<Slot*>(p_Object);
+
+        p_Object->~T();
+        l_Slot->m_Next = m_Free;
+        m_Free = l_Slot;
+        m_Used--;
+    }
+
+    /*! \brief Number of live objects
+     * \public
+     */
+    size_t size(void) const
+    {
+        return m_Used;
+    }
+
+    /*! \brief Number of slots in the slabs
+     * \public
+     */
+    size_t capacity(void) const
+    {
+        return m_Slabs.size() * SLAB_OBJECTS;
+    }
+
+private:
+
+    /*! \brief A slot holds an object or, while free, the next free slot
+     * \private
+     */
+    union Slot
+    {
+        Slot* m_Next;
+
+        typename aligned_storage<sizeof(T), alignof(T)>::type m_Storage;
+    };
+
+    /*! \brief Size of a slab, rounded up from SLAB_POOL_BYTES to whole
+     * slots and then to whole units of the arena
+     * \details Rounding down would make the slab too small for the
+     * huge pages
+     * \private
+     */
+    static const size_t SLAB_BYTES = ((SLAB_POOL_BYTES + sizeof(Slot) - 1) / sizeof(Slot) * sizeof(Slot) + HUGE_PAGE_UNIT - 1) / HUGE_PAGE_UNIT * HUGE_PAGE_UNIT;
+
+    /*! \brief Number of slots in a slab, which fill the units
+     * \private
+     */
+    static const size_t SLAB_OBJECTS = SLAB_BYTES / sizeof(Slot);
+
+    /*! \brief Allocates a slab and threads its slots to the free list
+     * \private
+     */
+    void grow(void)
+    {
+        Slot* l_Slab = m_Allocator.allocate(SLAB_OBJECTS);
+
+        m_Slabs.push_back(l_Slab);
+        for (size_t i = SLAB_OBJECTS; i > 0; --i)
+            {
+                l_Slab[i - 1].m_Next = m_Free;
+                m_Free = &l_Slab[i - 1];
+            }
+    }
+
+    HugePageAllocator<Slot, TAG> m_Allocator;
+
+    vector<Slot*> m_Slabs;
+
+    Slot* m_Free;
+
+    size_t m_Used;
+};
+
+
+#endif /* _SLABPOOL_H_ */
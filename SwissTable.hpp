@@ -0,0 +1,374 @@
+/*! \file  SwissTable.hpp
+ *  \brief     Open addressing hash table probed a group at a time
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 22:06:51 2026
+ */
+
+/*!
+ * \class SwissTable
+ * \brief Map from 64-bit keys, e.g. the packed prefixes, to values
+ *  \details The slots are kept in one array with a control byte for
+ * each slot: EMPTY, DELETED, or the low 7 bits of the hash of the key
+ * in the slot. A lookup hashes the key once and compares its 7 bits to
+ * a group of SWISS_GROUP_WIDTH control bytes with a single SSE2
+ * comparison, so only the slots whose bits match are compared with the
+ * key, which is nearly always the right one. The probe moves from group
+ * to group and ends at the first group with an EMPTY byte. The table
+ * grows to twice its size when 7/8 of the slots are used.
+ *
+ * The arrays come from the HugePageAllocator and are charged to the
+ * subsystem TAG of the router of the scope open when the table is
+ * built. Without SSE2 the groups are compared a byte at a time.
+ */
+
+
+#include <new>
+#include <utility>
+#include <cstddef>
+#include <cstring>
+#include <stdint.h>
+#include "HugePageArena.hpp"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+
+using namespace std;
+
+#ifndef _SWISSTABLE_H_
+#define _SWISSTABLE_H_
+
+
+/*! \def SWISS_GROUP_WIDTH
+ *  \brief Defines the number of control bytes compared at a time
+ */
+#define SWISS_GROUP_WIDTH 16
+
+/*! \def SWISS_EMPTY
+ *  \brief Defines the control byte of a slot that has never been used
+ */
+#define SWISS_EMPTY ((int8_t)-128)
+
+/*! \def SWISS_DELETED
+ *  \brief Defines the control byte of a slot whose key was erased
+ */
+#define SWISS_DELETED ((int8_t)-2)
+
+
+
+template <class V, int TAG>
+class SwissTable
+{
+
+public:
+
+    SwissTable(void):m_Control(NULL), m_Slots(NULL), m_Capacity(0), m_Size(0), m_Deleted(0){};
+
+    SwissTable(const SwissTable&) = delete;
+
+    SwissTable& operator=(const SwissTable&) = delete;
+
+    ~SwissTable()
+    {
+        clear();
+        release();
+    }
+
+    /*! \brief Finds the value of a key
+     * \return <V*> The value or NULL
+     * \public
+     */
+    V* find(uint64_t p_Key)
+    {
+        size_t l_Slot = findSlot(p_Key, hash(p_Key));
+
+        return l_Slot == m_Capacity ? NULL : &m_Slots[l_Slot].m_Value;
+    }
+
+    const V* find(uint64_t p_Key) const
+    {
+        return const_cast<SwissTable*>(this)->find(p_Key);
+    }
+
+    /*! \brief Finds or adds a key
+     * @param[out] bool p_Inserted True: if the key was added
+     * \return <V&> The value, default constructed if the key was added
+     * \public
+     */
+    V& insert(uint64_t p_Key, bool& p_Inserted)
+    {
+        uint64_t l_Hash = hash(p_Key);
+        size_t l_Slot = findSlot(p_Key, l_Hash);
+
+        p_Inserted = l_Slot == m_Capacity;
+        if (!p_Inserted)
+            return m_Slots[l_Slot].m_Value;
+
+        if ((m_Size + m_Deleted + 1) * 8 > m_Capacity * 7)
+            rehash(m_Size + 1);
+
+        l_Slot = findFree(l_Hash);
+        if (m_Control[l_Slot] == SWISS_DELETED)
+            m_Deleted--;
+        m_Control[l_Slot] = (int8_t)(l_Hash & 0x7F);
+        new (&m_Slots[l_Slot]) Slot(p_Key);
+        m_Size++;
+        return m_Slots[l_Slot].m_Value;
+    }
+
+    /*! \brief Removes a key
+     * \return <bool> False: if the key was not in the table
+     * \public
+     */
+    bool erase(uint64_t p_Key)
+    {
+        size_t l_Slot = findSlot(p_Key, hash(p_Key));
+
+        if (l_Slot == m_Capacity)
+            return false;
+
+        //no probe has passed a group with an EMPTY byte, so the slot
+        //of such a group may become EMPTY again
+        size_t l_Group = l_Slot - l_Slot % SWISS_GROUP_WIDTH;
+
+        m_Slots[l_Slot].~Slot();
+        if (matchByte(l_Group, SWISS_EMPTY) != 0)
+            m_Control[l_Slot] = SWISS_EMPTY;
+        else
+            {
+                m_Control[l_Slot] = SWISS_DELETED;
+                m_Deleted++;
+            }
+        m_Size--;
+        return true;
+    }
+
+    /*! \brief Visits every key in the order of the slots
+     * \details The visitor is called as p_Visit(uint64_t p_Key, const V&
+     * p_Value) and shall not change the table
+     * \public
+     */
+    template <class F>
+    void walk(F p_Visit) const
+    {
+        for (size_t i = 0; i < m_Capacity; ++i)
+            if (m_Control[i] >= 0)
+                p_Visit(m_Slots[i].m_Key, (const V&)m_Slots[i].m_Value);
+    }
+
+    /*! \brief Makes room for p_Count keys
+     * \public
+     */
+    void reserve(size_t p_Count)
+    {
+        if (p_Count * 8 > m_Capacity * 7)
+            rehash(p_Count);
+    }
+
+    /*! \brief Removes every key and keeps the slots
+     * \public
+     */
+    void clear(void)
+    {
+        for (size_t i = 0; i < m_Capacity; ++i)
+            if (m_Control[i] >= 0)
+                m_Slots[i].~Slot();
+        if (m_Capacity > 0)
+            memset(m_Control, SWISS_EMPTY, m_Capacity);
+        m_Size = 0;
+        m_Deleted = 0;
+    }
+
+    size_t size(void) const
+    {
+        return m_Size;
+    }
+
+    size_t capacity(void) const
+    {
+        return m_Capacity;
+    }
+
+private:
+
+    struct Slot
+    {
+        explicit Slot(uint64_t p_Key):m_Key(p_Key), m_Value(){};
+
+        uint64_t m_Key;
+
+        V m_Value;
+    };
+
+    /*! \brief Mixes the bits of the key into the 7 control bits and the
+     * group index
+     * \private
+     */
+    static uint64_t hash(uint64_t p_Key)
+    {
+        p_Key ^= p_Key >> 33;
+        p_Key *= 0xFF51AFD7ED558CCDull;
+        p_Key ^= p_Key >> 33;
+        p_Key *= 0xC4CEB9FE1A85EC53ull;
+        p_Key ^= p_Key >> 33;
+        return p_Key;
+    }
+
+    /*! \brief The bit mask of the control bytes of a group equal to a
+     * byte
+     * \private
+     */
+    uint32_t matchByte(size_t p_Group, int8_t p_Byte) const
+    {
+#ifdef __SSE2__
+        __m128i l_Control = _mm_loadu_si128((const __m128i*)(m_Control + p_Group));
+
+        return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(l_Control, _mm_set1_epi8(p_Byte)));
+#else
+        uint32_t l_Mask = 0;
+
+        for (int i = 0; i < SWISS_GROUP_WIDTH; ++i)
+            if (m_Control[p_Group + i] == p_Byte)
+                l_Mask |= 1u << i;
+        return l_Mask;
+#endif
+    }
+
+    /*! \brief The bit mask of the EMPTY and DELETED bytes of a group
+     * \private
+     */
+    uint32_t matchFree(size_t p_Group) const
+    {
+#ifdef __SSE2__
+        return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(m_Control + p_Group)));
+#else
+        uint32_t l_Mask = 0;
+
+        for (int i = 0; i < SWISS_GROUP_WIDTH; ++i)
+            if (m_Control[p_Group + i] < 0)
+                l_Mask |= 1u << i;
+        return l_Mask;
+#endif
+    }
+
+    /*! \brief The slot of a key, m_Capacity if the key is not in the
+     * table
+     * \details The groups are probed in the triangular sequence, which
+     * visits every group as the number of groups is a power of two
+     * \private
+     */
+    size_t findSlot(uint64_t p_Key, uint64_t p_Hash) const
+    {
+        if (m_Capacity == 0)
+            return m_Capacity;
+
+        size_t l_GroupMask = m_Capacity / SWISS_GROUP_WIDTH - 1;
+        size_t l_Group = (size_t)(p_Hash >> 7) & l_GroupMask;
+
+        for (size_t l_Step = 1; ; ++l_Step)
+            {
+                size_t l_Base = l_Group * SWISS_GROUP_WIDTH;
+
+                for (uint32_t l_Match = matchByte(l_Base, (int8_t)(p_Hash & 0x7F)); l_Match != 0; l_Match &= l_Match - 1)
+                    {
+                        size_t l_Slot = l_Base + __builtin_ctz(l_Match);
+                        if (m_Slots[l_Slot].m_Key == p_Key)
+                            return l_Slot;
+                    }
+                if (matchByte(l_Base, SWISS_EMPTY) != 0 || l_Step > l_GroupMask)
+                    return m_Capacity;
+                l_Group = (l_Group + l_Step) & l_GroupMask;
+            }
+    }
+
+    /*! \brief The first EMPTY or DELETED slot of the probe of a hash
+     * \private
+     */
+    size_t findFree(uint64_t p_Hash) const
+    {
+        size_t l_GroupMask = m_Capacity / SWISS_GROUP_WIDTH - 1;
+        size_t l_Group = (size_t)(p_Hash >> 7) & l_GroupMask;
+
+        for (size_t l_Step = 1; ; ++l_Step)
+            {
+                size_t l_Base = l_Group * SWISS_GROUP_WIDTH;
+                uint32_t l_Free = matchFree(l_Base);
+
+                if (l_Free != 0)
+                    return l_Base + __builtin_ctz(l_Free);
+                l_Group = (l_Group + l_Step) & l_GroupMask;
+            }
+    }
+
+    /*! \brief Moves the keys to arrays of room for p_Count keys
+     * \private
+     */
+    void rehash(size_t p_Count)
+    {
+        size_t l_Capacity = SWISS_GROUP_WIDTH;
+
+        while (l_Capacity * 7 < p_Count * 16)
+            l_Capacity *= 2;
+
+        int8_t* l_OldControl = m_Control;
+        Slot* l_OldSlots = m_Slots;
+        size_t l_OldCapacity = m_Capacity;
+
+        m_Control = m_ControlAllocator.allocate(l_Capacity);
+        m_Slots = m_SlotAllocator.allocate(l_Capacity);
+        m_Capacity = l_Capacity;
+        m_Deleted = 0;
+        memset(m_Control, SWISS_EMPTY, m_Capacity);
+
+        for (size_t i = 0; i < l_OldCapacity; ++i)
+            if (l_OldControl[i] >= 0)
+                {
+                    size_t l_Slot = findFree(hash(l_OldSlots[i].m_Key));
+
+                    m_Control[l_Slot] = l_OldControl[i];
+                    new (&m_Slots[l_Slot]) Slot(std::move(l_OldSlots[i]));
+                    l_OldSlots[i].~Slot();
+                }
+        if (l_OldCapacity > 0)
+            {
+                m_ControlAllocator.deallocate(l_OldControl, l_OldCapacity);
+                m_SlotAllocator.deallocate(l_OldSlots, l_OldCapacity);
+            }
+    }
+
+    void release(void)
+    {
+        if (m_Capacity == 0)
+            return;
+        m_ControlAllocator.deallocate(m_Control, m_Capacity);
+        m_SlotAllocator.deallocate(m_Slots, m_Capacity);
+        m_Control = NULL;
+        m_Slots = NULL;
+        m_Capacity = 0;
+    }
+
+    HugePageAllocator<int8_t, TAG> m_ControlAllocator;
+
+    HugePageAllocator<Slot, TAG> m_SlotAllocator;
+
+    /*! \brief A control byte for each slot
+     * \private
+     */
+    int8_t* m_Control;
+
+    Slot* m_Slots;
+
+    /*! \brief Number of slots, a power of two of at least
+     * SWISS_GROUP_WIDTH
+     * \private
+     */
+    size_t m_Capacity;
+
+    size_t m_Size;
+
+    size_t m_Deleted;
+};
+
+
+#endif /* _SWISSTABLE_H_ */
@@ -0,0 +1,197 @@
+/*! \file SwitchFabric.cpp
+ *  \brief     Implementation of SwitchFabric module.
+ *  \details
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 12:21:07 2026
+ */
+
+
+#include "SwitchFabric.hpp"
+
+
+SwitchFabric::SwitchFabric(sc_module_name p_ModuleName, int p_IngressCount, int p_EgressCount, int p_VOQDepth, int p_Iterations, int p_Speedup):sc_module(p_ModuleName), m_IngressCount(p_IngressCount), m_EgressCount(p_EgressCount), m_VOQDepth(p_VOQDepth), m_Iterations(p_Iterations), m_Speedup(p_Speedup)
+{
+    EgressStatistics l_Empty;
+    l_Empty.m_Switched = 0;
+    l_Empty.m_Dropped = 0;
+    l_Empty.m_TotalLatency = SC_ZERO_TIME;
+    l_Empty.m_MaxLatency = SC_ZERO_TIME;
+
+    m_VOQ.resize(m_IngressCount * m_EgressCount);
+    m_GrantPointer.assign(m_EgressCount, 0);
+    m_AcceptPointer.assign(m_IngressCount, 0);
+    m_IngressMatch.assign(m_IngressCount, -1);
+    m_EgressMatch.assign(m_EgressCount, -1);
+    m_Grant.assign(m_EgressCount, -1);
+    m_Statistics.assign(m_EgressCount, l_Empty);
+
+    SC_THREAD(fabricMain);
+    sensitive << port_Clk.pos();
+}
+
+SwitchFabric::~SwitchFabric()
+{
+}
+
+
+bool SwitchFabric::enqueue(int p_Ingress, int p_Egress, const Packet& p_Packet)
+{
+    if (p_Egress < 0 || p_Egress >= m_EgressCount || p_Ingress < 0 || p_Ingress >= m_IngressCount)
+        return false;
+
+    deque<Cell>& l_Queue = voq(p_Ingress, p_Egress);
+    if ((int)l_Queue.size() >= m_VOQDepth)
+        {
+            m_Statistics[p_Egress].m_Dropped++;
+            return false;
+        }
+
+    l_Queue.push_back(Cell());
+    l_Queue.back().m_Packet = p_Packet;
+    l_Queue.back().m_EnqueueTime = sc_time_stamp();
+    return true;
+}
+
+int SwitchFabric::getEgressCount(void)
+{
+    return m_EgressCount;
+}
+
+
+void SwitchFabric::fabricMain(void)
+{
+    while(true)
+        {
+            wait();
+
+            for (int i = 0; i < m_Speedup; ++i)
+                schedule();
+        }
+}
+
+
+void SwitchFabric::schedule(void)
+{
+    int l_Egresses = min(m_EgressCount, port_ToInterface.size());
+
+    m_IngressMatch.assign(m_IngressCount, -1);
+    m_EgressMatch.assign(m_EgressCount, -1);
+
+    for (int l_Iteration = 0; l_Iteration < m_Iterations; ++l_Iteration)
+        {
+            bool l_Matched = false;
+
+            //request and grant: each free egress grants the next
+            //requesting ingress from its grant pointer onwards
+            for (int j = 0; j < l_Egresses; ++j)
+                {
+                    m_Grant[j] = -1;
+                    if (m_EgressMatch[j] != -1 || port_ToInterface[j]->num_free() <= 0)
+                        continue;
+                    for (int k = 0; k < m_IngressCount; ++k)
+                        {
+                            int i = (m_GrantPointer[j] + k) % m_IngressCount;
+                            if (m_IngressMatch[i] == -1 && !voq(i, j).empty())
+                                {
+                                    m_Grant[j] = i;
+                                    break;
+                                }
+                        }
+                }
+
+            //accept: each free ingress accepts the next granting egress
+            //from its accept pointer onwards
+            for (int i = 0; i < m_IngressCount; ++i)
+                {
+                    if (m_IngressMatch[i] != -1)
+                        continue;
+                    for (int k = 0; k < l_Egresses; ++k)
+                        {
+                            int j = (m_AcceptPointer[i] + k) % l_Egresses;
+                            if (m_Grant[j] != i)
+                                continue;
+
+                            m_IngressMatch[i] = j;
+                            m_EgressMatch[j] = i;
+                            l_Matched = true;
+
+                            //the pointers move only on the first
+                            //iteration to avoid starvation
+                            if (l_Iteration == 0)
+                                {
+                                    m_GrantPointer[j] = (i + 1) % m_IngressCount;
+                                    m_AcceptPointer[i] = (j + 1) % l_Egresses;
+                                }
+                            break;
+                        }
+                }
+
+            if (!l_Matched)
+                break;
+        }
+
+    //transfer the head cells of the matched VOQs through the crossbar
+    for (int i = 0; i < m_IngressCount; ++i)
+        {
+            int j = m_IngressMatch[i];
+            if (j == -1)
+                continue;
+
+            deque<Cell>& l_Queue = voq(i, j);
+            EgressStatistics& l_Statistics = m_Statistics[j];
+            sc_time l_Latency = sc_time_stamp() - l_Queue.front().m_EnqueueTime;
+
+            if (port_ToInterface[j]->nb_write(l_Queue.front().m_Packet))
+                {
+                    l_Statistics.m_Switched++;
+                    l_Statistics.m_TotalLatency += l_Latency;
+                    if (l_Latency > l_Statistics.m_MaxLatency)
+                        l_Statistics.m_MaxLatency = l_Latency;
+                }
+            else
+                l_Statistics.m_Dropped++;
+            l_Queue.pop_front();
+        }
+}
+
+
+deque<SwitchFabric::Cell>& SwitchFabric::voq(int p_Ingress, int p_Egress)
+{
+    return m_VOQ[p_Ingress * m_EgressCount + p_Egress];
+}
+
+
+unsigned long SwitchFabric::getSwitchedCount(int p_Egress) const
+{
+    return m_Statistics[p_Egress].m_Switched;
+}
+
+unsigned long SwitchFabric::getDropCount(int p_Egress) const
+{
+    return m_Statistics[p_Egress].m_Dropped;
+}
+
+sc_time SwitchFabric::getMeanLatency(int p_Egress) const
+{
+    if (m_Statistics[p_Egress].m_Switched == 0)
+        return SC_ZERO_TIME;
+    return m_Statistics[p_Egress].m_TotalLatency / (double)m_Statistics[p_Egress].m_Switched;
+}
+
+sc_time SwitchFabric::getMaxLatency(int p_Egress) const
+{
+    return m_Statistics[p_Egress].m_MaxLatency;
+}
+
+
+void SwitchFabric::printStatistics(void)
+{
+    for (int j = 0; j < m_EgressCount; ++j)
+        cout << name() << " egress " << j << ": switched " << getSwitchedCount(j) << ", dropped " << getDropCount(j) << ", mean latency " << getMeanLatency(j) << ", max latency " << getMaxLatency(j) << endl;
+}
+
+void SwitchFabric::end_of_simulation()
+{
+    printStatistics();
+}
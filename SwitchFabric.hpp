@@ -0,0 +1,205 @@
+/*! \file  SwitchFabric.hpp
+ *  \brief     Header file of SwitchFabric module
+ *  \details
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Sun Oct 18 12:21:07 2026
+ */
+
+/*!
+ * \class SwitchFabric
+ * \brief Crossbar fabric between the line cards of a router
+ *  \details The fabric keeps one virtual output queue (VOQ) for each
+ * (ingress line card, egress interface) pair, so a packet waiting for
+ * a busy interface never blocks the packets of the same line card
+ * that are heading to other interfaces. On every clock cycle the iSLIP
+ * scheduler runs m_Speedup matching rounds of m_Iterations
+ * request-grant-accept iterations and transfers the head cell of every
+ * matched VOQ to the forwarding buffer of its interface. An egress
+ * interface takes part in the matching only if its forwarding buffer
+ * has room.
+ *
+ * The fabric counts the switched and dropped packets and the queueing
+ * latency per egress interface and prints a report at the end of the
+ * simulation.
+ */
+
+
+#include "systemc"
+#include <deque>
+#include <vector>
+#include "Packet.hpp"
+#include "Fabric_In_If.hpp"
+
+using namespace std;
+using namespace sc_core;
+using namespace sc_dt;
+
+#ifndef _SWITCHFABRIC_H_
+#define _SWITCHFABRIC_H_
+
+
+/*! \def FABRIC_VOQ_DEPTH
+ *  \brief Default capacity of one virtual output queue
+ */
+#define FABRIC_VOQ_DEPTH 64
+
+/*! \def FABRIC_ISLIP_ITERATIONS
+ *  \brief Default number of iSLIP iterations per matching round
+ */
+#define FABRIC_ISLIP_ITERATIONS 4
+
+
+
+class SwitchFabric: public sc_module, public Fabric_In_If
+{
+
+public:
+
+    /*! \brief Clock signal
+     * \details One matching round is a cell time
+     * \public
+     */
+    sc_in_clk port_Clk;
+
+    /*! \brief Forwarding port
+     * \details Bound to the forwarding buffers of every interface of
+     * the router in the router's interface order
+     * \public
+     */
+    sc_port<sc_fifo_out_if<Packet>,0, SC_ZERO_OR_MORE_BOUND> port_ToInterface;
+
+
+    /*!
+     * \brief Constructor
+     * \details Builds the fabric
+     * @param[in] p_ModuleName The name of the module
+     * @param[in] int p_IngressCount The number of line cards
+     * @param[in] int p_EgressCount The number of interfaces
+     * @param[in] int p_VOQDepth The capacity of one VOQ
+     * @param[in] int p_Iterations iSLIP iterations per matching round
+     * @param[in] int p_Speedup Matching rounds per clock cycle
+     * \public
+     */
+    SwitchFabric(sc_module_name p_ModuleName, int p_IngressCount, int p_EgressCount, int p_VOQDepth = FABRIC_VOQ_DEPTH, int p_Iterations = FABRIC_ISLIP_ITERATIONS, int p_Speedup = 1);
+
+    ~SwitchFabric();
+
+    virtual bool enqueue(int p_Ingress, int p_Egress, const Packet& p_Packet);
+
+    virtual int getEgressCount(void);
+
+    /*! \brief The main process of the fabric
+     * \details Runs the iSLIP scheduler on every clock cycle
+     * \public
+     */
+    void fabricMain(void);
+
+    /*! \brief Prints the fabric statistics
+     * \public
+     */
+    void printStatistics(void);
+
+    /*! \brief Number of packets switched to the egress interface
+     * \public
+     */
+    unsigned long getSwitchedCount(int p_Egress) const;
+
+    /*! \brief Number of packets dropped on full VOQs of the egress
+     * interface
+     * \public
+     */
+    unsigned long getDropCount(int p_Egress) const;
+
+    /*! \brief Mean queueing latency of the egress interface
+     * \public
+     */
+    sc_time getMeanLatency(int p_Egress) const;
+
+    /*! \brief Maximum queueing latency of the egress interface
+     * \public
+     */
+    sc_time getMaxLatency(int p_Egress) const;
+
+    void end_of_simulation();
+
+    SC_HAS_PROCESS(SwitchFabric);
+
+private:
+
+    /*! \brief A packet in a VOQ
+     * \private
+     */
+    struct Cell
+    {
+        Packet m_Packet;
+        sc_time m_EnqueueTime;
+    };
+
+    /*! \brief Per egress statistics
+     * \private
+     */
+    struct EgressStatistics
+    {
+        unsigned long m_Switched;
+        unsigned long m_Dropped;
+        sc_time m_TotalLatency;
+        sc_time m_MaxLatency;
+    };
+
+    /*! \brief Runs one iSLIP matching round and transfers the cells
+     * \private
+     */
+    void schedule(void);
+
+    /*! \brief The VOQ of the (ingress, egress) pair
+     * \private
+     */
+    deque<Cell>& voq(int p_Ingress, int p_Egress);
+
+    int m_IngressCount;
+
+    int m_EgressCount;
+
+    int m_VOQDepth;
+
+    int m_Iterations;
+
+    int m_Speedup;
+
+    /*! \brief The VOQs, indexed by ingress * m_EgressCount + egress
+     * \private
+     */
+    vector<deque<Cell> > m_VOQ;
+
+    /*! \brief iSLIP round robin grant pointer of each egress
+     * \private
+     */
+    vector<int> m_GrantPointer;
+
+    /*! \brief iSLIP round robin accept pointer of each ingress
+     * \private
+     */
+    vector<int> m_AcceptPointer;
+
+    /*! \brief The egress matched with each ingress, -1 if none
+     * \private
+     */
+    vector<int> m_IngressMatch;
+
+    /*! \brief The ingress matched with each egress, -1 if none
+     * \private
+     */
+    vector<int> m_EgressMatch;
+
+    /*! \brief The ingress granted by each egress in the current
+     * iteration, -1 if none
+     * \private
+     */
+    vector<int> m_Grant;
+
+    vector<EgressStatistics> m_Statistics;
+};
+
+
+#endif /* _SWITCHFABRIC_H_ */
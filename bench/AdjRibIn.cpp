@@ -0,0 +1,258 @@
+/*! \file  AdjRibIn.cpp
+ *  \brief     Benchmark of the Adj-RIB-In with SwissTable and std::map
+ *  \details Applies the same UPDATE stream to the Adj-RIB-Ins of the
+ *  peers held once in SwissTables, as the ControlPlane holds them, and
+ *  once in std::maps. The stream is a full table of random prefixes
+ *  announced by random peers three times with random AS path lengths,
+ *  and on the third pass a fifth of them are withdrawn instead. As in
+ *  processUpdate, an announcement equal to the peer's route is a
+ *  duplicate and one that differs is an implicit withdraw. The two
+ *  tables shall count the same duplicates and implicit withdraws.
+ *
+ *  Before the timing the SwissTable is checked against std::map with
+ *  random inserts, erases and finds.
+ *
+ *  Usage: AdjRibIn [updates] [runs]
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Mon Oct 19 11:58:13 2026
+ */
+
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <vector>
+#include <stdint.h>
+#include "../SwissTable.hpp"
+
+using namespace std;
+
+
+
+/*! \def BENCH_PEERS
+ *  \brief The number of sessions, each with its own Adj-RIB-In
+ */
+#define BENCH_PEERS 16
+
+/*! \def BENCH_PASSES
+ *  \brief The number of times the stream is applied
+ *  \details The withdraws are applied on the last pass
+ */
+#define BENCH_PASSES 3
+
+/*! \def BENCH_CHECK_OPERATIONS
+ *  \brief The number of random operations of the correctness check
+ */
+#define BENCH_CHECK_OPERATIONS 2000000
+
+
+
+/*! \brief The fields of AdjRibRoute, which is declared with the
+ * ControlPlane module
+ */
+struct BenchRoute
+{
+    int m_OutboundInterface;
+
+    uint32_t m_PeerIdentifier;
+
+    int m_PathLength;
+
+    int m_Origin;
+
+    uint32_t m_AggregatorAS;
+
+    uint32_t m_AggregatorIdentifier;
+};
+
+/*! \brief An UPDATE of the stream
+ */
+struct BenchUpdate
+{
+    int m_Peer;
+
+    uint64_t m_Key;
+
+    int m_PathLength;
+
+    bool m_Withdraw;
+};
+
+/*! \brief The duplicates and the implicit withdraws of a run
+ */
+struct BenchCounts
+{
+    long m_Duplicates;
+
+    long m_ImplicitWithdraws;
+};
+
+static bool isSameRoute(const BenchRoute& p_A, const BenchRoute& p_B)
+{
+    return p_A.m_OutboundInterface == p_B.m_OutboundInterface && p_A.m_PeerIdentifier == p_B.m_PeerIdentifier && p_A.m_PathLength == p_B.m_PathLength && p_A.m_Origin == p_B.m_Origin && p_A.m_AggregatorAS == p_B.m_AggregatorAS && p_A.m_AggregatorIdentifier == p_B.m_AggregatorIdentifier;
+}
+
+static BenchRoute toRoute(const BenchUpdate& p_Update)
+{
+    BenchRoute l_Route = {p_Update.m_Peer, 0x0A000001u + p_Update.m_Peer, p_Update.m_PathLength, 0, 0, 0};
+
+    return l_Route;
+}
+
+/*! \brief Checks the SwissTable against std::map
+ * \return \b <bool> True if they agreed on every operation
+ */
+static bool check(mt19937_64& p_Random)
+{
+    SwissTable<int, MEMORY_RIB> l_Table;
+    map<uint64_t, int> l_Map;
+
+    for (int i = 0; i < BENCH_CHECK_OPERATIONS; ++i)
+        {
+            uint64_t l_Key = p_Random() % 50000;
+            int l_Op = p_Random() % 4;
+
+            if (l_Op < 2)
+                {
+                    int l_Value = (int)p_Random();
+                    bool l_Inserted;
+
+                    l_Table.insert(l_Key, l_Inserted) = l_Value;
+                    if (l_Inserted != (l_Map.count(l_Key) == 0))
+                        return false;
+                    l_Map[l_Key] = l_Value;
+                }
+            else if (l_Op == 2)
+                {
+                    if (l_Table.erase(l_Key) != (l_Map.erase(l_Key) > 0))
+                        return false;
+                }
+            else
+                {
+                    int* l_Found = l_Table.find(l_Key);
+                    map<uint64_t, int>::iterator l_It = l_Map.find(l_Key);
+
+                    if ((l_Found != NULL) != (l_It != l_Map.end()) || (l_Found != NULL && *l_Found != l_It->second))
+                        return false;
+                }
+            if (l_Table.size() != l_Map.size())
+                return false;
+        }
+    return true;
+}
+
+static BenchCounts runSwissTable(const vector<BenchUpdate>& p_Stream)
+{
+    BenchCounts l_Counts = {0, 0};
+    vector<SwissTable<BenchRoute, MEMORY_RIB> > l_AdjRibIns(BENCH_PEERS);
+
+    for (int l_Pass = 0; l_Pass < BENCH_PASSES; ++l_Pass)
+        for (size_t i = 0; i < p_Stream.size(); ++i)
+            {
+                const BenchUpdate& l_Update = p_Stream[i];
+                SwissTable<BenchRoute, MEMORY_RIB>& l_AdjRibIn = l_AdjRibIns[l_Update.m_Peer];
+
+                if (l_Update.m_Withdraw && l_Pass == BENCH_PASSES - 1)
+                    {
+                        l_AdjRibIn.erase(l_Update.m_Key);
+                        continue;
+                    }
+
+                BenchRoute l_New = toRoute(l_Update);
+                bool l_Inserted;
+                BenchRoute& l_Route = l_AdjRibIn.insert(l_Update.m_Key, l_Inserted);
+
+                if (!l_Inserted && isSameRoute(l_Route, l_New))
+                    {
+                        l_Counts.m_Duplicates++;
+                        continue;
+                    }
+                if (!l_Inserted)
+                    l_Counts.m_ImplicitWithdraws++;
+                l_Route = l_New;
+            }
+    return l_Counts;
+}
+
+static BenchCounts runMap(const vector<BenchUpdate>& p_Stream)
+{
+    BenchCounts l_Counts = {0, 0};
+    vector<map<uint64_t, BenchRoute> > l_AdjRibIns(BENCH_PEERS);
+
+    for (int l_Pass = 0; l_Pass < BENCH_PASSES; ++l_Pass)
+        for (size_t i = 0; i < p_Stream.size(); ++i)
+            {
+                const BenchUpdate& l_Update = p_Stream[i];
+                map<uint64_t, BenchRoute>& l_AdjRibIn = l_AdjRibIns[l_Update.m_Peer];
+
+                if (l_Update.m_Withdraw && l_Pass == BENCH_PASSES - 1)
+                    {
+                        l_AdjRibIn.erase(l_Update.m_Key);
+                        continue;
+                    }
+
+                BenchRoute l_New = toRoute(l_Update);
+                pair<map<uint64_t, BenchRoute>::iterator, bool> l_Inserted = l_AdjRibIn.insert(make_pair(l_Update.m_Key, l_New));
+
+                if (!l_Inserted.second && isSameRoute(l_Inserted.first->second, l_New))
+                    {
+                        l_Counts.m_Duplicates++;
+                        continue;
+                    }
+                if (!l_Inserted.second)
+                    l_Counts.m_ImplicitWithdraws++;
+                l_Inserted.first->second = l_New;
+            }
+    return l_Counts;
+}
+
+int main(int argc, char *argv[])
+{
+    int l_UpdateCount = argc > 1 ? atoi(argv[1]) : 1000000;
+    int l_Runs = argc > 2 ? atoi(argv[2]) : 2;
+    mt19937_64 l_Random(3);
+
+    if (!check(l_Random))
+        {
+            printf("SwissTable disagrees with std::map\n");
+            return 1;
+        }
+    printf("SwissTable agrees with std::map on %d operations\n", BENCH_CHECK_OPERATIONS);
+
+    //prefixes of 16 to 24 bits packed with their length as the
+    //ControlPlane keys them
+    vector<BenchUpdate> l_Stream(l_UpdateCount);
+    for (int i = 0; i < l_UpdateCount; ++i)
+        {
+            int l_Length = 16 + l_Random() % 9;
+            uint32_t l_Prefix = (uint32_t)l_Random() & ~(0xFFFFFFFFu >> l_Length);
+
+            l_Stream[i].m_Peer = l_Random() % BENCH_PEERS;
+            l_Stream[i].m_Key = ((uint64_t)l_Prefix << 8) | l_Length;
+            l_Stream[i].m_PathLength = l_Random() % 6;
+            l_Stream[i].m_Withdraw = (l_Random() % 5 == 0);
+        }
+
+    for (int l_Run = 0; l_Run < l_Runs; ++l_Run)
+        {
+            chrono::steady_clock::time_point l_Start = chrono::steady_clock::now();
+            BenchCounts l_Swiss = runSwissTable(l_Stream);
+            chrono::steady_clock::time_point l_Middle = chrono::steady_clock::now();
+            BenchCounts l_Map = runMap(l_Stream);
+            chrono::steady_clock::time_point l_End = chrono::steady_clock::now();
+
+            double l_SwissMs = chrono::duration<double, milli>(l_Middle - l_Start).count();
+            double l_MapMs = chrono::duration<double, milli>(l_End - l_Middle).count();
+
+            if (l_Swiss.m_Duplicates != l_Map.m_Duplicates || l_Swiss.m_ImplicitWithdraws != l_Map.m_ImplicitWithdraws)
+                {
+                    printf("the tables counted different updates\n");
+                    return 1;
+                }
+            printf("%d peers, %d updates x %d passes: SwissTable %.0f ms, std::map %.0f ms, speedup %.1fx (duplicates %ld, implicit withdraws %ld)\n", BENCH_PEERS, l_UpdateCount, BENCH_PASSES, l_SwissMs, l_MapMs, l_MapMs / l_SwissMs, l_Swiss.m_Duplicates, l_Swiss.m_ImplicitWithdraws);
+        }
+    return 0;
+}
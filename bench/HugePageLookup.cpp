@@ -0,0 +1,175 @@
+/*! \file  HugePageLookup.cpp
+ *  \brief     Benchmark of the FIB lookups with and without the huge
+ *  page arena
+ *  \details Fills a RoutingTable with random routes and times random
+ *  lookups of it, the median of the runs. The dTLB read misses are
+ *  counted with perf_event_open where the host permits it. Before the
+ *  lookups the footprint of the FIB caches of 16 line cards is
+ *  printed: the bytes the arena has mapped and the process's
+ *  AnonHugePages.
+ *
+ *  The arena is a compile-time switch, so the benchmark is built twice:
+ *  HugePageLookup with the arena and HugePageLookup_4k with
+ *  HUGE_PAGE_ARENA=0 on the ordinary heap.
+ *
+ *  Usage: HugePageLookup [routes] [lookups] [runs]
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Mon Oct 19 11:26:50 2026
+ */
+
+
+#include "systemc"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include "../RoutingTable.hpp"
+#include "../FibCache.hpp"
+#include "../HugePageArena.hpp"
+
+using namespace std;
+
+
+
+/*! \def BENCH_LINECARDS
+ *  \brief The number of line cards whose FIB caches are allocated
+ */
+#define BENCH_LINECARDS 16
+
+/*! \def BENCH_INTERFACES
+ *  \brief The number of outbound interfaces of the random routes
+ */
+#define BENCH_INTERFACES 16
+
+
+
+/*! \brief Opens a counter of the process's dTLB read misses
+ * \return \b <int> The descriptor of the counter, -1 if the host does
+ * not permit it
+ */
+static int openTLBCounter(void)
+{
+    perf_event_attr l_Attr;
+
+    memset(&l_Attr, 0, sizeof(l_Attr));
+    l_Attr.size = sizeof(l_Attr);
+    l_Attr.type = PERF_TYPE_HW_CACHE;
+    l_Attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    l_Attr.disabled = 1;
+    l_Attr.exclude_kernel = 1;
+    return (int)syscall(__NR_perf_event_open, &l_Attr, 0, -1, -1, 0);
+}
+
+/*! \brief Gives the AnonHugePages of the process in kB
+ * \return \b <long> -1 if the kernel does not report it
+ */
+static long getAnonHugeKB(void)
+{
+    ifstream l_File("/proc/self/smaps_rollup");
+    string l_Line;
+
+    while (getline(l_File, l_Line))
+        if (l_Line.compare(0, 14, "AnonHugePages:") == 0)
+            return atol(l_Line.c_str() + 14);
+    return -1;
+}
+
+static uint32_t randomAddress(void)
+{
+    return ((uint32_t)rand() << 1) ^ (uint32_t)rand();
+}
+
+int sc_main(int argc, char *argv[])
+{
+    int l_RouteCount = argc > 1 ? atoi(argv[1]) : 1000000;
+    int l_LookupCount = argc > 2 ? atoi(argv[2]) : 10000000;
+    int l_Runs = argc > 3 ? atoi(argv[3]) : 5;
+
+    printf("huge page arena %s\n", HUGE_PAGE_ARENA ? "on" : "off");
+
+    {
+        RoutingTable l_Empty;
+        vector<FibCache*> l_Caches;
+
+        for (int i = 0; i < BENCH_LINECARDS; ++i)
+            l_Caches.push_back(new FibCache(&l_Empty));
+        printf("%d FIB caches: arena mapped %zu kB, AnonHugePages %ld kB\n", BENCH_LINECARDS, HugePageArena::getMappedBytes() >> 10, getAnonHugeKB());
+        for (int i = 0; i < BENCH_LINECARDS; ++i)
+            delete l_Caches[i];
+    }
+
+    srand(1);
+
+    vector<RouteEntry> l_Routes(l_RouteCount);
+    for (int i = 0; i < l_RouteCount; ++i)
+        {
+            l_Routes[i].m_Length = 8 + rand() % 25;
+            l_Routes[i].m_Prefix = maskPrefix(randomAddress(), l_Routes[i].m_Length);
+            l_Routes[i].m_OutboundInterface = rand() % BENCH_INTERFACES;
+        }
+
+    RoutingTable l_Table;
+    l_Table.setRoutes(l_Routes);
+
+    vector<uint32_t> l_Addresses(l_LookupCount);
+    for (int i = 0; i < l_LookupCount; ++i)
+        l_Addresses[i] = randomAddress();
+
+    int l_Counter = openTLBCounter();
+    vector<double> l_Times;
+    long long l_Misses = 0;
+    long l_Sink = 0;
+
+    //warms the caches and lets the kernel back the table
+    for (int i = 0; i < l_LookupCount / 10; ++i)
+        l_Sink += l_Table.resolveRoute(l_Addresses[i]);
+
+    for (int l_Run = 0; l_Run < l_Runs; ++l_Run)
+        {
+            if (l_Counter >= 0)
+                {
+                    ioctl(l_Counter, PERF_EVENT_IOC_RESET, 0);
+                    ioctl(l_Counter, PERF_EVENT_IOC_ENABLE, 0);
+                }
+
+            chrono::steady_clock::time_point l_Start = chrono::steady_clock::now();
+
+            for (int i = 0; i < l_LookupCount; ++i)
+                l_Sink += l_Table.resolveRoute(l_Addresses[i]);
+
+            chrono::steady_clock::time_point l_End = chrono::steady_clock::now();
+
+            if (l_Counter >= 0)
+                {
+                    long long l_Count = 0;
+
+                    ioctl(l_Counter, PERF_EVENT_IOC_DISABLE, 0);
+                    if (read(l_Counter, &l_Count, sizeof(l_Count)) == sizeof(l_Count))
+                        l_Misses += l_Count;
+                }
+            l_Times.push_back(chrono::duration<double, nano>(l_End - l_Start).count() / l_LookupCount);
+            printf("run %d: %.1f ns per lookup\n", l_Run, l_Times.back());
+        }
+
+    sort(l_Times.begin(), l_Times.end());
+    printf("%d routes, %d lookups: median %.1f ns per lookup (checksum %ld)\n", l_Table.getRouteCount(), l_LookupCount, l_Times[l_Times.size() / 2], l_Sink);
+    if (l_Counter >= 0)
+        printf("dTLB read misses per lookup %.3f\n", (double)l_Misses / ((double)l_LookupCount * l_Runs));
+    else
+        printf("dTLB read misses: not available, perf_event_open is not permitted\n");
+    printf("arena mapped %zu kB, fallbacks %zu, AnonHugePages %ld kB\n", HugePageArena::getMappedBytes() >> 10, HugePageArena::getFallbackCount(), getAnonHugeKB());
+
+    if (l_Counter >= 0)
+        close(l_Counter);
+    return 0;
+}
@@ -0,0 +1,364 @@
+/*! \file  MessagePath.cpp
+ *  \brief     Microbenchmark of the message path with SystemC and native
+ *  datatypes
+ *  \details Each iteration queues a BGP message, checks its identifier
+ *  against the session, wraps it in a packet and passes the packet
+ *  through a buffer. It also builds, buffers, replicates and routes one
+ *  IP packet. The message and the packet are replicas of BGPMessage and
+ *  Packet templated on the identifier and the payload, so the two runs
+ *  differ only by the datatypes:
+ *
+ *  - legacy: sc_int<32> identifiers and addresses, sc_bv<192> IP payload
+ *  - native: uint32_t identifiers and addresses, byte array IP payload
+ *
+ *  Built against SystemC by default. With MESSAGEPATH_STANDINS the
+ *  legacy side is run on stand-ins that reproduce the SystemC 2.3
+ *  layout of sc_int_base (vtable, int64 value, sign extension on every
+ *  set) and sc_bv_base (heap-allocated word array), for a host without
+ *  the SystemC library.
+ *
+ *  Usage: MessagePath [iterations] [runs]
+ *  \author    Antti Siirilä, 501449
+ *  \version   1.0
+ *  \date      Mon Oct 19 10:41:27 2026
+ */
+
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include <deque>
+#include <stdint.h>
+
+#ifndef MESSAGEPATH_STANDINS
+#include "systemc"
+#endif
+
+using namespace std;
+
+
+
+/*! \def BENCH_PAYLOAD_BITS
+ *  \brief The IP payload of the benchmarked packets in bits
+ */
+#define BENCH_PAYLOAD_BITS 192
+
+/*! \def BENCH_PEERS
+ *  \brief The number of sessions the messages are checked against
+ */
+#define BENCH_PEERS 8
+
+/*! \def BENCH_FIB_SIZE
+ *  \brief The number of entries of the table the packets are routed by
+ */
+#define BENCH_FIB_SIZE 4096
+
+
+
+#ifdef MESSAGEPATH_STANDINS
+
+/*!
+ * \class LegacyInt32
+ * \brief Stand-in of sc_int<32>
+ *  \details The layout of sc_int_base: a vtable, an int64 value, the
+ * length and the unused length. The value is sign extended on every
+ * set.
+ */
+class LegacyInt32
+{
+public:
+    LegacyInt32():m_Value(0), m_Length(32), m_Unused(32){}
+    LegacyInt32(long long p_Value):m_Value(p_Value), m_Length(32), m_Unused(32){ extendSign(); }
+    LegacyInt32(const LegacyInt32& p_Int):m_Value(p_Int.m_Value), m_Length(p_Int.m_Length), m_Unused(p_Int.m_Unused){}
+    virtual ~LegacyInt32(){}
+
+    LegacyInt32& operator = (const LegacyInt32& p_Int)
+    {
+        m_Value = p_Int.m_Value;
+        extendSign();
+        return *this;
+    }
+
+    LegacyInt32& operator = (long long p_Value)
+    {
+        m_Value = p_Value;
+        extendSign();
+        return *this;
+    }
+
+    operator long long() const { return m_Value; }
+
+    virtual int length() const { return m_Length; }
+
+private:
+    void extendSign(void)
+    {
+        m_Value = (long long)((unsigned long long)m_Value << m_Unused) >> m_Unused;
+    }
+
+    long long m_Value;
+    int m_Length;
+    int m_Unused;
+};
+
+/*!
+ * \class LegacyBv
+ * \brief Stand-in of sc_bv<W>
+ *  \details The layout of sc_bv_base: a vtable, the length, the word
+ * count and the words allocated from the heap.
+ */
+template <int W>
+class LegacyBv
+{
+public:
+    LegacyBv():m_Length(W), m_Size((W + 31) / 32), m_Data(new unsigned int[(W + 31) / 32])
+    {
+        for (int i = 0; i < m_Size; ++i)
+            m_Data[i] = 0;
+    }
+
+    LegacyBv(int p_Value):LegacyBv(){ m_Data[0] = (unsigned int)p_Value; }
+
+    LegacyBv(const LegacyBv& p_Bv):m_Length(p_Bv.m_Length), m_Size(p_Bv.m_Size), m_Data(new unsigned int[p_Bv.m_Size])
+    {
+        for (int i = 0; i < m_Size; ++i)
+            m_Data[i] = p_Bv.m_Data[i];
+    }
+
+    virtual ~LegacyBv(){ delete[] m_Data; }
+
+    LegacyBv& operator = (const LegacyBv& p_Bv)
+    {
+        if (this != &p_Bv)
+            for (int i = 0; i < m_Size; ++i)
+                m_Data[i] = p_Bv.m_Data[i];
+        return *this;
+    }
+
+private:
+    int m_Length;
+    int m_Size;
+    unsigned int *m_Data;
+};
+
+typedef LegacyInt32 LegacyId;
+typedef LegacyBv<BENCH_PAYLOAD_BITS> LegacyBits;
+
+#else
+
+typedef sc_dt::sc_int<32> LegacyId;
+typedef sc_dt::sc_bv<BENCH_PAYLOAD_BITS> LegacyBits;
+
+#endif
+
+
+
+/*!
+ * \class BenchMessage
+ * \brief Replica of BGPMessage with the identifier of the type ID
+ */
+template <class ID>
+struct BenchMessage
+{
+    BenchMessage():m_Type(0), m_BGPIdentifier(0), m_OutboundInterface(0), m_Prefix(0), m_PrefixLength(0), m_Withdraw(false), m_PathLength(0){}
+
+    BenchMessage(const BenchMessage& p_Msg){ *this = p_Msg; }
+
+    BenchMessage& operator = (const BenchMessage& p_Msg)
+    {
+        m_Type = p_Msg.m_Type;
+        m_BGPIdentifier = p_Msg.m_BGPIdentifier;
+        m_OutboundInterface = p_Msg.m_OutboundInterface;
+        m_Prefix = p_Msg.m_Prefix;
+        m_PrefixLength = p_Msg.m_PrefixLength;
+        m_Withdraw = p_Msg.m_Withdraw;
+        m_PathLength = p_Msg.m_PathLength;
+        return *this;
+    }
+
+    int m_Type;
+    ID m_BGPIdentifier;
+    int m_OutboundInterface;
+    uint32_t m_Prefix;
+    int m_PrefixLength;
+    bool m_Withdraw;
+    int m_PathLength;
+};
+
+/*! \brief Replica of PacketPayload with the legacy datatypes
+ */
+struct LegacyPayload
+{
+    BenchMessage<LegacyId> m_BGPPayload;
+    LegacyBits m_IPPayload;
+};
+
+/*! \brief Replica of PacketPayload with the native datatypes
+ */
+struct NativePayload
+{
+    NativePayload(){ memset(m_IPPayload, 0, sizeof(m_IPPayload)); }
+
+    BenchMessage<uint32_t> m_BGPPayload;
+    unsigned char m_IPPayload[BENCH_PAYLOAD_BITS / 8];
+};
+
+/*!
+ * \class BenchPacket
+ * \brief Replica of Packet, whose payload P is shared by the copies
+ *  \details The payload is copied when a shared payload is written
+ */
+template <class P, class ID>
+struct BenchPacket
+{
+    BenchPacket():m_ProtocolType(0), m_DestinationAddress(0){}
+
+    BenchPacket(const BenchPacket& p_Pkt){ *this = p_Pkt; }
+
+    BenchPacket& operator = (const BenchPacket& p_Pkt)
+    {
+        m_Payload = p_Pkt.m_Payload;
+        m_ProtocolType = p_Pkt.m_ProtocolType;
+        m_DestinationAddress = p_Pkt.m_DestinationAddress;
+        return *this;
+    }
+
+    P& writable(void)
+    {
+        if (!m_Payload)
+            m_Payload = make_shared<P>();
+        else if (m_Payload.use_count() > 1)
+            m_Payload = make_shared<P>(*m_Payload);
+        return *m_Payload;
+    }
+
+    shared_ptr<P> m_Payload;
+    int m_ProtocolType;
+    ID m_DestinationAddress;
+};
+
+
+
+/*! \brief Routes an address by a hash of it
+ */
+static int lookup(const vector<int>& p_Fib, uint32_t p_Address)
+{
+    return p_Fib[(p_Address * 2654435761u) >> 20];
+}
+
+static void setPayload(LegacyPayload& p_Payload, int p_Value)
+{
+    p_Payload.m_IPPayload = LegacyBits(p_Value);
+}
+
+static void setPayload(NativePayload& p_Payload, int p_Value)
+{
+    unsigned char l_Byte = (unsigned char)p_Value;
+
+    memcpy(p_Payload.m_IPPayload, &l_Byte, 1);
+    memset(p_Payload.m_IPPayload + 1, 0, sizeof(p_Payload.m_IPPayload) - 1);
+}
+
+/*! \brief Runs the message path p_Iterations times
+ * \return \b <double> The mean time of an iteration in nanoseconds
+ */
+template <class ID, class P>
+double run(int p_Iterations)
+{
+    typedef BenchMessage<ID> Message;
+    typedef BenchPacket<P, ID> Pkt;
+
+    vector<int> l_Fib(BENCH_FIB_SIZE, 1);
+    deque<Message> l_Queue;
+    deque<Pkt> l_Fifo;
+    vector<ID> l_Peers(BENCH_PEERS);
+    unsigned long long l_Sink = 0;
+
+    for (int i = 0; i < BENCH_PEERS; ++i)
+        l_Peers[i] = 0x0A000001 + i;
+
+    chrono::steady_clock::time_point l_Start = chrono::steady_clock::now();
+
+    for (int i = 0; i < p_Iterations; ++i)
+        {
+            //a BGP message: received, queued, checked against the
+            //session and sent back in a packet
+            Message l_Msg;
+            l_Msg.m_Type = 2;
+            l_Msg.m_BGPIdentifier = 0x0A000001 + (i % BENCH_PEERS);
+            l_Msg.m_OutboundInterface = i % BENCH_PEERS;
+            l_Msg.m_Prefix = (uint32_t)i << 8;
+            l_Msg.m_PrefixLength = 24;
+            l_Queue.push_back(l_Msg);
+            Message l_Received = l_Queue.front();
+            l_Queue.pop_front();
+            l_Sink += (l_Received.m_BGPIdentifier == l_Peers[l_Received.m_OutboundInterface]);
+
+            Pkt l_Pkt;
+            l_Pkt.writable().m_BGPPayload = l_Received;
+            l_Pkt.m_ProtocolType = 1;
+            l_Fifo.push_back(l_Pkt);
+            Pkt l_Forwarded = l_Fifo.front();
+            l_Fifo.pop_front();
+            Message l_Back = l_Forwarded.m_Payload->m_BGPPayload;
+            l_Sink += l_Back.m_PathLength;
+
+            //an IP packet: built, forwarded through a buffer, replicated
+            //and routed by its destination
+            Pkt l_IP;
+            setPayload(l_IP.writable(), i);
+            l_IP.m_DestinationAddress = (uint32_t)i * 40503u;
+            l_Fifo.push_back(l_IP);
+            Pkt l_Routed = l_Fifo.front();
+            l_Fifo.pop_front();
+            Pkt l_Replica = l_Routed;
+            l_Replica.writable();
+            l_Sink += lookup(l_Fib, (uint32_t)(long long)l_Routed.m_DestinationAddress);
+        }
+
+    chrono::steady_clock::time_point l_End = chrono::steady_clock::now();
+
+    //keeps the path from being optimised away
+    if (l_Sink == 42)
+        puts("");
+    return chrono::duration<double, nano>(l_End - l_Start).count() / p_Iterations;
+}
+
+/*! \brief Runs both layouts
+ * \details Called by main(), or by SystemC as sc_main()
+ */
+int runBenchmark(int argc, char *argv[])
+{
+    int l_Iterations = argc > 1 ? atoi(argv[1]) : 5000000;
+    int l_Runs = argc > 2 ? atoi(argv[2]) : 3;
+
+#ifdef MESSAGEPATH_STANDINS
+    printf("legacy side: SystemC 2.3 stand-ins\n");
+#else
+    printf("legacy side: SystemC datatypes\n");
+#endif
+    for (int i = 0; i < l_Runs; ++i)
+        {
+            double l_Legacy = run<LegacyId, LegacyPayload>(l_Iterations);
+            double l_Native = run<uint32_t, NativePayload>(l_Iterations);
+
+            printf("legacy %.1f ns/msg  native %.1f ns/msg  speedup %.2fx\n", l_Legacy, l_Native, l_Legacy / l_Native);
+        }
+    printf("message %zu / %zu bytes, payload %zu / %zu bytes\n", sizeof(BenchMessage<LegacyId>), sizeof(BenchMessage<uint32_t>), sizeof(LegacyPayload), sizeof(NativePayload));
+    return 0;
+}
+
+#ifdef MESSAGEPATH_STANDINS
+int main(int argc, char *argv[])
+{
+    return runBenchmark(argc, argv);
+}
+#else
+int sc_main(int argc, char *argv[])
+{
+    return runBenchmark(argc, argv);
+}
+#endif
@@ -9,6 +9,9 @@
 
 
 #include "Simulation.hpp"
+#include <cstdlib>
+#include <unistd.h>
+#include <sys/wait.h>
 
 
 
@@ -25,16 +28,53 @@ using namespace sc_dt;
 /*!
  * \brief sc_main
  * \details Initiates the Simulation module, which builds up the Router modules and starts the simulation.
+ * The optional first argument splits the simulation into that many processes.
  */
 int sc_main(int argc, char * argv [])
 {
+  int l_PartitionCount = 1;
+  int l_Partition = 0;
+
+  if(argc > 1)
+    l_PartitionCount = atoi(argv[1]);
+  if(l_PartitionCount < 1 || l_PartitionCount > ROUTER_COUNT)
+    l_PartitionCount = 1;
+
+  ///name the shared memory of the run after the launching process
+  stringstream l_RunName;
+  l_RunName << getpid();
+
+  ///fork a process for each of the other partitions
+  vector<pid_t> l_Children;
+  for(int i = 1; i < l_PartitionCount; i++)
+    {
+      pid_t l_Pid = fork();
+      if(l_Pid == 0)
+	{
+	  l_Partition = i;
+	  l_Children.clear();
+	  break;
+	}
+      if(l_Pid > 0)
+	l_Children.push_back(l_Pid);
+      else
+	cout << "Cannot start partition " << i << endl;
+    }
 
   ///initiate the simulation
-  Simulation test("Test");
+  Simulation test("Test", l_Partition, l_PartitionCount, l_RunName.str());
 
   cout << "Simulation starts for " << SIMULATION_DURATION << " ns" << endl; 
   ///run the simulation	
   sc_start(SIMULATION_DURATION, SC_SEC);
+  ///end the simulation so that the modules can report
+  sc_stop();
+
+  for(size_t i = 0; i < l_Children.size(); i++)
+    waitpid(l_Children[i], NULL, 0);
+
+  ///report the memory of this process's routers
+  MemoryAccounting::report(cout);
 
 return 0;
 }//end of main